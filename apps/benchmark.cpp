@@ -68,6 +68,7 @@
 #include "las_reader.hpp"
 #include "las_writer.hpp"
 #include "utilities/assert.hpp"
+#include "utilities/default_init_allocator.hpp"
 
 using namespace laspp;
 
@@ -273,7 +274,7 @@ static double laspp_read_once(const std::filesystem::path& path, int n_threads)
   {
     // Use file path constructor - automatically uses memory mapping for optimal performance
     LASReader reader(path);
-    std::vector<PointType> points(reader.num_points());
+    utilities::UninitializedVector<PointType> points(reader.num_points());
     reader.read_chunks<PointType>(points, {0, reader.num_chunks()});
   }
   return elapsed_since(t0);
@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "chunk_diagnostics.hpp"
+#include "las_reader.hpp"
+
+using namespace laspp;
+
+int main(int argc, char* argv[]) {
+  const bool per_chunk = argc == 3 && std::string(argv[2]) == "--chunks";
+  if (argc != 2 && !per_chunk) {
+    std::cerr << "Usage: " << argv[0] << " <laz_file> [--chunks]" << std::endl;
+    std::cerr << "  Reports compressed bytes per layer, decode time per item and chunk extents"
+              << std::endl;
+    return 1;
+  }
+
+  LASReader reader{std::filesystem::path(argv[1])};
+  const CompressionDiagnostics diagnostics = diagnose_compression(reader);
+  std::cout << diagnostics;
+
+  if (per_chunk) {
+    std::cout << std::endl << "chunk,first_point,points,bytes,bits_per_point,decode_us";
+    for (const std::string& layer : diagnostics.layer_names) std::cout << "," << layer;
+    std::cout << ",min_x,min_y,max_x,max_y" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const ChunkDiagnostics& chunk : diagnostics.chunks) {
+      std::chrono::nanoseconds decode_time{0};
+      for (std::chrono::nanoseconds time : chunk.item_decode_time) decode_time += time;
+      std::cout << chunk.chunk << "," << chunk.first_point << "," << chunk.n_points << ","
+                << chunk.compressed_bytes << "," << chunk.bits_per_point() << ","
+                << static_cast<double>(decode_time.count()) / 1e3;
+      for (uint64_t bytes : chunk.layer_bytes) std::cout << "," << bytes;
+      std::cout << "," << chunk.extent.min_x() << "," << chunk.extent.min_y() << ","
+                << chunk.extent.max_x() << "," << chunk.extent.max_y() << std::endl;
+    }
+  }
+  return 0;
+}
@@ -3,32 +3,204 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "checkpointed_conversion.hpp"
+#include "gps_time_sort.hpp"
 #include "las_reader.hpp"
 #include "las_writer.hpp"
+#include "point_pipeline.hpp"
 #include "utilities/assert.hpp"
 
+namespace {
+
+// One pipeline step from the command line: the option name and its numbers.
+using PipelineStep = std::pair<std::string, std::vector<double>>;
+
+// The whole of `arg` as a count of at least `min`, or nothing if it is not one.
+std::optional<size_t> parse_count(const std::string& arg, size_t min) {
+  size_t value = 0;
+  const char* end = arg.data() + arg.size();
+  const auto [ptr, error] = std::from_chars(arg.data(), end, value);
+  if (arg.empty() || error != std::errc() || ptr != end || value < min) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// The numbers of `arg` separated by `separator`, or nothing if any is not a finite number.
+std::optional<std::vector<double>> parse_numbers(const std::string& arg, char separator) {
+  std::vector<double> numbers;
+  std::stringstream stream(arg);
+  std::string item;
+  while (std::getline(stream, item, separator)) {
+    double value = 0;
+    const char* end = item.data() + item.size();
+    const auto [ptr, error] = std::from_chars(item.data(), end, value);
+    if (item.empty() || error != std::errc() || ptr != end || !std::isfinite(value)) {
+      return std::nullopt;
+    }
+    numbers.push_back(value);
+  }
+  return numbers;
+}
+
+bool is_integer_in(double value, double min, double max) {
+  return value == std::floor(value) && value >= min && value <= max;
+}
+
+// Whether `values` are valid arguments of the pipeline step `option`.
+bool is_valid_step(const std::string& option, const std::vector<double>& values) {
+  const auto all_classifications = [&]() {
+    return std::all_of(values.begin(), values.end(),
+                       [](double value) { return is_integer_in(value, 0, 255); });
+  };
+  if (option == "--crop") return values.size() == 4;
+  if (option == "--keep-class") return !values.empty() && all_classifications();
+  if (option == "--reclassify") return values.size() == 2 && all_classifications();
+  if (option == "--translate") return values.size() == 3;
+  if (option == "--affine") return values.size() == 12;
+  if (option == "--thin") {
+    return values.size() == 1 &&
+           is_integer_in(values[0], 1, static_cast<double>(std::numeric_limits<uint32_t>::max()));
+  }
+  return false;
+}
+
+void print_usage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [--add-spatial-index|-s | --rechunk <points> | --checkpoint-every <chunks> | "
+               "--sort-gps-time | <pipeline steps>] [--vlr-padding <bytes>] <in_file> "
+               "<out_file>"
+            << std::endl;
+  std::cerr
+      << "  --add-spatial-index, -s: Add spatial index to output file (points will be reordered)"
+      << std::endl;
+  std::cerr << "  --rechunk <points>: Split LAZ chunks larger than <points> for parallel "
+               "reading, copying the others compressed (.laz to .laz only)"
+            << std::endl;
+  std::cerr << "  --checkpoint-every <chunks>: Convert chunk by chunk, saving progress to "
+               "<out_file>.checkpoint; rerunning after a failure resumes from there"
+            << std::endl;
+  std::cerr << "  --sort-gps-time: Write the points in GPS time order, merging time-ordered "
+               "flight lines or sorting externally in the temporary directory"
+            << std::endl;
+  std::cerr << "  --vlr-padding <bytes>: Reserve space after the VLRs so that metadata can "
+               "later be edited in place"
+            << std::endl;
+  std::cerr << "Pipeline steps, applied in the order given in a single pass over the points:"
+            << std::endl;
+  std::cerr << "  --crop <min_x,min_y,max_x,max_y>: Keep points inside the box" << std::endl;
+  std::cerr << "  --keep-class <c1,c2,...>: Keep points with these classifications (0-255)"
+            << std::endl;
+  std::cerr << "  --reclassify <from>:<to>: Change classification <from> to <to>" << std::endl;
+  std::cerr << "  --translate <dx,dy,dz>: Move points (rounded to the scale factors)"
+            << std::endl;
+  std::cerr << "  --affine <a00,a01,a02,t0,a10,a11,a12,t1,a20,a21,a22,t2>: Apply p' = A p + t "
+               "and requantise (offsets are mapped too)"
+            << std::endl;
+  std::cerr << "  --thin <n>: Keep the first of every <n> points (n >= 1)" << std::endl;
+}
+
+template <typename PointType>
+void run_pipeline(laspp::LASReader& reader, laspp::LASWriter& writer,
+                  const std::vector<PipelineStep>& steps) {
+  laspp::PointPipeline<PointType> pipeline(reader);
+  // Arguments were checked by is_valid_step
+  for (const auto& [option, values] : steps) {
+    if (option == "--crop") {
+      pipeline.crop(laspp::Bound2D(values[0], values[1], values[2], values[3]));
+    } else if (option == "--keep-class") {
+      std::vector<uint8_t> classes;
+      for (double value : values) {
+        classes.push_back(static_cast<uint8_t>(value));
+      }
+      pipeline.keep_classes(classes);
+    } else if (option == "--reclassify") {
+      pipeline.reclassify(static_cast<uint8_t>(values[0]), static_cast<uint8_t>(values[1]));
+    } else if (option == "--translate") {
+      pipeline.translate(values[0], values[1], values[2]);
+    } else if (option == "--affine") {
+      std::array<std::array<double, 4>, 3> rows;
+      for (size_t i = 0; i < values.size(); i++) {
+        rows[i / 4][i % 4] = values[i];
+      }
+      pipeline.affine_transform(laspp::AffineTransform(rows));
+    } else if (option == "--thin") {
+      pipeline.thin(static_cast<size_t>(values[0]));
+    }
+  }
+  pipeline.run(writer);
+  for (const laspp::PipelineStageStatistics& stats : pipeline.statistics()) {
+    std::cout << stats << std::endl;
+  }
+}
+
+}  // namespace
+
 int main(int argc, char* argv[]) {
   bool add_spatial_index_flag = false;
+  std::optional<size_t> rechunk_points;
+  std::vector<PipelineStep> pipeline_steps;
+  size_t vlr_padding = 0;
+  std::optional<size_t> checkpoint_chunks;
+  bool sort_gps_time = false;
   int file_arg_start = 1;
+  bool valid = true;
 
   for (int i = 1; i < argc; ++i) {
     if (std::string(argv[i]) == "--add-spatial-index" || std::string(argv[i]) == "-s") {
       add_spatial_index_flag = true;
       file_arg_start++;
+    } else if (std::string(argv[i]) == "--rechunk" && i + 1 < argc) {
+      rechunk_points = parse_count(argv[++i], 1);
+      valid = valid && rechunk_points.has_value();
+      file_arg_start += 2;
+    } else if (std::string(argv[i]) == "--checkpoint-every" && i + 1 < argc) {
+      checkpoint_chunks = parse_count(argv[++i], 1);
+      valid = valid && checkpoint_chunks.has_value();
+      file_arg_start += 2;
+    } else if (std::string(argv[i]) == "--sort-gps-time") {
+      sort_gps_time = true;
+      file_arg_start++;
+    } else if (std::string(argv[i]) == "--vlr-padding" && i + 1 < argc) {
+      const std::optional<size_t> padding = parse_count(argv[++i], 0);
+      valid = valid && padding.has_value();
+      vlr_padding = padding.value_or(0);
+      file_arg_start += 2;
+    } else if ((std::string(argv[i]) == "--crop" || std::string(argv[i]) == "--keep-class" ||
+                std::string(argv[i]) == "--reclassify" || std::string(argv[i]) == "--translate" ||
+                std::string(argv[i]) == "--affine" || std::string(argv[i]) == "--thin") &&
+               i + 1 < argc) {
+      const std::string option = argv[i];
+      const std::optional<std::vector<double>> values =
+          parse_numbers(argv[++i], option == "--reclassify" ? ':' : ',');
+      valid = valid && values.has_value() && is_valid_step(option, *values);
+      pipeline_steps.emplace_back(option, values.value_or(std::vector<double>{}));
+      file_arg_start += 2;
     }
   }
 
-  if (argc - file_arg_start != 2) {
-    std::cerr << "Usage: " << argv[0] << " [--add-spatial-index|-s] <in_file> <out_file>"
-              << std::endl;
-    std::cerr
-        << "  --add-spatial-index, -s: Add spatial index to output file (points will be reordered)"
-        << std::endl;
+  const int n_modes = static_cast<int>(add_spatial_index_flag) +
+                      static_cast<int>(rechunk_points.has_value()) +
+                      static_cast<int>(!pipeline_steps.empty()) +
+                      static_cast<int>(checkpoint_chunks.has_value()) +
+                      static_cast<int>(sort_gps_time);
+  if (!valid || argc - file_arg_start != 2 || n_modes > 1) {
+    print_usage(argv[0]);
     return 1;
   }
 
@@ -40,6 +212,22 @@ int main(int argc, char* argv[]) {
   std::cout << reader.header() << std::endl;
 
   std::filesystem::path out_file(out_file_str);
+  if (checkpoint_chunks.has_value()) {
+    laspp::CheckpointedConversionOptions options;
+    options.laz_output = out_file.extension() == ".laz";
+    options.chunks_per_checkpoint = checkpoint_chunks.value();
+    options.vlr_padding = vlr_padding;
+    std::filesystem::path checkpoint_file = out_file;
+    checkpoint_file += ".checkpoint";
+    const size_t skipped =
+        laspp::convert_with_checkpoints(in_file, out_file, checkpoint_file, options);
+    if (skipped > 0) {
+      std::cout << "Resumed after " << skipped << " chunks from " << checkpoint_file.string()
+                << std::endl;
+    }
+    return 0;
+  }
+
   std::fstream ofs;
   ofs.open(out_file, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
   LASPP_ASSERT(ofs.is_open(), "Failed to open ", out_file);
@@ -62,9 +250,31 @@ int main(int argc, char* argv[]) {
       point_format &= static_cast<uint8_t>(~(1u << 7));
     }
     laspp::LASWriter writer(ofs, point_format);
+    writer.reserve_vlr_padding(vlr_padding);
+
+    if (!pipeline_steps.empty()) {
+      LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(), run_pipeline, reader, writer,
+                                   pipeline_steps);
+      std::cout << writer.header() << std::endl;
+      return 0;
+    }
+
+    if (sort_gps_time) {
+      const laspp::GPSTimeSortStatistics statistics =
+          laspp::rewrite_in_gps_time_order(reader, writer);
+      std::cout << statistics.n_input_runs << " time-ordered runs, "
+                << (statistics.external_sort ? "sorted externally in " : "merged from ")
+                << statistics.n_merged_runs << " runs" << std::endl;
+      std::cout << writer.header() << std::endl;
+      return 0;
+    }
 
     // Copy everything from reader to writer
-    writer.copy_from_reader(reader, add_spatial_index_flag);
+    if (rechunk_points.has_value()) {
+      writer.rechunk_from_reader(reader, rechunk_points.value());
+    } else {
+      writer.copy_from_reader(reader, add_spatial_index_flag);
+    }
 
     LASPP_ASSERT_EQ(reader.num_points(), writer.header().num_points(),
                     "Number of points in output file does not match input file");
@@ -0,0 +1,154 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "partitioning.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+
+namespace {
+
+void print_usage(const char* program) {
+  std::cerr << "Usage:" << std::endl;
+  std::cerr << "  " << program << " plan <input> <n>" << std::endl;
+  std::cerr << "      Print the partitions of <input> for <n> workers" << std::endl;
+  std::cerr << "  " << program << " convert <input> <n> <index> <part.laz>" << std::endl;
+  std::cerr << "      Convert partition <index> of <n> into a partial LAZ file" << std::endl;
+  std::cerr << "  " << program << " merge <output.laz> <part.laz>..." << std::endl;
+  std::cerr << "      Concatenate partial LAZ files, in order, without re-encoding" << std::endl;
+  std::cerr << "  " << program << " run <input> <output.laz> <n>" << std::endl;
+  std::cerr << "      Plan, convert each partition in its own local process, and merge"
+            << std::endl;
+}
+
+// The whole of `arg` as a count of at least `min`, or nothing if it is not one.
+std::optional<size_t> parse_count(const std::string& arg, size_t min) {
+  size_t value = 0;
+  const char* end = arg.data() + arg.size();
+  const auto [ptr, error] = std::from_chars(arg.data(), end, value);
+  if (arg.empty() || error != std::errc() || ptr != end || value < min) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::vector<PartitionRange> plan(const std::filesystem::path& input, size_t n_partitions) {
+  LASReader reader(input);
+  return plan_partitions(reader, n_partitions);
+}
+
+void convert(const std::filesystem::path& input, size_t n_partitions, size_t index,
+             const std::filesystem::path& output) {
+  LASReader reader(input);
+  const std::vector<PartitionRange> partitions = plan_partitions(reader, n_partitions);
+  LASPP_ASSERT_LT(index, partitions.size(), "Only ", partitions.size(), " partitions");
+  std::fstream ofs(output, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+  LASPP_ASSERT(ofs.is_open(), "Failed to open ", output.string());
+  LASWriter writer(ofs, static_cast<uint8_t>(reader.header().point_format() | 128));
+  convert_partition(reader, partitions[index], writer);
+}
+
+void merge(const std::filesystem::path& output, const std::vector<std::filesystem::path>& inputs) {
+  std::vector<std::unique_ptr<LASReader>> readers;
+  std::vector<LASReader*> parts;
+  for (const std::filesystem::path& input : inputs) {
+    readers.push_back(std::make_unique<LASReader>(input));
+    parts.push_back(readers.back().get());
+  }
+  std::fstream ofs(output, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+  LASPP_ASSERT(ofs.is_open(), "Failed to open ", output.string());
+  LASWriter writer(ofs, parts.front()->header().point_format());
+  writer.merge_from_readers(parts);
+}
+
+std::string quoted(const std::string& arg) {
+  std::string result = "'";
+  for (char c : arg) {
+    result += c == '\'' ? std::string("'\\''") : std::string(1, c);
+  }
+  return result + "'";
+}
+
+// Runs each partition's conversion as a separate process of this program, standing in for a
+// worker node, and merges the partial outputs.
+int run(const std::string& program, const std::filesystem::path& input,
+        const std::filesystem::path& output, size_t n_partitions) {
+  const size_t n = plan(input, n_partitions).size();
+  std::vector<std::filesystem::path> parts;
+  for (size_t k = 0; k < n; k++) {
+    parts.push_back(output.string() + ".part" + std::to_string(k) + ".laz");
+  }
+  std::vector<int> statuses(n, 0);
+  std::vector<std::thread> workers;
+  for (size_t k = 0; k < n; k++) {
+    workers.emplace_back([&, k]() {
+      const std::string command = quoted(program) + " convert " + quoted(input.string()) + " " +
+                                  std::to_string(n_partitions) + " " + std::to_string(k) + " " +
+                                  quoted(parts[k].string());
+      statuses[k] = std::system(command.c_str());
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  for (size_t k = 0; k < n; k++) {
+    if (statuses[k] != 0) {
+      std::cerr << "Worker " << k << " failed with status " << statuses[k] << std::endl;
+      return 1;
+    }
+  }
+  merge(output, parts);
+  for (const std::filesystem::path& part : parts) {
+    std::filesystem::remove(part);
+  }
+  std::cout << "Merged " << n << " partitions into " << output.string() << std::endl;
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string mode = argc > 1 ? argv[1] : "";
+  if (mode == "plan" && argc == 4) {
+    if (const std::optional<size_t> n = parse_count(argv[3], 1)) {
+      for (const PartitionRange& partition : plan(argv[2], *n)) {
+        std::cout << partition << std::endl;
+      }
+      return 0;
+    }
+  }
+  if (mode == "convert" && argc == 6) {
+    const std::optional<size_t> n = parse_count(argv[3], 1);
+    const std::optional<size_t> index = parse_count(argv[4], 0);
+    if (n.has_value() && index.has_value()) {
+      convert(argv[2], *n, *index, argv[5]);
+      return 0;
+    }
+  }
+  if (mode == "merge" && argc >= 4) {
+    merge(argv[2], std::vector<std::filesystem::path>(argv + 3, argv + argc));
+    return 0;
+  }
+  if (mode == "run" && argc == 5) {
+    if (const std::optional<size_t> n = parse_count(argv[4], 1)) {
+      return run(argv[0], argv[2], argv[3], *n);
+    }
+  }
+  print_usage(argv[0]);
+  return 1;
+}
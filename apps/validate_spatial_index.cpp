@@ -13,6 +13,7 @@
 #include "las_reader.hpp"
 #include "spatial_index.hpp"
 #include "utilities/assert.hpp"
+#include "utilities/default_init_allocator.hpp"
 
 using namespace laspp;
 
@@ -35,7 +36,7 @@ void validate_spatial_index_for_points(LASReader& reader, const QuadtreeSpatialI
   double offset_y = reader.header().transform().offsets().y();
 
   // Read all points
-  std::vector<PointType> points(reader.num_points());
+  utilities::UninitializedVector<PointType> points(reader.num_points());
   reader.read_chunks<PointType>(points, {0, reader.num_chunks()});
 
   // Statistics
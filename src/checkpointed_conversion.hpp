@@ -0,0 +1,259 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/default_init_allocator.hpp"
+#include "utilities/file_sync.hpp"
+
+namespace laspp {
+
+struct CheckpointedConversionOptions {
+  bool laz_output = true;
+  // Input chunks converted between checkpoints
+  size_t chunks_per_checkpoint = 16;
+  // LAS input has no chunks; it is converted in chunks of this many points
+  size_t uncompressed_chunk_points = 50000;
+  // See LASWriter::reserve_vlr_padding()
+  size_t vlr_padding = 0;
+  // Called after each checkpoint is saved, with the number of input chunks converted so far
+  std::function<void(size_t)> on_checkpoint;
+};
+
+// Progress of a conversion by convert_with_checkpoints(), as saved in its checkpoint file.
+struct ConversionCheckpoint {
+  static constexpr std::array<char, 8> MAGIC = {'L', 'A', 'S', 'P', 'P', 'C', 'K', '1'};
+
+  uint64_t input_num_points = 0;  // identify the input the checkpoint belongs to
+  uint64_t input_num_chunks = 0;
+  uint64_t input_chunks_done = 0;
+  LASWriterCheckpoint writer;
+
+  void write(std::ostream& os) const {
+    auto put = [&](const auto& value) {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto put_vector = [&](const std::vector<uint32_t>& values) {
+      put(uint64_t{values.size()});
+      os.write(reinterpret_cast<const char*>(values.data()),
+               static_cast<std::streamsize>(values.size() * sizeof(uint32_t)));
+    };
+    os.write(MAGIC.data(), MAGIC.size());
+    put(input_num_points);
+    put(input_num_chunks);
+    put(input_chunks_done);
+    std::ostringstream header_stream;
+    writer.header.write(header_stream);
+    const std::string header_bytes = header_stream.str();
+    put(uint64_t{header_bytes.size()});
+    os.write(header_bytes.data(), static_cast<std::streamsize>(header_bytes.size()));
+    put(writer.laz_vlr_offset);
+    put(writer.end_offset);
+    put_vector(writer.points_per_chunk);
+    put_vector(writer.compressed_chunk_sizes);
+  }
+
+  static ConversionCheckpoint read(std::istream& is) {
+    std::array<char, 8> magic;
+    LASPP_CHECK_READ(is, &magic, sizeof(magic));
+    LASPP_ASSERT(magic == MAGIC, "Not a LAS++ conversion checkpoint");
+    auto get = [&](auto& value) { LASPP_CHECK_READ(is, &value, sizeof(value)); };
+    auto get_vector = [&](std::vector<uint32_t>& values) {
+      uint64_t size;
+      get(size);
+      values.resize(size);
+      LASPP_CHECK_READ(is, values.data(), size * sizeof(uint32_t));
+    };
+    ConversionCheckpoint checkpoint;
+    get(checkpoint.input_num_points);
+    get(checkpoint.input_num_chunks);
+    get(checkpoint.input_chunks_done);
+    uint64_t header_size;
+    get(header_size);
+    std::string header_bytes(header_size, '\0');
+    is.read(header_bytes.data(), static_cast<std::streamsize>(header_size));
+    LASPP_ASSERT(is.good(), "Truncated checkpoint");
+    std::istringstream header_stream(header_bytes);
+    checkpoint.writer.header = LASHeader(header_stream);
+    get(checkpoint.writer.laz_vlr_offset);
+    get(checkpoint.writer.end_offset);
+    get_vector(checkpoint.writer.points_per_chunk);
+    get_vector(checkpoint.writer.compressed_chunk_sizes);
+    return checkpoint;
+  }
+
+  // Replaces the file at `path` as a whole, so a crash while saving leaves the previous
+  // checkpoint in place: the new one is written to a temporary file and synced to disk before
+  // it is renamed over the old one, and the rename is synced through the directory.
+  void save(const std::filesystem::path& path) const {
+    std::filesystem::path temporary_path = path;
+    temporary_path += ".tmp";
+    {
+      std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+      write(file);
+      file.flush();
+      LASPP_ASSERT(file.good(), "Failed to write checkpoint ", temporary_path.string());
+    }
+    utilities::sync_file(temporary_path);
+    std::filesystem::rename(temporary_path, path);
+    utilities::sync_directory(path.parent_path());
+  }
+
+  static ConversionCheckpoint load(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    LASPP_ASSERT(file.is_open(), "Failed to open checkpoint ", path.string());
+    return read(file);
+  }
+};
+
+namespace detail {
+
+// First point and number of points of each input chunk.
+inline std::vector<std::pair<uint64_t, size_t>> conversion_chunks(
+    const LASReader& reader, const CheckpointedConversionOptions& options) {
+  std::vector<std::pair<uint64_t, size_t>> chunks;
+  if (reader.header().is_laz_compressed()) {
+    uint64_t first_point = 0;
+    for (size_t n_points : reader.points_per_chunk()) {
+      chunks.emplace_back(first_point, n_points);
+      first_point += n_points;
+    }
+  } else {
+    LASPP_ASSERT_GT(options.uncompressed_chunk_points, 0u);
+    for (uint64_t first = 0; first < reader.num_points();
+         first += options.uncompressed_chunk_points) {
+      const uint64_t n_points =
+          std::min<uint64_t>(options.uncompressed_chunk_points, reader.num_points() - first);
+      chunks.emplace_back(first, static_cast<size_t>(n_points));
+    }
+  }
+  return chunks;
+}
+
+template <typename PointType>
+void convert_chunks_with_checkpoints(LASReader& reader, LASWriter& writer,
+                                     ConversionCheckpoint& checkpoint,
+                                     const std::filesystem::path& output,
+                                     const std::filesystem::path& checkpoint_path,
+                                     const CheckpointedConversionOptions& options) {
+  const std::vector<std::pair<uint64_t, size_t>> chunks = conversion_chunks(reader, options);
+  LASPP_ASSERT_GT(options.chunks_per_checkpoint, 0u);
+  while (checkpoint.input_chunks_done < chunks.size()) {
+    const size_t first_chunk = checkpoint.input_chunks_done;
+    const size_t end_chunk = std::min(chunks.size(), first_chunk + options.chunks_per_checkpoint);
+    const uint64_t first_point = chunks[first_chunk].first;
+    const uint64_t end_point = chunks[end_chunk - 1].first + chunks[end_chunk - 1].second;
+    utilities::UninitializedVector<PointType> points(end_point - first_point);
+    if (reader.header().is_laz_compressed()) {
+      reader.read_chunks(std::span<PointType>(points), {first_chunk, end_chunk});
+    } else {
+      std::vector<size_t> indices(points.size());
+      std::iota(indices.begin(), indices.end(), first_point);
+      reader.read_points_by_index(std::span<PointType>(points), std::span<const size_t>(indices));
+    }
+
+    // Each input chunk becomes one output chunk; runs of equal-sized chunks are compressed
+    // together in parallel.
+    for (size_t c = first_chunk; c < end_chunk;) {
+      size_t run_end = c + 1;
+      while (run_end < end_chunk && chunks[run_end].second == chunks[c].second) run_end++;
+      const uint64_t run_end_point = chunks[run_end - 1].first + chunks[run_end - 1].second;
+      writer.write_points(std::span<const PointType>(points).subspan(
+                              chunks[c].first - first_point, run_end_point - chunks[c].first),
+                          chunks[c].second);
+      c = run_end;
+    }
+
+    checkpoint.input_chunks_done = end_chunk;
+    // The points must reach the disk before a checkpoint that refers to them
+    checkpoint.writer = writer.checkpoint();
+    utilities::sync_file(output);
+    checkpoint.save(checkpoint_path);
+    if (options.on_checkpoint) {
+      options.on_checkpoint(end_chunk);
+    }
+  }
+}
+
+}  // namespace detail
+
+// Converts `input` into `output`, one input chunk per output chunk, saving progress to
+// `checkpoint_path` every options.chunks_per_checkpoint chunks: the chunks converted, the end of
+// the output written so far, and the writer's header and chunk table up to there. If the
+// checkpoint file exists, for example because an earlier run died, the output is truncated at
+// the checkpoint and the conversion continues with the next input chunk; the result is the same
+// file an uninterrupted run would have written. The checkpoint is removed once the output is
+// complete. Returns the number of input chunks skipped by resuming.
+//
+// Each checkpoint survives a crash of the machine, not only of the process: the output is synced
+// to disk before the checkpoint is saved (see ConversionCheckpoint::save).
+inline size_t convert_with_checkpoints(const std::filesystem::path& input,
+                                       const std::filesystem::path& output,
+                                       const std::filesystem::path& checkpoint_path,
+                                       const CheckpointedConversionOptions& options = {}) {
+  LASReader reader(input);
+  const size_t n_chunks = detail::conversion_chunks(reader, options).size();
+
+  ConversionCheckpoint checkpoint;
+  checkpoint.input_num_points = reader.num_points();
+  checkpoint.input_num_chunks = n_chunks;
+  std::optional<ConversionCheckpoint> resumed;
+  if (std::filesystem::exists(checkpoint_path)) {
+    resumed = ConversionCheckpoint::load(checkpoint_path);
+    LASPP_ASSERT(resumed->input_num_points == checkpoint.input_num_points &&
+                     resumed->input_num_chunks == checkpoint.input_num_chunks,
+                 "Checkpoint ", checkpoint_path.string(), " belongs to a different input");
+    LASPP_ASSERT_GE(std::filesystem::file_size(output), resumed->writer.end_offset,
+                    "Output is shorter than its checkpoint");
+    std::filesystem::resize_file(output, resumed->writer.end_offset);
+    checkpoint = *resumed;
+  }
+
+  {
+    std::fstream ofs(output, std::ios::binary | std::ios::in | std::ios::out |
+                                 (resumed.has_value() ? std::ios::openmode{} : std::ios::trunc));
+    LASPP_ASSERT(ofs.is_open(), "Failed to open ", output.string());
+    std::optional<LASWriter> writer;
+    if (resumed.has_value()) {
+      writer.emplace(ofs, resumed->writer);
+    } else {
+      uint8_t point_format = reader.header().point_format();
+      point_format = options.laz_output ? static_cast<uint8_t>(point_format | 128)
+                                        : static_cast<uint8_t>(point_format & ~128);
+      writer.emplace(ofs, point_format);
+      writer->reserve_vlr_padding(options.vlr_padding);
+      writer->copy_metadata_from(reader, true);
+    }
+
+    LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(),
+                                 detail::convert_chunks_with_checkpoints, reader, *writer,
+                                 checkpoint, output, checkpoint_path, options);
+    writer->copy_evlrs_from(reader, true);
+  }
+  std::filesystem::remove(checkpoint_path);
+  return resumed.has_value() ? resumed->input_chunks_done : 0;
+}
+
+}  // namespace laspp
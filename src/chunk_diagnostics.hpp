@@ -0,0 +1,261 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_reader.hpp"
+#include "laz/laz_reader.hpp"
+#include "laz/laz_vlr.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/default_init_allocator.hpp"
+#include "utilities/thread_pool.hpp"
+
+namespace laspp {
+
+// Where the compressed bytes and the decode time of one LAZ chunk go.
+struct ChunkDiagnostics {
+  size_t chunk = 0;
+  uint64_t first_point = 0;
+  size_t n_points = 0;
+  size_t compressed_bytes = 0;
+  // Raw first point of every item, plus the point count and layer size table of layered chunks
+  size_t overhead_bytes = 0;
+  std::vector<uint64_t> layer_bytes;                       // see CompressionDiagnostics
+  std::vector<std::chrono::nanoseconds> item_decode_time;  // one per LAZ item record
+  Bound3D extent;
+
+  double bits_per_point() const {
+    if (n_points == 0) return 0.0;
+    return 8.0 * static_cast<double>(compressed_bytes) / static_cast<double>(n_points);
+  }
+};
+
+// Per-chunk and per-layer compression statistics of a LAZ file, for choosing chunk sizes and
+// point orders. Layered (point format 6 and up) chunks store each dimension group in its own
+// layer, so their bytes split by dimension: the nine Point14 layers, one per RGB14 and NIR
+// channel and one per extra byte. Pointwise chunks interleave all items in one arithmetic
+// stream, reported as the single layer "pointwise". Layers of an item are decoded together, so
+// decode time is per item record.
+struct CompressionDiagnostics {
+  LAZCompressor compressor = LAZCompressor::None;
+  std::vector<std::string> item_names;
+  std::vector<std::string> layer_names;
+  std::vector<ChunkDiagnostics> chunks;
+  Bound3D file_extent;
+
+  uint64_t num_points() const {
+    uint64_t n = 0;
+    for (const ChunkDiagnostics& chunk : chunks) n += chunk.n_points;
+    return n;
+  }
+
+  uint64_t compressed_bytes() const {
+    uint64_t bytes = 0;
+    for (const ChunkDiagnostics& chunk : chunks) bytes += chunk.compressed_bytes;
+    return bytes;
+  }
+
+  uint64_t overhead_bytes() const {
+    uint64_t bytes = 0;
+    for (const ChunkDiagnostics& chunk : chunks) bytes += chunk.overhead_bytes;
+    return bytes;
+  }
+
+  std::vector<uint64_t> layer_bytes() const {
+    std::vector<uint64_t> bytes(layer_names.size(), 0);
+    for (const ChunkDiagnostics& chunk : chunks) {
+      for (size_t l = 0; l < bytes.size(); l++) bytes[l] += chunk.layer_bytes[l];
+    }
+    return bytes;
+  }
+
+  std::vector<std::chrono::nanoseconds> item_decode_time() const {
+    std::vector<std::chrono::nanoseconds> times(item_names.size(), std::chrono::nanoseconds{0});
+    for (const ChunkDiagnostics& chunk : chunks) {
+      for (size_t i = 0; i < times.size(); i++) times[i] += chunk.item_decode_time[i];
+    }
+    return times;
+  }
+
+  // Mean over chunks of the XY area of the chunk's extent as a fraction of the file's. Near
+  // 1 / num_chunks for spatially sorted files, whose queries decode few chunks; near 1 when
+  // every chunk spans the whole file.
+  double mean_chunk_area_fraction() const {
+    const double file_area = (file_extent.max_x() - file_extent.min_x()) *
+                             (file_extent.max_y() - file_extent.min_y());
+    if (chunks.empty() || !(file_area > 0)) return 1.0;
+    double sum = 0;
+    for (const ChunkDiagnostics& chunk : chunks) {
+      if (chunk.n_points == 0) continue;
+      sum += (chunk.extent.max_x() - chunk.extent.min_x()) *
+             (chunk.extent.max_y() - chunk.extent.min_y()) / file_area;
+    }
+    return sum / static_cast<double>(chunks.size());
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const CompressionDiagnostics& diagnostics) {
+    const double n_points = static_cast<double>(std::max<uint64_t>(diagnostics.num_points(), 1));
+    const double total_bytes =
+        static_cast<double>(std::max<uint64_t>(diagnostics.compressed_bytes(), 1));
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "Compressor: " << diagnostics.compressor << std::endl;
+    out << "Points: " << diagnostics.num_points() << " in " << diagnostics.chunks.size()
+        << " chunks" << std::endl;
+    out << "Compressed bytes: " << diagnostics.compressed_bytes() << " ("
+        << 8.0 * static_cast<double>(diagnostics.compressed_bytes()) / n_points
+        << " bits/point)" << std::endl;
+    out << std::left << std::setw(24) << "Layer" << std::right << std::setw(14) << "bytes"
+        << std::setw(9) << "%" << std::setw(12) << "bits/point" << std::endl;
+    auto layer_line = [&](const std::string& name, uint64_t bytes) {
+      out << std::left << std::setw(24) << name << std::right << std::setw(14) << bytes
+          << std::setw(9) << 100.0 * static_cast<double>(bytes) / total_bytes << std::setw(12)
+          << 8.0 * static_cast<double>(bytes) / n_points << std::endl;
+    };
+    const std::vector<uint64_t> layer_bytes = diagnostics.layer_bytes();
+    for (size_t l = 0; l < layer_bytes.size(); l++) {
+      layer_line(diagnostics.layer_names[l], layer_bytes[l]);
+    }
+    layer_line("(seeds and tables)", diagnostics.overhead_bytes());
+    out << std::left << std::setw(24) << "Item" << std::right << std::setw(14) << "decode ms"
+        << std::setw(9) << "%" << std::setw(12) << "ns/point" << std::endl;
+    const std::vector<std::chrono::nanoseconds> times = diagnostics.item_decode_time();
+    double total_time = 0;
+    for (std::chrono::nanoseconds time : times) total_time += static_cast<double>(time.count());
+    for (size_t i = 0; i < times.size(); i++) {
+      const double ns = static_cast<double>(times[i].count());
+      out << std::left << std::setw(24) << diagnostics.item_names[i] << std::right
+          << std::setw(14) << ns / 1e6 << std::setw(9)
+          << (total_time > 0 ? 100.0 * ns / total_time : 0.0) << std::setw(12) << ns / n_points
+          << std::endl;
+    }
+    out << "Mean chunk area fraction: " << std::setprecision(4)
+        << diagnostics.mean_chunk_area_fraction() << std::endl;
+    return os << out.str();
+  }
+};
+
+namespace detail {
+
+// Names of the layers of one item record in a layered chunk.
+inline std::vector<std::string> laz_layer_names(const LAZItemRecord& record) {
+  switch (record.item_type) {
+    case LAZItemType::Point14:
+      return {"channel_returns_xy", "z",         "classification", "flags",   "intensity",
+              "scan_angle",         "user_data", "point_source",   "gps_time"};
+    case LAZItemType::RGB14:
+      return {"rgb"};
+    case LAZItemType::RGBNIR14:
+      return {"rgb", "nir"};
+    case LAZItemType::Byte14: {
+      std::vector<std::string> names;
+      for (size_t j = 0; j < record.item_size; j++) {
+        names.push_back("extra_byte_" + std::to_string(j));
+      }
+      return names;
+    }
+    default:
+      LASPP_FAIL("Item ", record.item_type, " cannot be layered");
+  }
+}
+
+template <typename PointType>
+void diagnose_chunk(const LAZSpecialVLRContent& special_vlr, const LASHeader& header,
+                    std::span<const std::byte> compressed_data, ChunkDiagnostics& diagnostics) {
+  LAZChunkDecoder decoder(special_vlr, compressed_data, diagnostics.n_points);
+  decoder.time_items(&diagnostics.item_decode_time);
+  utilities::UninitializedVector<PointType> points(diagnostics.n_points);
+  decoder.decode(std::span<PointType>(points));
+
+  size_t seed_bytes = 0;
+  for (const LAZItemRecord& record : special_vlr.items_records) seed_bytes += record.item_size;
+  if (special_vlr.compressor == LAZCompressor::LayeredChunked) {
+    const std::vector<uint32_t>& layer_sizes = decoder.layer_sizes();
+    diagnostics.layer_bytes.assign(layer_sizes.begin(), layer_sizes.end());
+    diagnostics.overhead_bytes = seed_bytes + sizeof(uint32_t) * (1 + layer_sizes.size());
+  } else {
+    diagnostics.overhead_bytes = seed_bytes;
+    diagnostics.layer_bytes = {diagnostics.compressed_bytes - seed_bytes};
+  }
+
+  ChunkSummary summary;
+  for (const PointType& point : points) summary.add(point);
+  if (summary.n_points > 0) {
+    const Transform& transform = header.transform();
+    const Vector3D min = transform.transform_point(summary.min_pos[0], summary.min_pos[1],
+                                                   summary.min_pos[2]);
+    const Vector3D max = transform.transform_point(summary.max_pos[0], summary.max_pos[1],
+                                                   summary.max_pos[2]);
+    diagnostics.extent.update({min.x(), min.y(), min.z()});
+    diagnostics.extent.update({max.x(), max.y(), max.z()});
+  }
+}
+
+}  // namespace detail
+
+// Decodes every chunk of the LAZ file behind `reader` in parallel, recording its compressed
+// bytes per layer, decode time per item and spatial extent. Item timing adds some overhead to
+// the decode, so times are best compared with each other rather than with plain reads.
+inline CompressionDiagnostics diagnose_compression(LASReader& reader) {
+  LASPP_ASSERT(reader.header().is_laz_compressed(), "Compression diagnostics require a LAZ file");
+  const LAZSpecialVLRContent special_vlr = reader.laz_special_vlr().value();
+
+  CompressionDiagnostics diagnostics;
+  diagnostics.compressor = special_vlr.compressor;
+  diagnostics.file_extent = reader.header().bounds();
+  for (const LAZItemRecord& record : special_vlr.items_records) {
+    std::ostringstream name;
+    name << record.item_type;
+    diagnostics.item_names.push_back(name.str());
+    if (special_vlr.compressor == LAZCompressor::LayeredChunked) {
+      for (std::string& layer : detail::laz_layer_names(record)) {
+        diagnostics.layer_names.push_back(std::move(layer));
+      }
+    }
+  }
+  if (special_vlr.compressor != LAZCompressor::LayeredChunked) {
+    diagnostics.layer_names = {"pointwise"};
+  }
+
+  const std::vector<size_t> points_per_chunk = reader.points_per_chunk();
+  const std::vector<size_t> sizes = reader.compressed_chunk_sizes();
+  diagnostics.chunks.resize(points_per_chunk.size());
+  uint64_t first_point = 0;
+  for (size_t c = 0; c < diagnostics.chunks.size(); c++) {
+    diagnostics.chunks[c].chunk = c;
+    diagnostics.chunks[c].first_point = first_point;
+    diagnostics.chunks[c].n_points = points_per_chunk[c];
+    diagnostics.chunks[c].compressed_bytes = sizes[c];
+    first_point += points_per_chunk[c];
+  }
+
+  std::mutex read_mutex;
+  utilities::parallel_for(size_t{0}, diagnostics.chunks.size(), [&](size_t c) {
+    std::vector<std::byte> compressed_data;
+    {
+      std::lock_guard<std::mutex> lock(read_mutex);
+      compressed_data = reader.read_compressed_chunk(c);
+    }
+    LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(), detail::diagnose_chunk,
+                                 special_vlr, reader.header(),
+                                 std::span<const std::byte>(compressed_data),
+                                 diagnostics.chunks[c]);
+  });
+  return diagnostics;
+}
+
+}  // namespace laspp
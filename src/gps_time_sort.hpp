@@ -0,0 +1,390 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <queue>
+#include <random>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/cancellation.hpp"
+#include "utilities/default_init_allocator.hpp"
+#include "utilities/memory_budget.hpp"
+
+namespace laspp {
+
+// A maximal range of consecutive points of one point source (flight line) whose GPS times do
+// not decrease.
+struct GPSTimeRun {
+  uint64_t first_point;
+  uint64_t end_point;
+  uint16_t point_source_id;
+  double first_time;
+  double last_time;
+
+  uint64_t num_points() const { return end_point - first_point; }
+
+  friend std::ostream& operator<<(std::ostream& os, const GPSTimeRun& run) {
+    return os << "points [" << run.first_point << ", " << run.end_point << ") source "
+              << run.point_source_id << " time [" << run.first_time << ", " << run.last_time
+              << "]";
+  }
+};
+
+struct GPSTimeSortOptions {
+  // Points per output chunk
+  size_t output_chunk_points = 50000;
+  // Files with more runs than this are sorted externally instead of merged from the input
+  size_t max_merge_runs = 64;
+  // Points sorted in memory at a time by the external sort, rounded to whole LAZ chunks
+  size_t sort_run_points = size_t{4} << 20;
+  // Sorted runs the external sort merges at once; more are merged in several passes
+  size_t merge_fan_in = 64;
+  // Where the external sort keeps its sorted runs
+  std::filesystem::path temporary_directory = std::filesystem::temp_directory_path();
+};
+
+struct GPSTimeSortStatistics {
+  size_t n_input_runs = 0;
+  bool external_sort = false;
+  size_t n_merged_runs = 0;  // input runs, or the runs written by the external sort
+  size_t n_merge_passes = 0;  // the last of which writes the output
+};
+
+namespace detail {
+
+template <typename PointType>
+constexpr bool has_gps_time_v =
+    std::is_base_of_v<GPSTime, PointType> || std::is_base_of_v<LASPointFormat6, PointType>;
+
+template <typename PointType>
+double gps_time_of(const PointType& point) {
+  if constexpr (std::is_base_of_v<LASPointFormat6, PointType>) {
+    return point.gps_time;
+  } else {
+    return static_cast<const GPSTime&>(point).gps_time.f64;
+  }
+}
+
+// Reads points [first_point, first_point + points.size()) of `reader`.
+template <typename PointType>
+void read_point_range(LASReader& reader, std::span<PointType> points, uint64_t first_point) {
+  std::vector<size_t> indices(points.size());
+  std::iota(indices.begin(), indices.end(), first_point);
+  reader.read_points_by_index(points, std::span<const size_t>(indices));
+}
+
+// Calls f(points, first_point) for consecutive blocks of about `block_points` points, made of
+// whole chunks for LAZ files so that every chunk is decoded once.
+template <typename PointType, typename Function>
+void for_each_point_block(LASReader& reader, size_t block_points, Function&& f) {
+  utilities::UninitializedVector<PointType> points;
+  if (!reader.header().is_laz_compressed()) {
+    for (uint64_t first = 0; first < reader.num_points(); first += block_points) {
+      utilities::check_cancellation();
+      points.resize(std::min<uint64_t>(block_points, reader.num_points() - first));
+      read_point_range(reader, std::span<PointType>(points), first);
+      f(std::span<PointType>(points), first);
+    }
+    return;
+  }
+  const std::vector<size_t> points_per_chunk = reader.points_per_chunk();
+  uint64_t first = 0;
+  for (size_t c = 0; c < points_per_chunk.size();) {
+    utilities::check_cancellation();
+    size_t end = c;
+    size_t n_points = 0;
+    while (end < points_per_chunk.size() &&
+           (end == c || n_points + points_per_chunk[end] <= block_points)) {
+      n_points += points_per_chunk[end++];
+    }
+    points.resize(n_points);
+    reader.read_chunks(std::span<PointType>(points), {c, end});
+    f(std::span<PointType>(points), first);
+    first += n_points;
+    c = end;
+  }
+}
+
+// Points of one sorted run, drawn a buffer at a time from `refill`, which fills the front of
+// its span and returns how many points it wrote (0 at the end of the run).
+template <typename PointType>
+class SortedRunCursor {
+  std::function<size_t(std::span<PointType>)> m_refill;
+  utilities::UninitializedVector<PointType> m_buffer;
+  size_t m_position = 0;
+  size_t m_size = 0;
+
+ public:
+  SortedRunCursor(size_t buffer_points, std::function<size_t(std::span<PointType>)> refill)
+      : m_refill(std::move(refill)), m_buffer(buffer_points) {}
+
+  // False once the run is exhausted
+  bool load() {
+    if (m_position == m_size) {
+      m_position = 0;
+      m_size = m_refill(std::span<PointType>(m_buffer));
+    }
+    return m_size > 0;
+  }
+  const PointType& front() const { return m_buffer[m_position]; }
+  void pop() { m_position++; }
+};
+
+// Merges the runs by GPS time, taking equal times in run order, and passes the merged points
+// to `write` in blocks of `output_points`.
+template <typename PointType, typename Write>
+void merge_sorted_runs(std::vector<SortedRunCursor<PointType>>& runs, size_t output_points,
+                       Write&& write) {
+  using Entry = std::pair<double, size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> heap;
+  for (size_t r = 0; r < runs.size(); r++) {
+    if (runs[r].load()) heap.emplace(gps_time_of(runs[r].front()), r);
+  }
+  utilities::UninitializedVector<PointType> output;
+  output.reserve(output_points);
+  while (!heap.empty()) {
+    const size_t r = heap.top().second;
+    heap.pop();
+    output.push_back(runs[r].front());
+    runs[r].pop();
+    if (runs[r].load()) heap.emplace(gps_time_of(runs[r].front()), r);
+    if (output.size() == output_points) {
+      utilities::check_cancellation();
+      write(std::span<const PointType>(output));
+      output.clear();
+    }
+  }
+  if (!output.empty()) {
+    write(std::span<const PointType>(output));
+  }
+}
+
+// A file of raw point records, removed when it goes out of scope.
+class SpillFile {
+  std::filesystem::path m_path;
+
+ public:
+  explicit SpillFile(const std::filesystem::path& directory) {
+    std::random_device random;
+    m_path = directory / ("laspp-gps-sort-" + std::to_string(random()) + "-" +
+                          std::to_string(random()) + ".tmp");
+  }
+  SpillFile(const SpillFile&) = delete;
+  SpillFile& operator=(const SpillFile&) = delete;
+  ~SpillFile() {
+    std::error_code error;
+    std::filesystem::remove(m_path, error);
+  }
+
+  const std::filesystem::path& path() const { return m_path; }
+};
+
+// Adds a cursor over each of the sorted runs in `files`, reading `buffer_points` at a time
+// through a stream kept in `streams`.
+template <typename PointType>
+void open_spill_runs(std::span<const std::unique_ptr<SpillFile>> files, size_t buffer_points,
+                     std::vector<std::unique_ptr<std::ifstream>>& streams,
+                     std::vector<SortedRunCursor<PointType>>& cursors) {
+  for (const std::unique_ptr<SpillFile>& file : files) {
+    streams.push_back(std::make_unique<std::ifstream>(file->path(), std::ios::binary));
+    std::ifstream& stream = *streams.back();
+    LASPP_ASSERT(stream.is_open(), "Failed to open ", file->path().string());
+    cursors.emplace_back(buffer_points, [&stream](std::span<PointType> buffer) -> size_t {
+      stream.read(reinterpret_cast<char*>(buffer.data()),
+                  static_cast<std::streamsize>(buffer.size_bytes()));
+      const size_t n_bytes = static_cast<size_t>(stream.gcount());
+      LASPP_ASSERT_EQ(n_bytes % sizeof(PointType), 0u, "Truncated sort run");
+      return n_bytes / sizeof(PointType);
+    });
+  }
+}
+
+template <typename PointType>
+void find_point_gps_time_runs(LASReader& reader, size_t block_points,
+                               std::vector<GPSTimeRun>& runs) {
+  if constexpr (has_gps_time_v<PointType>) {
+    for_each_point_block<PointType>(
+        reader, block_points, [&](std::span<const PointType> points, uint64_t first_point) {
+          for (size_t i = 0; i < points.size(); i++) {
+            const double time = gps_time_of(points[i]);
+            const uint16_t source = points[i].point_source_id;
+            if (runs.empty() || source != runs.back().point_source_id ||
+                time < runs.back().last_time) {
+              runs.push_back({first_point + i, first_point + i, source, time, time});
+            }
+            runs.back().end_point = first_point + i + 1;
+            runs.back().last_time = time;
+          }
+        });
+  } else {
+    LASPP_FAIL("Point format ", reader.header().point_format() & ~128, " has no GPS time");
+  }
+}
+
+template <typename PointType>
+void sort_points_by_gps_time(LASReader& reader, LASWriter& writer,
+                             const GPSTimeSortOptions& options,
+                             const std::vector<GPSTimeRun>& input_runs,
+                             GPSTimeSortStatistics& statistics) {
+  if constexpr (has_gps_time_v<PointType>) {
+    const std::vector<size_t> points_per_chunk = reader.points_per_chunk();
+    const size_t max_chunk_points =
+        points_per_chunk.empty()
+            ? size_t{1}
+            : *std::max_element(points_per_chunk.begin(), points_per_chunk.end());
+    std::vector<uint64_t> chunk_end(points_per_chunk.size());
+    std::partial_sum(points_per_chunk.begin(), points_per_chunk.end(), chunk_end.begin());
+    std::vector<SortedRunCursor<PointType>> cursors;
+    std::vector<std::unique_ptr<SpillFile>> spill_files;
+    std::vector<std::unique_ptr<std::ifstream>> spill_streams;
+
+    // Each run is read in place. A LAZ run is refilled up to the end of a chunk at a time, so
+    // every chunk is decoded once for each run it holds points of. Merging needs a buffer per
+    // run; when they do not fit the memory budget, the file is sorted externally instead.
+    const bool is_laz = reader.header().is_laz_compressed();
+    const size_t buffer_points =
+        is_laz ? max_chunk_points : std::min(max_chunk_points, options.output_chunk_points);
+    std::optional<utilities::MemoryReservation> reservation;
+    if (input_runs.size() <= options.max_merge_runs) {
+      reservation = utilities::MemoryReservation::try_reserve(
+          utilities::get_memory_budget(), input_runs.size() * buffer_points * sizeof(PointType));
+    }
+
+    if (reservation.has_value()) {
+      for (const GPSTimeRun& run : input_runs) {
+        cursors.emplace_back(
+            buffer_points,
+            [&reader, &chunk_end, is_laz, buffer_points, next = run.first_point,
+             end = run.end_point](std::span<PointType> buffer) mutable -> size_t {
+              if (next == end) return 0;
+              uint64_t last = std::min<uint64_t>(end, next + buffer_points);
+              if (is_laz) {
+                last = std::min(last, *std::upper_bound(chunk_end.begin(), chunk_end.end(), next));
+              }
+              const size_t n = last - next;
+              read_point_range(reader, buffer.subspan(0, n), next);
+              next = last;
+              return n;
+            });
+      }
+      statistics.n_merged_runs = input_runs.size();
+    } else {
+      // Unordered data: sort blocks of the file in memory, spill them to temporary files and
+      // merge those.
+      statistics.external_sort = true;
+      reservation.emplace(utilities::get_memory_budget(),
+                          std::max(options.sort_run_points, max_chunk_points) * sizeof(PointType),
+                          "GPS time sort run");
+      for_each_point_block<PointType>(
+          reader, options.sort_run_points, [&](std::span<PointType> points, uint64_t) {
+            std::stable_sort(points.begin(), points.end(),
+                             [](const PointType& a, const PointType& b) {
+                               return gps_time_of(a) < gps_time_of(b);
+                             });
+            spill_files.push_back(std::make_unique<SpillFile>(options.temporary_directory));
+            std::ofstream file(spill_files.back()->path(), std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(points.data()),
+                       static_cast<std::streamsize>(points.size_bytes()));
+            LASPP_ASSERT(file.good(), "Failed to write ", spill_files.back()->path().string());
+          });
+      statistics.n_merged_runs = spill_files.size();
+      // The merge shares out the memory of one sort run between its buffers. While there are
+      // more runs than the fan-in, groups of them are merged into longer runs, each pass
+      // giving a buffer to every run of a group and one to its output.
+      const size_t merge_points = std::max(options.sort_run_points, max_chunk_points);
+      while (spill_files.size() > options.merge_fan_in) {
+        std::vector<std::unique_ptr<SpillFile>> merged_files;
+        for (size_t first = 0; first < spill_files.size(); first += options.merge_fan_in) {
+          const size_t end = std::min(first + options.merge_fan_in, spill_files.size());
+          const size_t pass_buffer_points = std::max<size_t>(1, merge_points / (end - first + 1));
+          std::vector<std::unique_ptr<std::ifstream>> group_streams;
+          std::vector<SortedRunCursor<PointType>> group;
+          open_spill_runs<PointType>(
+              std::span<const std::unique_ptr<SpillFile>>(spill_files).subspan(first, end - first),
+              pass_buffer_points, group_streams, group);
+          merged_files.push_back(std::make_unique<SpillFile>(options.temporary_directory));
+          std::ofstream file(merged_files.back()->path(), std::ios::binary | std::ios::trunc);
+          merge_sorted_runs(group, pass_buffer_points, [&](std::span<const PointType> points) {
+            file.write(reinterpret_cast<const char*>(points.data()),
+                       static_cast<std::streamsize>(points.size_bytes()));
+            LASPP_ASSERT(file.good(), "Failed to write ", merged_files.back()->path().string());
+          });
+        }
+        spill_files = std::move(merged_files);
+        statistics.n_merge_passes++;
+      }
+      const size_t final_buffer_points =
+          std::max<size_t>(1, merge_points / std::max<size_t>(1, spill_files.size()));
+      open_spill_runs<PointType>(std::span<const std::unique_ptr<SpillFile>>(spill_files),
+                                 final_buffer_points, spill_streams, cursors);
+    }
+    merge_sorted_runs(cursors, options.output_chunk_points,
+                      [&](std::span<const PointType> points) {
+                        writer.write_points(points, options.output_chunk_points);
+                      });
+    statistics.n_merge_passes++;
+  } else {
+    LASPP_FAIL("Point format ", reader.header().point_format() & ~128, " has no GPS time");
+  }
+}
+
+}  // namespace detail
+
+// The time-monotone runs of `reader`, in file order: a run ends where the point source ID
+// changes or the GPS time goes backwards. Tiles cut from a few flight lines, each stored in
+// acquisition order, have a few long runs; points in any other order give many short ones.
+// Streams the file once, a block of chunks at a time.
+inline std::vector<GPSTimeRun> find_gps_time_runs(LASReader& reader,
+                                                  size_t block_points = size_t{1} << 20) {
+  std::vector<GPSTimeRun> runs;
+  LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(), detail::find_point_gps_time_runs,
+                               reader, block_points, runs);
+  return runs;
+}
+
+// Rewrites the points of `reader` into `writer` in GPS time order, which GPS time coding
+// compresses better and time-range queries decode fewer chunks of. When the file has at most
+// options.max_merge_runs time-monotone runs (see find_gps_time_runs) and a chunk-sized buffer
+// per run fits the memory budget, the runs are k-way merged straight from the input; otherwise
+// the file is sorted externally, in runs of options.sort_run_points points spilled to
+// options.temporary_directory and merged options.merge_fan_in at a time, in as many passes as
+// that takes. Points with equal times keep their file order. Header metadata, VLRs and EVLRs
+// are copied from the reader, except for its spatial index, which no longer matches the point
+// order.
+inline GPSTimeSortStatistics rewrite_in_gps_time_order(LASReader& reader, LASWriter& writer,
+                                                       const GPSTimeSortOptions& options = {}) {
+  LASPP_ASSERT_GT(options.output_chunk_points, 0u);
+  LASPP_ASSERT_GT(options.sort_run_points, 0u);
+  LASPP_ASSERT_GE(options.merge_fan_in, 2u);
+  GPSTimeSortStatistics statistics;
+  const std::vector<GPSTimeRun> runs = find_gps_time_runs(reader, options.sort_run_points);
+  statistics.n_input_runs = runs.size();
+
+  writer.copy_metadata_from(reader, true);
+  LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(), detail::sort_points_by_gps_time,
+                               reader, writer, options, runs, statistics);
+  writer.copy_evlrs_from(reader, true);
+  return statistics;
+}
+
+}  // namespace laspp
@@ -11,11 +11,13 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 #include "las_point.hpp"
 #include "utilities/assert.hpp"
@@ -24,13 +26,14 @@
 namespace laspp {
 
 class LASWriter;
+class LASMetadataEditor;
 
 enum GlobalEncoding : uint16_t {
-  GPS_TIME = 2 << 0,
-  WAVEFORM_DATA_INTERNAL = 2 << 1,
-  WAVEFORM_DATA_EXTERNAL = 2 << 2,
-  SYNTHETIC_RETURN_NUMBERS = 2 << 3,
-  WKT = 2 << 4,
+  GPS_TIME = 1 << 0,
+  WAVEFORM_DATA_INTERNAL = 1 << 1,
+  WAVEFORM_DATA_EXTERNAL = 1 << 2,
+  SYNTHETIC_RETURN_NUMBERS = 1 << 3,
+  WKT = 1 << 4,
 };
 
 inline std::string global_encoding_string(const uint16_t& encoding) {
@@ -104,6 +107,35 @@ class Transform {
   }
 };
 
+// A 3D affine map p' = A p + t, e.g. a strip adjustment or datum shift. Stored as three rows
+// [a_r0, a_r1, a_r2, t_r], one per output coordinate.
+class AffineTransform {
+  std::array<std::array<double, 4>, 3> m_rows = {{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}};
+
+ public:
+  AffineTransform() = default;
+  explicit AffineTransform(const std::array<std::array<double, 4>, 3>& rows) : m_rows(rows) {}
+
+  const std::array<double, 4>& row(size_t i) const { return m_rows[i]; }
+
+  Vector3D apply(const Vector3D& p) const {
+    Vector3D result;
+    for (size_t r = 0; r < 3; r++) {
+      result[r] =
+          m_rows[r][0] * p.x() + m_rows[r][1] * p.y() + m_rows[r][2] * p.z() + m_rows[r][3];
+    }
+    return result;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const AffineTransform& affine) {
+    for (const auto& row : affine.m_rows) {
+      os << "[" << row[0] << ", " << row[1] << ", " << row[2] << ", " << row[3] << "]"
+         << std::endl;
+    }
+    return os;
+  }
+};
+
 inline double int32_to_double(int32_t coord, double scale, double offset) {
   return coord * scale + offset;
 }
@@ -255,6 +287,53 @@ class Bound3D {
   }
 };
 
+// Header statistics of a run of point records: point count, counts by return number and bounds
+// in the file's integer coordinates. Summaries of disjoint runs combine into those of the whole.
+struct ChunkSummary {
+  uint64_t n_points = 0;
+  std::array<uint64_t, 15> points_by_return{};
+  std::array<int32_t, 3> min_pos{std::numeric_limits<int32_t>::max(),
+                                 std::numeric_limits<int32_t>::max(),
+                                 std::numeric_limits<int32_t>::max()};
+  std::array<int32_t, 3> max_pos{std::numeric_limits<int32_t>::lowest(),
+                                 std::numeric_limits<int32_t>::lowest(),
+                                 std::numeric_limits<int32_t>::lowest()};
+
+  template <typename PointType>
+  void add(const PointType& point) {
+    n_points++;
+    if constexpr (std::is_base_of_v<LASPointFormat0, PointType>) {
+      if (point.bit_byte.return_number < 16 && point.bit_byte.return_number > 0) {
+        points_by_return[point.bit_byte.return_number - 1]++;
+      }
+    } else if constexpr (std::is_base_of_v<LASPointFormat6, PointType>) {
+      if (point.return_number < 16 && point.return_number > 0) {
+        points_by_return[point.return_number - 1]++;
+      }
+    }
+    // Read x, y, z using memcpy to avoid alignment issues with packed structures
+    int32_t pos[3];
+    std::memcpy(&pos[0], &point.x, sizeof(int32_t));
+    std::memcpy(&pos[1], &point.y, sizeof(int32_t));
+    std::memcpy(&pos[2], &point.z, sizeof(int32_t));
+    for (size_t j = 0; j < 3; j++) {
+      min_pos[j] = std::min(min_pos[j], pos[j]);
+      max_pos[j] = std::max(max_pos[j], pos[j]);
+    }
+  }
+
+  void combine(const ChunkSummary& other) {
+    n_points += other.n_points;
+    for (size_t j = 0; j < 15; j++) {
+      points_by_return[j] += other.points_by_return[j];
+    }
+    for (size_t j = 0; j < 3; j++) {
+      min_pos[j] = std::min(min_pos[j], other.min_pos[j]);
+      max_pos[j] = std::max(max_pos[j], other.max_pos[j]);
+    }
+  }
+};
+
 class LASHeader {
   char m_file_signature[4] = {'L', 'A', 'S', 'F'};
   uint16_t m_file_source_id = 0;
@@ -417,6 +496,8 @@ class LASHeader {
 
   const Bound3D& bounds() const { return m_bounds; }
 
+  uint16_t global_encoding() const { return m_global_encoding; }
+
   size_t size() const { return m_header_size; }
 
   unsigned int point_data_record_length() const { return m_point_data_record_length; }
@@ -486,6 +567,7 @@ class LASHeader {
   }
 
   friend LASWriter;
+  friend LASMetadataEditor;
 };
 
 }  // namespace laspp
@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "las_header.hpp"
+#include "utilities/assert.hpp"
+#include "vlr.hpp"
+
+namespace laspp {
+
+// Edits the VLRs of an existing LAS/LAZ file in place. VLRs live between the header and the
+// point data; the editor rewrites only that region and the header, so neither the points nor
+// the EVLRs move. Files written after LASWriter::reserve_vlr_padding() have room for VLRs to be
+// added or grow; in other files an edit fits only if the VLRs do not get larger. Edits are
+// staged in memory and written by save().
+class LASMetadataEditor {
+ public:
+  struct VLRRecord {
+    LASVLR header;
+    std::vector<std::byte> data;
+
+    size_t size() const { return sizeof(LASVLR) + data.size(); }
+  };
+
+ private:
+  std::optional<std::fstream> m_owned_stream;
+  std::iostream* m_stream;
+  LASHeader m_header;
+  std::vector<VLRRecord> m_vlrs;
+
+  void read_vlrs() {
+    LASPP_CHECK_SEEK(*m_stream, m_header.VLR_offset(), std::ios::beg);
+    for (size_t i = 0; i < m_header.VLR_count(); i++) {
+      VLRRecord record;
+      LASPP_CHECK_READ(*m_stream, &record.header, sizeof(LASVLR));
+      record.data.resize(record.header.record_length_after_header);
+      LASPP_CHECK_READ(*m_stream, record.data.data(), record.data.size());
+      m_vlrs.push_back(std::move(record));
+    }
+    LASPP_ASSERT_LE(vlr_bytes(), capacity(), "VLRs run into the point data");
+  }
+
+  std::optional<size_t> find(std::string_view user_id, uint16_t record_id) const {
+    for (size_t i = 0; i < m_vlrs.size(); i++) {
+      if (las_packed_string(m_vlrs[i].header.user_id) == user_id &&
+          m_vlrs[i].header.record_id == record_id) {
+        return i;
+      }
+    }
+    return std::nullopt;
+  }
+
+ public:
+  explicit LASMetadataEditor(std::iostream& stream) : m_stream(&stream), m_header(stream) {
+    read_vlrs();
+  }
+
+  explicit LASMetadataEditor(const std::filesystem::path& file_path)
+      : m_owned_stream(std::in_place, file_path,
+                       std::ios::binary | std::ios::in | std::ios::out),
+        m_stream(&m_owned_stream.value()),
+        m_header(m_owned_stream->is_open()
+                     ? LASHeader(*m_owned_stream)
+                     : throw std::runtime_error("Failed to open file: " + file_path.string())) {
+    read_vlrs();
+  }
+
+  const LASHeader& header() const { return m_header; }
+  const std::vector<VLRRecord>& vlrs() const { return m_vlrs; }
+
+  // Bytes between the header and the point data, and how many of them the VLRs take up.
+  size_t capacity() const { return m_header.offset_to_point_data() - m_header.VLR_offset(); }
+  size_t vlr_bytes() const {
+    size_t bytes = 0;
+    for (const VLRRecord& record : m_vlrs) {
+      bytes += record.size();
+    }
+    return bytes;
+  }
+  size_t free_bytes() const { return capacity() - vlr_bytes(); }
+
+  // Replaces the first VLR with the same user ID and record ID as `vlr`, or adds it. Throws if
+  // the VLRs would no longer fit before the point data.
+  void set_vlr(const LASVLR& vlr, std::span<const std::byte> data) {
+    LASPP_ASSERT_EQ(vlr.record_length_after_header, data.size());
+    LASPP_ASSERT(!vlr.is_laz_vlr(), "The LAZ VLR describes the point data and cannot be edited");
+    VLRRecord record{vlr, std::vector<std::byte>(data.begin(), data.end())};
+    const std::optional<size_t> existing = find(las_packed_string(vlr.user_id), vlr.record_id);
+    const size_t replaced_size = existing.has_value() ? m_vlrs[*existing].size() : 0;
+    LASPP_ASSERT_LE(vlr_bytes() - replaced_size + record.size(), capacity(),
+                    "Not enough space before the point data; write the file with "
+                    "LASWriter::reserve_vlr_padding()");
+    if (existing.has_value()) {
+      m_vlrs[*existing] = std::move(record);
+    } else {
+      m_vlrs.push_back(std::move(record));
+    }
+  }
+
+  void set_wkt(const std::string& wkt, bool math_transform_wkt = false) {
+    LASVLR vlr;
+    vlr.reserved = 0;
+    string_to_arr("LASF_Projection", vlr.user_id);
+    vlr.record_id = math_transform_wkt ? uint16_t{2111} : uint16_t{2112};
+    vlr.record_length_after_header = static_cast<uint16_t>(wkt.size() + 1);
+    string_to_arr("OGC WKT", vlr.description);
+    set_vlr(vlr, std::span(reinterpret_cast<const std::byte*>(wkt.c_str()), wkt.size() + 1));
+    m_header.m_global_encoding |= GlobalEncoding::WKT;
+  }
+
+  // Removes the first VLR with the given IDs; returns whether there was one.
+  bool remove_vlr(std::string_view user_id, uint16_t record_id) {
+    const std::optional<size_t> existing = find(user_id, record_id);
+    if (!existing.has_value()) {
+      return false;
+    }
+    LASPP_ASSERT(!m_vlrs[*existing].header.is_laz_vlr(),
+                 "The LAZ VLR describes the point data and cannot be removed");
+    m_vlrs.erase(m_vlrs.begin() + static_cast<std::ptrdiff_t>(*existing));
+    return true;
+  }
+
+  // Writes the VLRs back, zeroes the rest of the space before the point data and updates the
+  // VLR count in the header.
+  void save() {
+    std::vector<char> region(capacity(), 0);
+    size_t position = 0;
+    for (const VLRRecord& record : m_vlrs) {
+      std::memcpy(region.data() + position, &record.header, sizeof(LASVLR));
+      std::memcpy(region.data() + position + sizeof(LASVLR), record.data.data(),
+                  record.data.size());
+      position += record.size();
+    }
+    m_header.m_number_of_variable_length_records = static_cast<uint32_t>(m_vlrs.size());
+
+    m_stream->seekp(0);
+    m_header.write(*m_stream);
+    m_stream->seekp(m_header.VLR_offset());
+    m_stream->write(region.data(), static_cast<std::streamsize>(region.size()));
+    m_stream->flush();
+    LASPP_ASSERT(m_stream->good(), "Failed to write metadata");
+  }
+};
+
+}  // namespace laspp
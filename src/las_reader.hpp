@@ -6,9 +6,11 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -18,6 +20,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "example_custom_las_point.hpp"
@@ -28,6 +31,9 @@
 #include "laz/stream.hpp"
 #include "spatial_index.hpp"
 #include "utilities/assert.hpp"
+#include "utilities/buffer_pool.hpp"
+#include "utilities/cancellation.hpp"
+#include "utilities/default_init_allocator.hpp"
 #include "utilities/env.hpp"
 #include "utilities/memory_mapped_file.hpp"
 #include "utilities/thread_pool.hpp"
@@ -35,6 +41,64 @@
 
 namespace laspp {
 
+// Read-only view of one part (PointType) of consecutive point records `stride` bytes apart,
+// e.g. the GPSTime of every record of a memory-mapped file.
+template <typename PointType>
+class StridedPointView {
+  static_assert(alignof(PointType) == 1, "Point records are only byte aligned");
+
+  const std::byte* m_first = nullptr;
+  size_t m_size = 0;
+  size_t m_stride = 0;
+
+ public:
+  class iterator {
+    const std::byte* m_ptr = nullptr;
+    size_t m_stride = 0;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = PointType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const PointType*;
+    using reference = const PointType&;
+
+    iterator() = default;
+    iterator(const std::byte* ptr, size_t stride) : m_ptr(ptr), m_stride(stride) {}
+
+    reference operator*() const { return *reinterpret_cast<const PointType*>(m_ptr); }
+    pointer operator->() const { return reinterpret_cast<const PointType*>(m_ptr); }
+    iterator& operator++() {
+      m_ptr += m_stride;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator it = *this;
+      ++*this;
+      return it;
+    }
+    bool operator==(const iterator& other) const { return m_ptr == other.m_ptr; }
+  };
+
+  StridedPointView() = default;
+  StridedPointView(const std::byte* first, size_t size, size_t stride)
+      : m_first(first), m_size(size), m_stride(stride) {
+    LASPP_ASSERT_GE(stride, sizeof(PointType));
+  }
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  size_t stride() const { return m_stride; }
+
+  const PointType& operator[](size_t i) const {
+    LASPP_DEBUG_ASSERT_LT(i, m_size);
+    return *reinterpret_cast<const PointType*>(m_first + i * m_stride);
+  }
+
+  iterator begin() const { return iterator(m_first, m_stride); }
+  iterator end() const { return iterator(m_first + m_size * m_stride, m_stride); }
+};
+
 class LASReader {
  public:
   LASReader(const LASReader&) = delete;
@@ -50,6 +114,9 @@ class LASReader {
   std::optional<PointerStreamBuffer> m_mapped_buffer;        // Stream buffer for mapped file
   std::optional<std::istream> m_mapped_stream;               // Stream view of mapped file
   std::optional<std::filesystem::path> m_file_path;          // File path for .lax file lookup
+  // Reusable read buffers for the stream path (unused when memory mapped). Declared before
+  // the header/VLR members because the istream constructor reads EVLR data while initialising.
+  utilities::BufferPool m_buffer_pool;
   LASHeader m_header;
   std::optional<LAZReader> m_laz_reader;
   std::optional<std::string> m_math_wkt;
@@ -59,27 +126,45 @@ class LASReader {
   std::vector<LASVLRWithGlobalOffset> m_vlr_headers;
   std::vector<LASEVLRWithGlobalOffset> m_evlr_headers;
 
-  // Unified I/O helper: zero-copy view for memory-mapped path, owned buffer for stream path.
+  // Decoder snapshots inside one LAZ chunk (see enable_point_checkpoints()).
+  struct ChunkCheckpoints {
+    std::vector<std::byte> compressed_data;  // owned copy of the chunk (stream path only)
+    std::vector<LAZChunkDecoder> decoders;   // decoders[k] is positioned at (k + 1) * interval
+  };
+  struct CachedCheckpoints {
+    std::shared_ptr<const ChunkCheckpoints> checkpoints;
+    uint64_t last_use;
+  };
+  std::unordered_map<size_t, CachedCheckpoints> m_point_checkpoints;  // by chunk index
+  size_t m_point_checkpoint_interval = 0;
+  size_t m_max_point_checkpoints = 0;
+  size_t m_n_point_checkpoints = 0;
+  uint64_t m_point_checkpoint_clock = 0;
+
+  // Unified I/O helper: zero-copy view for memory-mapped path, pooled buffer for stream path.
   // The returned object is non-copyable; its `data` span is always valid for its lifetime.
   struct ReadBuffer {
-    std::vector<std::byte> storage;   // populated only for the stream path
-    std::span<const std::byte> data;  // always valid
+    utilities::BufferPool::Buffer storage;  // populated only for the stream path
+    std::span<const std::byte> data;        // always valid
 
     explicit ReadBuffer(std::span<const std::byte> span) noexcept : data(span) {}
-    explicit ReadBuffer(std::vector<std::byte>&& buf) : storage(std::move(buf)), data(storage) {}
+    explicit ReadBuffer(utilities::BufferPool::Buffer&& buf)
+        : storage(std::move(buf)), data(storage.span()) {}
 
     ReadBuffer(const ReadBuffer&) = delete;
     ReadBuffer& operator=(const ReadBuffer&) = delete;
     ReadBuffer(ReadBuffer&&) = default;
   };
 
+  // Not thread-safe for the stream path: callers reading from several threads must serialise
+  // calls (the returned buffer may then be used without the lock).
   ReadBuffer get_bytes(size_t offset, size_t size) {
     if (m_mapped_file.has_value()) {
       return ReadBuffer(m_mapped_file->subspan(offset, size));
     }
     LASPP_ASSERT(m_input_stream != nullptr, "m_input_stream must be set for stream-based I/O");
 
-    std::vector<std::byte> buf(size);
+    utilities::BufferPool::Buffer buf = m_buffer_pool.acquire(size);
     LASPP_CHECK_SEEK(*m_input_stream, offset, std::ios::beg);
     LASPP_CHECK_READ(*m_input_stream, buf.data(), size);
 
@@ -110,7 +195,7 @@ class LASReader {
       if constexpr (std::is_same_v<typename T::record_type, LASVLR>) {
         if (record.is_laz_vlr()) {
           LAZSpecialVLRContent laz_vlr(*m_input_stream);
-          m_laz_reader.emplace(LAZReader(laz_vlr));
+          m_laz_reader.emplace(laz_vlr);
         }
         if (record.is_projection()) {
           if (record.is_ogc_math_transform_wkt()) {
@@ -267,7 +352,7 @@ class LASReader {
     if (m_header.is_laz_compressed()) {
       LASPP_ASSERT(m_laz_reader.has_value(), "LASReader: LAZ point format without LAZ VLR");
       m_input_stream->seekg(header().offset_to_point_data());
-      m_laz_reader->read_chunk_table(*m_input_stream, header().num_points());
+      m_laz_reader->defer_chunk_table(*m_input_stream, header().num_points());
     }
   }
 
@@ -282,7 +367,7 @@ class LASReader {
     if (m_header.is_laz_compressed()) {
       LASPP_ASSERT(m_laz_reader.has_value(), "LASReader: LAZ point format without LAZ VLR");
       m_input_stream->seekg(header().offset_to_point_data());
-      m_laz_reader->read_chunk_table(*m_input_stream, header().num_points());
+      m_laz_reader->defer_chunk_table(*m_input_stream, header().num_points());
     }
   }
 
@@ -294,6 +379,10 @@ class LASReader {
   // Check if memory mapping is being used (for debugging/verification)
   bool is_using_memory_mapping() const noexcept { return m_mapped_file.has_value(); }
 
+  // Allocation statistics for the stream-path read buffers. `bytes_allocated_per_acquire()`
+  // approximates bytes allocated per chunk read and drops towards zero once the pool is warm.
+  utilities::BufferPool::Stats read_buffer_stats() const { return m_buffer_pool.stats(); }
+
   size_t num_points() const { return m_header.num_points(); }
   size_t num_chunks() const {
     if (m_laz_reader.has_value()) {
@@ -323,9 +412,11 @@ class LASReader {
   }
 
   template <typename PointType, typename T>
-  void read_points(std::span<T> points) {
+  void read_points(std::span<T> points, size_t first_point = 0) {
     LASPP_ASSERT_EQ(sizeof(PointType), m_header.point_data_record_length());
-    size_t point_data_offset = header().offset_to_point_data();
+    LASPP_ASSERT_LE(first_point + points.size(), num_points());
+    size_t point_data_offset =
+        header().offset_to_point_data() + first_point * header().point_data_record_length();
     size_t point_record_length = header().point_data_record_length();
 
     static_assert(is_copy_assignable<ExampleMinimalLASPoint, LASPointFormat0>());
@@ -335,13 +426,235 @@ class LASReader {
                       is_convertable<T, GPSTime>(),
                   "PointType should use data from LAS file");
 
+    if constexpr (std::is_same_v<PointType, T> && std::is_trivially_copyable_v<T>) {
+      // The caller's type is the record layout: copy (or read) the records in one go.
+      if (m_mapped_file.has_value()) {
+        auto buf = get_bytes(point_data_offset, points.size() * point_record_length);
+        std::memcpy(points.data(), buf.data.data(), buf.data.size());
+      } else {
+        LASPP_CHECK_SEEK(*m_input_stream, point_data_offset, std::ios::beg);
+        LASPP_CHECK_READ(*m_input_stream, points.data(), points.size() * point_record_length);
+      }
+      return;
+    }
+
     auto buf = get_bytes(point_data_offset, points.size() * point_record_length);
     for (size_t i = 0; i < points.size(); i++) {
+      if (i % 65536 == 65535) {
+        utilities::check_cancellation();
+      }
       const auto* las_point =
           reinterpret_cast<const PointType*>(buf.data.data() + i * point_record_length);
       copy_if_possible<LASPointFormat0>(*las_point, points[i]);
+      copy_if_possible<LASPointFormat6>(*las_point, points[i]);
       copy_if_possible<GPSTime>(*las_point, points[i]);
+      copy_if_possible<ColorData>(*las_point, points[i]);
+      copy_if_possible<NIRData>(*las_point, points[i]);
+      copy_if_possible<WavePacketData>(*las_point, points[i]);
+    }
+  }
+
+  // Offset of the PointType part within a FileType record, if FileType contains one.
+  template <typename PointType>
+  struct RecordPart {
+    template <typename FileType>
+    static std::optional<size_t> offset() {
+      if constexpr (std::is_same_v<PointType, FileType> ||
+                    std::is_base_of_v<PointType, FileType>) {
+        const FileType record{};
+        return static_cast<size_t>(
+            reinterpret_cast<const std::byte*>(static_cast<const PointType*>(&record)) -
+            reinterpret_cast<const std::byte*>(&record));
+      } else {
+        return std::nullopt;
+      }
+    }
+  };
+
+  // Reads points [first_point, first_point + points.size()) of an uncompressed file.
+  // read_points handles both memory-mapped and stream-based I/O
+  template <typename T>
+  void read_uncompressed_points(std::span<T> points, size_t first_point) {
+    if constexpr (std::is_base_of_v<LASPointFormat0, T> || std::is_base_of_v<LASPointFormat6, T>) {
+      read_points<T>(points, first_point);
+    } else {
+      LASPP_SWITCH_OVER_POINT_TYPE(header().point_format(), read_points, points, first_point);
+    }
+  }
+
+  // Compressed bytes of a LAZ chunk, preferring the copy held by its point checkpoints.
+  // Stream reads are serialised through `stream_mutex`.
+  ReadBuffer compressed_chunk_bytes(size_t chunk_index, std::mutex& stream_mutex) {
+    auto cached = m_point_checkpoints.find(chunk_index);
+    if (cached != m_point_checkpoints.end() &&
+        !cached->second.checkpoints->compressed_data.empty()) {
+      return ReadBuffer(std::span<const std::byte>(cached->second.checkpoints->compressed_data));
+    }
+    const LAZChunkTable::ChunkLocation chunk = m_laz_reader->chunk_table().chunk(chunk_index);
+    const size_t file_data_offset = header().offset_to_point_data() + chunk.compressed_offset;
+    if (m_mapped_file.has_value()) {
+      return get_bytes(file_data_offset, chunk.compressed_size);
     }
+    std::lock_guard<std::mutex> lock(stream_mutex);
+    return get_bytes(file_data_offset, chunk.compressed_size);
+  }
+
+  // Destination for decoding only the coordinates used by spatial queries.
+  struct PointXY {
+    int32_t x;
+    int32_t y;
+
+    friend void copy_from(PointXY& dest, const LASPointFormat0& src) {
+      dest.x = src.x;
+      dest.y = src.y;
+    }
+    friend void copy_from(PointXY& dest, const LASPointFormat6& src) {
+      dest.x = src.x;
+      dest.y = src.y;
+    }
+  };
+
+  // Decodes the X/Y of the points in `intervals` and passes them to f(std::span<const PointXY>)
+  // in batches, concurrently from worker threads. Each LAZ chunk is decoded once, from its start
+  // or nearest point checkpoint, skipping the points between intervals.
+  template <typename Function>
+  void for_each_xy_batch(std::vector<PointInterval> intervals, Function&& f) {
+    constexpr size_t BATCH_SIZE = 4096;
+    if (intervals.empty()) {
+      return;
+    }
+
+    // Sort and coalesce so that every chunk is traversed once, front to back
+    std::sort(intervals.begin(), intervals.end(),
+              [](const PointInterval& a, const PointInterval& b) { return a.start < b.start; });
+    std::vector<PointInterval> merged = {intervals.front()};
+    for (const PointInterval& interval : intervals) {
+      LASPP_ASSERT_LT(interval.end, num_points(), "Spatial index interval past the last point");
+      if (interval.start <= merged.back().end + 1) {
+        merged.back().end = std::max(merged.back().end, interval.end);
+      } else {
+        merged.push_back(interval);
+      }
+    }
+
+    if (!header().is_laz_compressed()) {
+      std::vector<PointInterval> batches;
+      for (const PointInterval& interval : merged) {
+        for (uint64_t start = interval.start; start <= interval.end; start += BATCH_SIZE) {
+          batches.push_back({start, std::min<uint64_t>(interval.end, start + BATCH_SIZE - 1)});
+        }
+      }
+      auto read_batch = [&](size_t i) {
+        utilities::UninitializedVector<PointXY> points(batches[i].end - batches[i].start + 1);
+        read_uncompressed_points(std::span<PointXY>(points), batches[i].start);
+        f(std::span<const PointXY>(points));
+      };
+      if (m_mapped_file.has_value()) {
+        utilities::parallel_for(size_t{0}, batches.size(), read_batch);
+      } else {
+        for (size_t i = 0; i < batches.size(); i++) read_batch(i);
+      }
+      return;
+    }
+
+    // Split at chunk boundaries; pieces of one chunk are contiguous in `pieces`
+    struct Piece {
+      size_t chunk_index;
+      uint64_t start;
+      uint64_t end;
+    };
+    const auto& chunk_table = m_laz_reader->chunk_table();
+    std::vector<Piece> pieces;
+    std::vector<size_t> chunk_begin;
+    for (const PointInterval& interval : merged) {
+      uint64_t start = interval.start;
+      while (start <= interval.end) {
+        const size_t chunk_index = chunk_table.chunk_containing_point(start);
+        const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(chunk_index);
+        const uint64_t end =
+            std::min<uint64_t>(interval.end, chunk.first_point + chunk.n_points - 1);
+        if (pieces.empty() || pieces.back().chunk_index != chunk_index) {
+          chunk_begin.push_back(pieces.size());
+        }
+        pieces.push_back({chunk_index, start, end});
+        start = end + 1;
+      }
+    }
+    chunk_begin.push_back(pieces.size());
+
+    const size_t interval = m_point_checkpoint_interval;
+    std::vector<size_t> checkpointed_chunks;
+    for (const Piece& piece : pieces) {
+      if (interval != 0 && piece.start - chunk_table.decompressed_chunk_offset(piece.chunk_index) >=
+                               interval) {
+        checkpointed_chunks.push_back(piece.chunk_index);
+      }
+    }
+    const CheckpointsInUse checkpoints = load_point_checkpoints(checkpointed_chunks);
+    std::mutex stream_mutex;
+    utilities::parallel_for(size_t{0}, chunk_begin.size() - 1, [&](size_t c) {
+      const size_t chunk_index = pieces[chunk_begin[c]].chunk_index;
+      const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(chunk_index);
+      std::optional<ReadBuffer> compressed_buffer;
+      std::optional<LAZChunkDecoder> decoder;
+      utilities::UninitializedVector<PointXY> points(BATCH_SIZE);
+      for (size_t p = chunk_begin[c]; p < chunk_begin[c + 1]; p++) {
+        const size_t first = pieces[p].start - chunk.first_point;
+        const size_t segment = interval == 0 ? 0 : first / interval;
+        if (segment > 0 && (!decoder.has_value() || decoder->next_point() < segment * interval)) {
+          decoder.emplace(checkpoints.at(chunk_index)->decoders[segment - 1]);
+        } else if (!decoder.has_value()) {
+          compressed_buffer.emplace(compressed_chunk_bytes(chunk_index, stream_mutex));
+          decoder.emplace(m_laz_reader->chunk_decoder(compressed_buffer->data, chunk.n_points));
+        }
+        decoder->skip(first - decoder->next_point());
+        for (size_t remaining = pieces[p].end - pieces[p].start + 1; remaining > 0;) {
+          const size_t n = std::min(remaining, BATCH_SIZE);
+          f(std::span<const PointXY>(decoder->decode(std::span<PointXY>(points.data(), n))));
+          remaining -= n;
+        }
+      }
+    });
+  }
+
+  // The intervals of the whole file, or of nothing for an empty file.
+  std::vector<PointInterval> all_points_intervals() const {
+    if (num_points() == 0) return {};
+    return {{0, num_points() - 1}};
+  }
+
+  Bound2D data_bounds() const {
+    const Bound3D& bounds = header().bounds();
+    return Bound2D(bounds.min_x(), bounds.min_y(), bounds.max_x(), bounds.max_y());
+  }
+
+  // Slack added around index cells: one coordinate quantum guards against rounding
+  // differences between the indexer's cell assignment and ours.
+  double index_cell_margin() const {
+    return std::max(header().transform().scale_factors().x(),
+                    header().transform().scale_factors().y());
+  }
+
+  template <typename PointType>
+  void summarize_chunks(std::span<ChunkSummary> summaries) {
+    if (!header().is_laz_compressed()) {
+      constexpr size_t BATCH_SIZE = 65536;
+      utilities::UninitializedVector<PointType> points(std::min(BATCH_SIZE, num_points()));
+      for (size_t first = 0; first < num_points(); first += BATCH_SIZE) {
+        const size_t n = std::min(BATCH_SIZE, num_points() - first);
+        read_uncompressed_points(std::span<PointType>(points.data(), n), first);
+        for (size_t i = 0; i < n; i++) summaries[0].add(points[i]);
+      }
+      return;
+    }
+    std::mutex stream_mutex;
+    utilities::parallel_for(size_t{0}, summaries.size(), [&](size_t chunk_index) {
+      ReadBuffer compressed_buffer = compressed_chunk_bytes(chunk_index, stream_mutex);
+      utilities::UninitializedVector<PointType> points(
+          m_laz_reader->chunk_table().points_in_chunk(chunk_index));
+      m_laz_reader->decompress_chunk(compressed_buffer.data, std::span<PointType>(points));
+      for (const PointType& point : points) summaries[chunk_index].add(point);
+    });
   }
 
  public:
@@ -354,6 +667,12 @@ class LASReader {
 
   bool has_lastools_spatial_index() const { return m_spatial_index.has_value(); }
 
+  // Whether the spatial index references every point exactly once, so that counts derived
+  // from it are exact and candidate_intervals() narrows regions down.
+  bool spatial_index_is_complete() const {
+    return m_spatial_index.has_value() && m_spatial_index->num_indexed_points() == num_points();
+  }
+
   const QuadtreeSpatialIndex& lastools_spatial_index() const {
     LASPP_ASSERT(m_spatial_index.has_value(), "Spatial index not available");
     return *m_spatial_index;
@@ -362,22 +681,17 @@ class LASReader {
   template <typename T>
   std::span<T> read_chunk(std::span<T> output_location, size_t chunk_index) {
     if (header().is_laz_compressed()) {
-      size_t start_offset = m_laz_reader->chunk_table().chunk_offset(chunk_index);
-      size_t compressed_chunk_size = m_laz_reader->chunk_table().compressed_chunk_size(chunk_index);
-      size_t file_data_offset = header().offset_to_point_data() + start_offset;
-      size_t n_points = m_laz_reader->chunk_table().points_per_chunk()[chunk_index];
+      const auto& chunk_table = m_laz_reader->chunk_table();
+      LASPP_ASSERT_LT(chunk_index, chunk_table.num_chunks());
+      const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(chunk_index);
 
-      auto buf = get_bytes(file_data_offset, compressed_chunk_size);
-      return m_laz_reader->decompress_chunk(buf.data, output_location.subspan(0, n_points));
+      auto buf = get_bytes(header().offset_to_point_data() + chunk.compressed_offset,
+                           chunk.compressed_size);
+      return m_laz_reader->decompress_chunk(buf.data, output_location.subspan(0, chunk.n_points));
     }
     LASPP_ASSERT(chunk_index == 0);
     size_t n_points = num_points();
-    // read_points handles both memory-mapped and stream-based I/O
-    if constexpr (std::is_base_of_v<LASPointFormat0, T> || std::is_base_of_v<LASPointFormat6, T>) {
-      read_points<T>(output_location);
-    } else {
-      LASPP_SWITCH_OVER_POINT_TYPE(header().point_format(), read_points, output_location);
-    }
+    read_uncompressed_points(output_location.subspan(0, n_points), 0);
     return output_location.subspan(0, n_points);
   }
 
@@ -385,11 +699,17 @@ class LASReader {
   std::span<T> read_chunks(std::span<T> output_location, std::pair<size_t, size_t> chunk_indexes) {
     if (header().is_laz_compressed()) {
       const auto& chunk_table = m_laz_reader->chunk_table();
+      LASPP_ASSERT_LE(chunk_indexes.first, chunk_indexes.second);
+      LASPP_ASSERT_LE(chunk_indexes.second, chunk_table.num_chunks());
+      if (chunk_indexes.first == chunk_indexes.second) {
+        return output_location.subspan(0, 0);
+      }
+      const size_t first_point = chunk_table.decompressed_chunk_offset(chunk_indexes.first);
       size_t total_n_points =
           (chunk_indexes.second == chunk_table.num_chunks()
                ? header().num_points()
-               : chunk_table.decompressed_chunk_offsets()[chunk_indexes.second]) -
-          chunk_table.decompressed_chunk_offsets()[chunk_indexes.first];
+               : chunk_table.decompressed_chunk_offset(chunk_indexes.second)) -
+          first_point;
       LASPP_ASSERT_GE(output_location.size(), total_n_points);
 
       std::vector<size_t> chunk_indices(chunk_indexes.second - chunk_indexes.first);
@@ -397,28 +717,25 @@ class LASReader {
 
       if (m_mapped_file.has_value()) {
         // Memory-mapped path: read contiguous block once, then decompress chunks in parallel
-        size_t compressed_start_offset = chunk_table.chunk_offset(chunk_indexes.first);
-        size_t total_compressed_size = chunk_table.compressed_chunk_size(chunk_indexes.second - 1) +
-                                       chunk_table.chunk_offset(chunk_indexes.second - 1) -
-                                       compressed_start_offset;
+        const LAZChunkTable::ChunkLocation last_chunk = chunk_table.chunk(chunk_indexes.second - 1);
+        size_t compressed_start_offset = chunk_table.chunk(chunk_indexes.first).compressed_offset;
+        size_t total_compressed_size =
+            last_chunk.compressed_offset + last_chunk.compressed_size - compressed_start_offset;
         size_t file_data_offset = header().offset_to_point_data() + compressed_start_offset;
         auto buf = get_bytes(file_data_offset, total_compressed_size);
 
         utilities::parallel_for(size_t{0}, chunk_indices.size(), [&](size_t idx) {
           size_t chunk_index = chunk_indices[idx];
-          size_t start_offset = chunk_table.chunk_offset(chunk_index) - compressed_start_offset;
-          size_t compressed_chunk_size = chunk_table.compressed_chunk_size(chunk_index);
-          std::span<const std::byte> compressed_chunk =
-              buf.data.subspan(start_offset, compressed_chunk_size);
-
-          size_t point_offset = chunk_table.decompressed_chunk_offsets()[chunk_index] -
-                                chunk_table.decompressed_chunk_offsets()[chunk_indexes.first];
-          size_t n_points = chunk_table.points_per_chunk()[chunk_index];
+          const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(chunk_index);
+          std::span<const std::byte> compressed_chunk = buf.data.subspan(
+              chunk.compressed_offset - compressed_start_offset, chunk.compressed_size);
+
+          size_t point_offset = chunk.first_point - first_point;
           if (chunk_index == 0) {
             LASPP_ASSERT_EQ(point_offset, 0u);
           }
           m_laz_reader->decompress_chunk(compressed_chunk,
-                                         output_location.subspan(point_offset, n_points));
+                                         output_location.subspan(point_offset, chunk.n_points));
         });
       } else {
         // Stream-based path: read chunks in parallel (with mutex protection) and decompress.
@@ -426,27 +743,23 @@ class LASReader {
         std::mutex stream_mutex;
         utilities::parallel_for(size_t{0}, chunk_indices.size(), [&](size_t idx) {
           size_t chunk_index = chunk_indices[idx];
-          size_t file_data_offset =
-              header().offset_to_point_data() + chunk_table.chunk_offset(chunk_index);
-          size_t compressed_chunk_size = chunk_table.compressed_chunk_size(chunk_index);
+          const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(chunk_index);
+          size_t file_data_offset = header().offset_to_point_data() + chunk.compressed_offset;
 
-          // Read chunk data with stream mutex protection
-          std::vector<std::byte> compressed_buffer;
+          // Read chunk data straight into a pooled buffer under the stream mutex
+          std::optional<ReadBuffer> compressed_buffer;
           {
             std::lock_guard<std::mutex> lock(stream_mutex);
-            auto buf = get_bytes(file_data_offset, compressed_chunk_size);
-            compressed_buffer = {buf.data.begin(), buf.data.end()};
+            compressed_buffer.emplace(get_bytes(file_data_offset, chunk.compressed_size));
           }
 
           // Decompress without holding the lock (allows other threads to read while we decompress)
-          size_t point_offset = chunk_table.decompressed_chunk_offsets()[chunk_index] -
-                                chunk_table.decompressed_chunk_offsets()[chunk_indexes.first];
-          size_t n_points = chunk_table.points_per_chunk()[chunk_index];
+          size_t point_offset = chunk.first_point - first_point;
           if (chunk_index == 0) {
             LASPP_ASSERT_EQ(point_offset, 0u);
           }
-          m_laz_reader->decompress_chunk(std::span<const std::byte>(compressed_buffer),
-                                         output_location.subspan(point_offset, n_points));
+          m_laz_reader->decompress_chunk(compressed_buffer->data,
+                                         output_location.subspan(point_offset, chunk.n_points));
         });
       }
       return output_location.subspan(0, total_n_points);
@@ -468,40 +781,25 @@ class LASReader {
 
   // Get chunk indices that contain the given point intervals
   // Returns a sorted list of unique chunk indices.
-  // Uses binary search on the monotonically-increasing decompressed_chunk_offsets array
+  // Uses the chunk table's point-to-chunk lookup (O(1) for constant-size chunks, otherwise a
+  // binary search over the decompressed chunk offsets).
   std::vector<size_t> get_chunk_indices_from_intervals(
       const std::vector<PointInterval>& intervals) const {
     std::vector<size_t> chunk_indices;
 
     if (header().is_laz_compressed() && m_laz_reader.has_value()) {
       const auto& chunk_table = m_laz_reader->chunk_table();
-      const auto& decompressed_offsets = chunk_table.decompressed_chunk_offsets();
-      const size_t n_chunks = decompressed_offsets.size();
+      const size_t n_chunks = chunk_table.num_chunks();
 
       if (n_chunks == 0 || intervals.empty()) {
         return chunk_indices;
       }
 
       for (const auto& interval : intervals) {
-        const size_t a = static_cast<size_t>(interval.start);
-        const size_t b = static_cast<size_t>(interval.end);
-
-        // First overlapping chunk: the first chunk i where chunk_end[i] >= a.
-        // chunk_end[i] = decompressed_offsets[i+1] - 1 (for i < n_chunks-1), so
-        // chunk_end[i] >= a  <=>  decompressed_offsets[i+1] > a.
-        // Find the first position j in [begin+1, end) where offsets[j] > a;
-        // then i = j - 1 is the first chunk whose end reaches a.
-        // When j == end (a is past all offset values), first_chunk = n_chunks - 1
-        // (the last chunk, whose end extends to total_points - 1).
-        auto first_it =
-            std::upper_bound(decompressed_offsets.begin() + 1, decompressed_offsets.end(), a);
-        size_t first_chunk = static_cast<size_t>(first_it - decompressed_offsets.begin()) - 1;
-
-        // Last overlapping chunk (exclusive upper bound): the first chunk i where
-        // chunk_start[i] = decompressed_offsets[i] > b.
-        auto last_it =
-            std::upper_bound(decompressed_offsets.begin(), decompressed_offsets.end(), b);
-        size_t last_chunk_exclusive = static_cast<size_t>(last_it - decompressed_offsets.begin());
+        // Chunks from the one containing the first point through the one containing the last
+        // (points past the end map to the last chunk).
+        const size_t first_chunk = chunk_table.chunk_containing_point(interval.start);
+        const size_t last_chunk_exclusive = chunk_table.chunk_containing_point(interval.end) + 1;
 
         for (size_t i = first_chunk; i < last_chunk_exclusive; ++i) {
           chunk_indices.push_back(i);
@@ -532,14 +830,15 @@ class LASReader {
 
     if (header().is_laz_compressed()) {
       const auto& chunk_table = m_laz_reader->chunk_table();
-      const auto& points_per_chunk_vec = chunk_table.points_per_chunk();
 
-      // Pre-compute per-chunk output offsets in a single sequential pass.
+      // Pre-compute per-chunk output offsets in a single sequential pass, validating the
+      // indices once so the parallel loops below can use unchecked lookups.
       size_t total_points = 0;
       std::vector<size_t> output_offsets(chunk_indices.size());
       for (size_t i = 0; i < chunk_indices.size(); ++i) {
+        LASPP_ASSERT_LT(chunk_indices[i], chunk_table.num_chunks());
         output_offsets[i] = total_points;
-        total_points += points_per_chunk_vec[chunk_indices[i]];
+        total_points += chunk_table.points_in_chunk(chunk_indices[i]);
       }
 
       LASPP_ASSERT_GE(output_location.size(), total_points);
@@ -548,36 +847,30 @@ class LASReader {
         // Memory-mapped path: get_bytes is zero-copy and thread-safe.
         // Decompress all chunks in parallel — each call uses only local state.
         utilities::parallel_for(size_t{0}, chunk_indices.size(), [&](size_t i) {
-          const size_t chunk_idx = chunk_indices[i];
-          const size_t file_data_offset =
-              header().offset_to_point_data() + chunk_table.chunk_offset(chunk_idx);
-          auto buf = get_bytes(file_data_offset, chunk_table.compressed_chunk_size(chunk_idx));
+          const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(chunk_indices[i]);
+          auto buf = get_bytes(header().offset_to_point_data() + chunk.compressed_offset,
+                               chunk.compressed_size);
           m_laz_reader->decompress_chunk(
-              buf.data,
-              output_location.subspan(output_offsets[i], points_per_chunk_vec[chunk_idx]));
+              buf.data, output_location.subspan(output_offsets[i], chunk.n_points));
         });
       } else {
         // Stream-based path: read chunks in parallel (with mutex protection) and decompress.
         // This overlaps I/O and decompression - while one thread decompresses, others can read.
         std::mutex stream_mutex;
         utilities::parallel_for(size_t{0}, chunk_indices.size(), [&](size_t i) {
-          const size_t chunk_idx = chunk_indices[i];
-          const size_t file_data_offset =
-              header().offset_to_point_data() + chunk_table.chunk_offset(chunk_idx);
-          const size_t compressed_size = chunk_table.compressed_chunk_size(chunk_idx);
+          const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(chunk_indices[i]);
+          const size_t file_data_offset = header().offset_to_point_data() + chunk.compressed_offset;
 
-          // Read chunk data with stream mutex protection
-          std::vector<std::byte> compressed_buffer;
+          // Read chunk data straight into a pooled buffer under the stream mutex
+          std::optional<ReadBuffer> compressed_buffer;
           {
             std::lock_guard<std::mutex> lock(stream_mutex);
-            auto buf = get_bytes(file_data_offset, compressed_size);
-            compressed_buffer = {buf.data.begin(), buf.data.end()};
+            compressed_buffer.emplace(get_bytes(file_data_offset, chunk.compressed_size));
           }
 
           // Decompress without holding the lock (allows other threads to read while we decompress)
           m_laz_reader->decompress_chunk(
-              std::span<const std::byte>(compressed_buffer),
-              output_location.subspan(output_offsets[i], points_per_chunk_vec[chunk_idx]));
+              compressed_buffer->data, output_location.subspan(output_offsets[i], chunk.n_points));
         });
       }
 
@@ -589,6 +882,441 @@ class LASReader {
       return read_chunk<T>(output_location, 0);
     }
   }
+
+ private:
+  // Snapshots of the checkpoints of the chunks a read needs, held for its duration.
+  using CheckpointsInUse = std::unordered_map<size_t, std::shared_ptr<const ChunkCheckpoints>>;
+
+  // Returns the checkpoints of `chunk_indices`, building those not cached (one decode of each
+  // such chunk, in parallel), then evicts the least recently used chunks of other reads until
+  // at most m_max_point_checkpoints snapshots are cached.
+  CheckpointsInUse load_point_checkpoints(std::vector<size_t> chunk_indices) {
+    std::sort(chunk_indices.begin(), chunk_indices.end());
+    chunk_indices.erase(std::unique(chunk_indices.begin(), chunk_indices.end()),
+                        chunk_indices.end());
+    m_point_checkpoint_clock++;
+    CheckpointsInUse in_use;
+    std::vector<size_t> missing;
+    for (size_t chunk_index : chunk_indices) {
+      auto it = m_point_checkpoints.find(chunk_index);
+      if (it != m_point_checkpoints.end()) {
+        it->second.last_use = m_point_checkpoint_clock;
+        in_use.emplace(chunk_index, it->second.checkpoints);
+      } else {
+        missing.push_back(chunk_index);
+      }
+    }
+
+    const auto& chunk_table = m_laz_reader->chunk_table();
+    const size_t interval = m_point_checkpoint_interval;
+    std::vector<std::shared_ptr<ChunkCheckpoints>> built(missing.size());
+    for (size_t i = 0; i < missing.size(); i++) {
+      built[i] = std::make_shared<ChunkCheckpoints>();
+      if (!m_mapped_file.has_value()) {
+        const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(missing[i]);
+        auto buf = get_bytes(header().offset_to_point_data() + chunk.compressed_offset,
+                             chunk.compressed_size);
+        built[i]->compressed_data.assign(buf.data.begin(), buf.data.end());
+      }
+    }
+    utilities::parallel_for(size_t{0}, missing.size(), [&](size_t i) {
+      const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(missing[i]);
+      std::span<const std::byte> compressed_data =
+          m_mapped_file.has_value()
+              ? m_mapped_file->subspan(header().offset_to_point_data() + chunk.compressed_offset,
+                                       chunk.compressed_size)
+              : std::span<const std::byte>(built[i]->compressed_data);
+      LAZChunkDecoder decoder = m_laz_reader->chunk_decoder(compressed_data, chunk.n_points);
+      built[i]->decoders.reserve(chunk.n_points / interval);
+      for (size_t point = interval; point < chunk.n_points; point += interval) {
+        decoder.skip(interval);
+        built[i]->decoders.push_back(decoder);
+      }
+    });
+    for (size_t i = 0; i < missing.size(); i++) {
+      m_n_point_checkpoints += built[i]->decoders.size();
+      in_use.emplace(missing[i], built[i]);
+      m_point_checkpoints.emplace(missing[i],
+                                  CachedCheckpoints{std::move(built[i]), m_point_checkpoint_clock});
+    }
+
+    while (m_n_point_checkpoints > m_max_point_checkpoints) {
+      auto oldest = m_point_checkpoints.end();
+      for (auto it = m_point_checkpoints.begin(); it != m_point_checkpoints.end(); ++it) {
+        if (it->second.last_use < m_point_checkpoint_clock &&
+            (oldest == m_point_checkpoints.end() ||
+             it->second.last_use < oldest->second.last_use)) {
+          oldest = it;
+        }
+      }
+      if (oldest == m_point_checkpoints.end()) {
+        break;  // everything left is in use
+      }
+      m_n_point_checkpoints -= oldest->second.checkpoints->decoders.size();
+      m_point_checkpoints.erase(oldest);
+    }
+    return in_use;
+  }
+
+ public:
+  // Lets read_points_by_index() and spatial queries decode at most `interval` points per
+  // requested run instead of everything from the start of the chunk, from decoder snapshots
+  // taken every `interval` points inside each LAZ chunk. A chunk's snapshots are built the
+  // first time a read needs them, at the cost of one decode of the chunk, and kept for later
+  // reads. Every snapshot holds the adaptive entropy models of all layers (typically close to
+  // 1 MB, about the size of a whole compressed chunk), so at most `max_snapshots` are cached,
+  // evicting the least recently used chunks first; on the stream path the compressed bytes of
+  // the cached chunks are kept too. A single read may exceed the limit for the chunks it needs.
+  // No-op for uncompressed files, whose points are directly addressable.
+  void enable_point_checkpoints(size_t interval, size_t max_snapshots = 256) {
+    LASPP_ASSERT_GT(interval, 0u);
+    if (!header().is_laz_compressed()) {
+      return;
+    }
+    m_point_checkpoints.clear();
+    m_n_point_checkpoints = 0;
+    m_point_checkpoint_interval = interval;
+    m_max_point_checkpoints = max_snapshots;
+  }
+
+  bool has_point_checkpoints() const { return m_point_checkpoint_interval != 0; }
+  size_t point_checkpoint_interval() const { return m_point_checkpoint_interval; }
+  // Decoder snapshots currently cached (see enable_point_checkpoints()).
+  size_t num_cached_point_checkpoints() const { return m_n_point_checkpoints; }
+
+  // Reads the points at `indices` (any order, duplicates allowed): output_location[i] receives
+  // point indices[i]. For LAZ files the requests are sorted and grouped by chunk (and by
+  // checkpoint segment once enable_point_checkpoints() has been called), and each group is
+  // decoded once, from its nearest checkpoint, up to its last requested point. Groups are
+  // decoded in parallel.
+  template <typename T>
+  std::span<T> read_points_by_index(std::span<T> output_location,
+                                    std::span<const size_t> indices) {
+    LASPP_ASSERT_GE(output_location.size(), indices.size());
+    for (size_t index : indices) {
+      LASPP_ASSERT_LT(index, num_points());
+    }
+
+    if (!header().is_laz_compressed()) {
+      // Runs of consecutive indices are read with one call
+      for (size_t i = 0; i < indices.size();) {
+        size_t end = i + 1;
+        while (end < indices.size() && indices[end] == indices[end - 1] + 1) end++;
+        read_uncompressed_points(output_location.subspan(i, end - i), indices[i]);
+        i = end;
+      }
+      return output_location.subspan(0, indices.size());
+    }
+
+    std::vector<size_t> order(indices.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return indices[a] < indices[b]; });
+
+    // Runs of sorted requests [begin, end) that start from the same decoder
+    struct Run {
+      size_t chunk_index;
+      size_t segment;  // 0: start of chunk, k: checkpoint k - 1
+      size_t begin;
+      size_t end;
+    };
+    const auto& chunk_table = m_laz_reader->chunk_table();
+    const size_t interval = m_point_checkpoint_interval;
+    std::vector<Run> runs;
+    for (size_t k = 0; k < order.size(); k++) {
+      const size_t point = indices[order[k]];
+      const size_t chunk_index = chunk_table.chunk_containing_point(point);
+      const size_t point_in_chunk = point - chunk_table.decompressed_chunk_offset(chunk_index);
+      const size_t segment = interval == 0 ? 0 : point_in_chunk / interval;
+      if (runs.empty() || runs.back().chunk_index != chunk_index ||
+          runs.back().segment != segment) {
+        runs.push_back({chunk_index, segment, k, k + 1});
+      } else {
+        runs.back().end = k + 1;
+      }
+    }
+
+    std::vector<size_t> checkpointed_chunks;
+    for (const Run& run : runs) {
+      if (run.segment > 0) {
+        checkpointed_chunks.push_back(run.chunk_index);
+      }
+    }
+    const CheckpointsInUse checkpoints = load_point_checkpoints(checkpointed_chunks);
+
+    std::mutex stream_mutex;
+    utilities::parallel_for(size_t{0}, runs.size(), [&](size_t r) {
+      const Run& run = runs[r];
+      const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(run.chunk_index);
+      std::optional<ReadBuffer> compressed_buffer;
+      std::optional<LAZChunkDecoder> decoder;
+      if (run.segment == 0) {
+        compressed_buffer.emplace(compressed_chunk_bytes(run.chunk_index, stream_mutex));
+        decoder.emplace(m_laz_reader->chunk_decoder(compressed_buffer->data, chunk.n_points));
+      } else {
+        decoder.emplace(checkpoints.at(run.chunk_index)->decoders[run.segment - 1]);
+      }
+
+      for (size_t k = run.begin; k < run.end; k++) {
+        if (k > run.begin && indices[order[k]] == indices[order[k - 1]]) {
+          output_location[order[k]] = output_location[order[k - 1]];
+          continue;
+        }
+        decoder->skip(indices[order[k]] - chunk.first_point - decoder->next_point());
+        decoder->decode(output_location.subspan(order[k], 1));
+      }
+    });
+
+    return output_location.subspan(0, indices.size());
+  }
+
+  // Exact number of points inside `region` (a Bound2D, boundary inclusive, or a Polygon2D).
+  // With a spatial index covering every point, cells entirely inside the region are counted
+  // from the index and only points of cells straddling its boundary are decoded, and only
+  // their X/Y; otherwise every point is decoded.
+  template <typename Region>
+  uint64_t count_points(const Region& region) {
+    IndexCountPlan plan;
+    if (spatial_index_is_complete()) {
+      plan = m_spatial_index->plan_count(region, data_bounds(), index_cell_margin());
+    } else {
+      plan.boundary_intervals = all_points_intervals();
+    }
+
+    const Transform& transform = header().transform();
+    std::atomic<uint64_t> n_boundary_points_inside{0};
+    for_each_xy_batch(std::move(plan.boundary_intervals), [&](std::span<const PointXY> points) {
+      uint64_t n_inside = 0;
+      for (const PointXY& point : points) {
+        const double x = int32_to_double(point.x, transform.scale_factors().x(),
+                                         transform.offsets().x());
+        const double y = int32_to_double(point.y, transform.scale_factors().y(),
+                                         transform.offsets().y());
+        n_inside += region.contains(x, y) ? 1u : 0u;
+      }
+      n_boundary_points_inside += n_inside;
+    });
+    return plan.n_points_inside + n_boundary_points_inside;
+  }
+
+  // Point counts on an n_cols x n_rows grid over `extent` (see DensityGrid). With a spatial
+  // index covering every point, index cells lying within a single grid cell are counted from
+  // the index and only the others are decoded (X/Y only), so a grid coarser than the index
+  // cells costs little more than reading the index.
+  DensityGrid density_grid(const Bound2D& extent, size_t n_cols, size_t n_rows) {
+    DensityGrid grid(extent, n_cols, n_rows);
+    std::vector<PointInterval> boundary_intervals =
+        spatial_index_is_complete()
+            ? m_spatial_index->plan_density_grid(grid, data_bounds(), index_cell_margin())
+            : all_points_intervals();
+
+    const Transform& transform = header().transform();
+    std::mutex grid_mutex;
+    for_each_xy_batch(std::move(boundary_intervals), [&](std::span<const PointXY> points) {
+      std::vector<size_t> cells;
+      cells.reserve(points.size());
+      for (const PointXY& point : points) {
+        const double x = int32_to_double(point.x, transform.scale_factors().x(),
+                                         transform.offsets().x());
+        const double y = int32_to_double(point.y, transform.scale_factors().y(),
+                                         transform.offsets().y());
+        if (std::optional<size_t> cell = grid.cell_at(x, y)) {
+          cells.push_back(*cell);
+        }
+      }
+      std::lock_guard<std::mutex> lock(grid_mutex);
+      for (size_t cell : cells) grid.add(cell, 1);
+    });
+    return grid;
+  }
+
+  // LAZ item description of the point data; std::nullopt for uncompressed files.
+  std::optional<LAZSpecialVLRContent> laz_special_vlr() const {
+    if (!m_laz_reader.has_value()) return std::nullopt;
+    return m_laz_reader->special_vlr();
+  }
+
+  // The compressed bytes of LAZ chunk `chunk_index` as stored in the file.
+  std::vector<std::byte> read_compressed_chunk(size_t chunk_index) {
+    LASPP_ASSERT(header().is_laz_compressed(), "read_compressed_chunk requires a LAZ file");
+    std::mutex stream_mutex;
+    ReadBuffer buffer = compressed_chunk_bytes(chunk_index, stream_mutex);
+    return {buffer.data.begin(), buffer.data.end()};
+  }
+
+  // Size in bytes of each LAZ chunk as stored in the file.
+  std::vector<size_t> compressed_chunk_sizes() const {
+    LASPP_ASSERT(header().is_laz_compressed(), "compressed_chunk_sizes requires a LAZ file");
+    const auto& chunk_table = m_laz_reader->chunk_table();
+    std::vector<size_t> sizes(chunk_table.num_chunks());
+    for (size_t i = 0; i < sizes.size(); i++) {
+      sizes[i] = chunk_table.chunk(i).compressed_size;
+    }
+    return sizes;
+  }
+
+  // Decodes LAZ chunk `chunk_index` from its compressed bytes (see read_compressed_chunk).
+  // Thread-safe: touches neither the file nor any reader state.
+  template <typename T>
+  std::span<T> decompress_chunk(size_t chunk_index, std::span<const std::byte> compressed_data,
+                                std::span<T> output_location) const {
+    const size_t n_points = m_laz_reader->chunk_table().points_in_chunk(chunk_index);
+    LASPP_ASSERT_GE(output_location.size(), n_points);
+    return m_laz_reader->chunk_decoder(compressed_data, n_points)
+        .decode(output_location.subspan(0, n_points));
+  }
+
+  // Decodes only the first output_location.size() points of LAZ chunk `chunk_index`, stopping
+  // early, e.g. to sample a chunk. Thread-safe like decompress_chunk.
+  template <typename T>
+  std::span<T> decompress_chunk_prefix(size_t chunk_index,
+                                       std::span<const std::byte> compressed_data,
+                                       std::span<T> output_location) const {
+    const size_t n_points = m_laz_reader->chunk_table().points_in_chunk(chunk_index);
+    LASPP_ASSERT_LE(output_location.size(), n_points);
+    return m_laz_reader->chunk_decoder(compressed_data, n_points).decode(output_location);
+  }
+
+  // Header statistics of every chunk, computed by decoding the whole file in parallel. Worth
+  // keeping for files that are clipped or merged repeatedly (see LASWriter::clip_from_reader).
+  std::vector<ChunkSummary> chunk_summaries() {
+    std::vector<ChunkSummary> summaries(num_chunks());
+    LASPP_SWITCH_OVER_POINT_TYPE(header().point_format(), summarize_chunks,
+                                 std::span<ChunkSummary>(summaries));
+    return summaries;
+  }
+
+  // How the points of each chunk relate to `region` (a Bound2D or Polygon2D), as far as the
+  // spatial index tells: Inside or Outside when every index cell with points in the chunk is,
+  // Partial otherwise. Given `chunk_summaries` (one per chunk, see chunk_summaries()), a chunk
+  // the index leaves Partial is also classified from the bounding box of its points, which
+  // needs no spatial index. Otherwise every chunk is Partial without a spatial index covering
+  // all points.
+  template <typename Region>
+  std::vector<CellCoverage> chunk_coverage(
+      const Region& region, std::span<const ChunkSummary> chunk_summaries = {}) const {
+    LASPP_ASSERT(chunk_summaries.empty() || chunk_summaries.size() == num_chunks(),
+                 "Expected one summary per chunk");
+    std::vector<std::optional<CellCoverage>> coverage(num_chunks());
+    if (spatial_index_is_complete()) {
+      const bool is_laz = header().is_laz_compressed();
+      for (const auto& [cell_index, cell] : m_spatial_index->cells()) {
+        const CellCoverage cell_coverage = region_coverage(
+            region,
+            m_spatial_index->get_cell_extent(cell_index, data_bounds(), index_cell_margin()));
+        for (const PointInterval& interval : cell.intervals) {
+          const size_t first_chunk =
+              is_laz ? m_laz_reader->chunk_table().chunk_containing_point(interval.start) : 0;
+          const size_t last_chunk =
+              is_laz ? m_laz_reader->chunk_table().chunk_containing_point(interval.end) : 0;
+          for (size_t chunk_index = first_chunk; chunk_index <= last_chunk; chunk_index++) {
+            std::optional<CellCoverage>& chunk_coverage = coverage[chunk_index];
+            if (!chunk_coverage.has_value()) {
+              chunk_coverage = cell_coverage;
+            } else if (*chunk_coverage != cell_coverage) {
+              chunk_coverage = CellCoverage::Partial;
+            }
+          }
+        }
+      }
+    }
+    const Transform& transform = header().transform();
+    std::vector<CellCoverage> result(coverage.size());
+    for (size_t i = 0; i < coverage.size(); i++) {
+      result[i] = coverage[i].value_or(CellCoverage::Partial);
+      if (result[i] != CellCoverage::Partial || chunk_summaries.empty()) {
+        continue;
+      }
+      const ChunkSummary& summary = chunk_summaries[i];
+      if (summary.n_points == 0) {
+        result[i] = CellCoverage::Outside;
+        continue;
+      }
+      const double x0 = int32_to_double(summary.min_pos[0], transform.scale_factors().x(),
+                                        transform.offsets().x());
+      const double x1 = int32_to_double(summary.max_pos[0], transform.scale_factors().x(),
+                                        transform.offsets().x());
+      const double y0 = int32_to_double(summary.min_pos[1], transform.scale_factors().y(),
+                                        transform.offsets().y());
+      const double y1 = int32_to_double(summary.max_pos[1], transform.scale_factors().y(),
+                                        transform.offsets().y());
+      result[i] = region_coverage(region, Bound2D(std::min(x0, x1), std::min(y0, y1),
+                                                  std::max(x0, x1), std::max(y0, y1)));
+    }
+    return result;
+  }
+
+  // Sorted, disjoint intervals of the points that may lie in `region` (a Bound2D or Polygon2D):
+  // those of the spatial index cells not entirely outside it, or every point without a spatial
+  // index covering all points. Points in the intervals still need to be tested.
+  template <typename Region>
+  std::vector<PointInterval> candidate_intervals(const Region& region) const {
+    if (!spatial_index_is_complete()) {
+      return all_points_intervals();
+    }
+    std::vector<PointInterval> intervals;
+    for (const auto& [cell_index, cell] : m_spatial_index->cells()) {
+      const Bound2D extent =
+          m_spatial_index->get_cell_extent(cell_index, data_bounds(), index_cell_margin());
+      if (region_coverage(region, extent) != CellCoverage::Outside) {
+        intervals.insert(intervals.end(), cell.intervals.begin(), cell.intervals.end());
+      }
+    }
+    std::sort(intervals.begin(), intervals.end(),
+              [](const PointInterval& a, const PointInterval& b) { return a.start < b.start; });
+    std::vector<PointInterval> merged;
+    for (const PointInterval& interval : intervals) {
+      if (!merged.empty() && interval.start <= merged.back().end + 1) {
+        merged.back().end = std::max(merged.back().end, interval.end);
+      } else {
+        merged.push_back(interval);
+      }
+    }
+    return merged;
+  }
+
+  // Zero-copy view of every point record of an uncompressed, memory-mapped file whose record
+  // layout is exactly PointType (e.g. LASPointFormat1 for point format 1 without extra bytes).
+  // std::nullopt otherwise; read_chunks() works in every case. The view is valid for the
+  // lifetime of the reader and costs no memory beyond the page cache.
+  template <typename PointType>
+  std::optional<std::span<const PointType>> mapped_points() const {
+    static_assert(alignof(PointType) == 1, "Point records are only byte aligned");
+    if constexpr (requires { PointType::PointFormat; }) {
+      if (m_mapped_file.has_value() && !header().is_laz_compressed() &&
+          PointType::PointFormat == (header().point_format() & 0x7F) &&
+          sizeof(PointType) == header().point_data_record_length()) {
+        const std::span<const std::byte> records = m_mapped_file->subspan(
+            header().offset_to_point_data(), num_points() * sizeof(PointType));
+        return std::span<const PointType>(reinterpret_cast<const PointType*>(records.data()),
+                                          num_points());
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Zero-copy view of the PointType part of every point record of an uncompressed,
+  // memory-mapped file, where PointType is the file's point format or one of its parts
+  // (e.g. LASPointFormat0, GPSTime or ColorData for point format 3). Extra bytes are skipped.
+  // std::nullopt if the file is compressed, not memory mapped or has no such part.
+  template <typename PointType>
+  std::optional<StridedPointView<PointType>> mapped_point_view() const {
+    if (!m_mapped_file.has_value() || header().is_laz_compressed()) {
+      return std::nullopt;
+    }
+    const std::optional<size_t> part_offset = [&]() -> std::optional<size_t> {
+      LASPP_SWITCH_OVER_POINT_TYPE_RETURN(header().point_format(),
+                                          RecordPart<PointType>::template offset);
+    }();
+    if (!part_offset.has_value()) {
+      return std::nullopt;
+    }
+    const size_t record_length = header().point_data_record_length();
+    const std::span<const std::byte> records =
+        m_mapped_file->subspan(header().offset_to_point_data(), num_points() * record_length);
+    return StridedPointView<PointType>(records.data() + *part_offset, num_points(),
+                                       record_length);
+  }
 };
 
 }  // namespace laspp
@@ -0,0 +1,386 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "laz/laz_reader.hpp"
+#include "laz/laz_vlr.hpp"
+#include "laz/point14_encoder.hpp"
+#include "laz/rgb14_encoder.hpp"
+#include "laz/rgbnir14_encoder.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/cancellation.hpp"
+#include "utilities/default_init_allocator.hpp"
+#include "utilities/memory_budget.hpp"
+#include "utilities/thread_pool.hpp"
+#include "vlr.hpp"
+
+namespace laspp {
+
+// Reads a LAS or LAZ file front to back from a stream that cannot seek, such as a pipe fed by a
+// decompressor or a network download. The header and VLRs are parsed as they arrive. The LAZ
+// chunk table is at the end of the file, so chunks are delimited as they are read instead:
+// layered chunks (point formats 6 and up) by the sizes in their own headers, pointwise chunks
+// by decoding them. EVLRs become available once the point data has been read.
+class LASStreamReader {
+ public:
+  template <typename Record>
+  struct RecordWithData {
+    Record header;
+    std::vector<std::byte> data;
+  };
+
+  LASStreamReader(const LASStreamReader&) = delete;
+  LASStreamReader& operator=(const LASStreamReader&) = delete;
+  LASStreamReader(LASStreamReader&&) = delete;
+  LASStreamReader& operator=(LASStreamReader&&) = delete;
+
+ private:
+  std::istream& m_stream;
+  uint64_t m_position = 0;              // bytes of the file consumed so far
+  std::vector<std::byte> m_read_ahead;  // bytes read from m_stream beyond m_position
+  size_t m_read_ahead_begin = 0;
+  bool m_end_of_stream = false;
+
+  LASHeader m_header;
+  std::optional<LAZReader> m_laz_reader;
+  size_t m_layered_seed_bytes = 0;
+  size_t m_layered_n_layers = 0;
+  std::vector<RecordWithData<LASVLR>> m_vlrs;
+  std::vector<RecordWithData<LASEVLR>> m_evlrs;
+  size_t m_points_read = 0;
+  bool m_read_point_data = false;
+
+  size_t buffered() const { return m_read_ahead.size() - m_read_ahead_begin; }
+  std::span<const std::byte> peek() const {
+    return std::span<const std::byte>(m_read_ahead).subspan(m_read_ahead_begin);
+  }
+
+  // Reads from the stream until at least `n` bytes are buffered, or the stream ends.
+  void fill(size_t n) {
+    if (buffered() >= n || m_end_of_stream) {
+      return;
+    }
+    m_read_ahead.erase(m_read_ahead.begin(),
+                       m_read_ahead.begin() + static_cast<std::ptrdiff_t>(m_read_ahead_begin));
+    m_read_ahead_begin = 0;
+    const size_t n_buffered = m_read_ahead.size();
+    m_read_ahead.resize(n);
+    m_stream.read(reinterpret_cast<char*>(m_read_ahead.data() + n_buffered),
+                  static_cast<std::streamsize>(n - n_buffered));
+    const size_t n_read = static_cast<size_t>(m_stream.gcount());
+    m_read_ahead.resize(n_buffered + n_read);
+    m_end_of_stream = n_buffered + n_read < n;
+  }
+
+  void consume(size_t n) {
+    LASPP_ASSERT_LE(n, buffered());
+    m_read_ahead_begin += n;
+    m_position += n;
+  }
+
+  void read_bytes(void* destination, size_t n) {
+    fill(n);
+    LASPP_ASSERT_GE(buffered(), n, "Unexpected end of stream at byte ", m_position);
+    std::memcpy(destination, peek().data(), n);
+    consume(n);
+  }
+
+  std::vector<std::byte> read_vector(size_t n) {
+    std::vector<std::byte> bytes(n);
+    read_bytes(bytes.data(), n);
+    return bytes;
+  }
+
+  void skip_to(uint64_t position) {
+    LASPP_ASSERT_GE(position, m_position, "Cannot seek backwards in a stream");
+    while (m_position < position) {
+      const size_t n = static_cast<size_t>(std::min<uint64_t>(position - m_position, 1 << 20));
+      fill(n);
+      LASPP_ASSERT_GE(buffered(), n, "Unexpected end of stream at byte ", m_position);
+      consume(n);
+    }
+  }
+
+  template <typename Part, typename PointType, typename T>
+  static void copy_part(const PointType& record, T& point) {
+    if constexpr (std::is_base_of_v<Part, PointType>) {
+      copy_from_if_possible(point, static_cast<const Part&>(record));
+    }
+  }
+
+  template <typename PointType, typename T>
+  void convert_records(std::span<const std::byte> records, std::span<T> points) {
+    const size_t record_length = m_header.point_data_record_length();
+    for (size_t i = 0; i < points.size(); i++) {
+      const auto& record = *reinterpret_cast<const PointType*>(records.data() + i * record_length);
+      if constexpr (std::is_same_v<PointType, T>) {
+        points[i] = record;
+      } else {
+        copy_part<LASPointFormat0>(record, points[i]);
+        copy_part<LASPointFormat6>(record, points[i]);
+        copy_part<GPSTime>(record, points[i]);
+        copy_part<ColorData>(record, points[i]);
+        copy_part<NIRData>(record, points[i]);
+        copy_part<WavePacketData>(record, points[i]);
+      }
+    }
+  }
+
+  template <typename T, typename Function>
+  void read_uncompressed_points(Function& f) {
+    constexpr size_t batch_points = 65536;
+    const size_t record_length = m_header.point_data_record_length();
+    utilities::UninitializedVector<std::byte> records;
+    utilities::UninitializedVector<T> points;
+    while (m_points_read < num_points()) {
+      const size_t n_points = std::min(batch_points, num_points() - m_points_read);
+      records.resize(n_points * record_length);
+      read_bytes(records.data(), records.size());
+      points.resize(n_points);
+      LASPP_SWITCH_OVER_POINT_TYPE(m_header.point_format(), convert_records,
+                                   std::span<const std::byte>(records), std::span<T>(points));
+      m_points_read += n_points;
+      f(std::span<T>(points));
+    }
+  }
+
+  // A layered chunk starts with its seed point, its point count and the size of each layer, so
+  // it can be read whole before decoding.
+  std::vector<std::byte> read_layered_chunk(size_t& n_points) {
+    const size_t prefix_bytes = m_layered_seed_bytes + sizeof(uint32_t) * (1 + m_layered_n_layers);
+    fill(prefix_bytes);
+    LASPP_ASSERT_GE(buffered(), prefix_bytes, "Unexpected end of stream in LAZ chunk at byte ",
+                    m_position);
+    const std::byte* prefix = peek().data() + m_layered_seed_bytes;
+    uint32_t chunk_points;
+    std::memcpy(&chunk_points, prefix, sizeof(chunk_points));
+    size_t chunk_bytes = prefix_bytes;
+    for (size_t k = 0; k < m_layered_n_layers; k++) {
+      uint32_t layer_bytes;
+      std::memcpy(&layer_bytes, prefix + sizeof(uint32_t) * (1 + k), sizeof(layer_bytes));
+      chunk_bytes += layer_bytes;
+    }
+    n_points = chunk_points;
+    return read_vector(chunk_bytes);
+  }
+
+  // Batches of layered chunks are decoded in parallel while the next batch is read from the
+  // stream on another thread.
+  template <typename T, typename Function>
+  void read_layered_chunks(Function& f) {
+    struct ChunkBatch {
+      std::vector<std::vector<std::byte>> chunks;
+      std::vector<size_t> offsets{0};  // of each chunk's points within the batch
+    };
+    const size_t max_batch_chunks = 4 * utilities::get_num_threads();
+    size_t points_framed = m_points_read;
+    auto read_batch = utilities::with_current_cancellation([this, max_batch_chunks,
+                                                            &points_framed]() {
+      ChunkBatch batch;
+      while (batch.chunks.size() < max_batch_chunks && points_framed < num_points()) {
+        size_t n_points;
+        batch.chunks.push_back(read_layered_chunk(n_points));
+        LASPP_ASSERT_GT(n_points, 0);
+        LASPP_ASSERT_LE(n_points, num_points() - points_framed, "LAZ chunk beyond point count");
+        points_framed += n_points;
+        batch.offsets.push_back(batch.offsets.back() + n_points);
+      }
+      return batch;
+    });
+
+    utilities::UninitializedVector<T> points;
+    std::future<ChunkBatch> next_batch = std::async(std::launch::async, read_batch);
+    while (true) {
+      ChunkBatch batch = next_batch.get();
+      if (batch.chunks.empty()) {
+        break;
+      }
+      next_batch = std::async(std::launch::async, read_batch);
+      points.resize(batch.offsets.back());
+      utilities::parallel_for(size_t{0}, batch.chunks.size(), [&](size_t i) {
+        const size_t n_points = batch.offsets[i + 1] - batch.offsets[i];
+        m_laz_reader->chunk_decoder(batch.chunks[i], n_points)
+            .decode(std::span<T>(points).subspan(batch.offsets[i], n_points));
+      });
+      m_points_read += points.size();
+      f(std::span<T>(points));
+    }
+  }
+
+  // Pointwise chunks carry no size, so each is decoded from the bytes read ahead and ends where
+  // its decoder stopped reading. Decoding restarts with more bytes when it runs past them.
+  template <typename T, typename Function>
+  void read_pointwise_chunks(Function& f) {
+    const uint32_t chunk_size = m_laz_reader->special_vlr().chunk_size;
+    LASPP_ASSERT_NE(chunk_size, std::numeric_limits<uint32_t>::max(),
+                    "Variable-size pointwise LAZ chunks cannot be read without the chunk table");
+    utilities::UninitializedVector<T> points;
+    size_t previous_chunk_bytes = 0;
+    while (m_points_read < num_points()) {
+      const size_t n_points = std::min<size_t>(chunk_size, num_points() - m_points_read);
+      points.resize(n_points);
+      size_t read_ahead_bytes = previous_chunk_bytes > 0
+                                    ? 2 * previous_chunk_bytes + 4096
+                                    : n_points * m_header.point_data_record_length() + 4096;
+      while (true) {
+        fill(read_ahead_bytes);
+        const std::span<const std::byte> data = peek();
+        std::optional<size_t> chunk_bytes;
+        try {
+          LAZChunkDecoder decoder = m_laz_reader->chunk_decoder(data, n_points);
+          decoder.decode(std::span<T>(points));
+          chunk_bytes = decoder.bytes_consumed();
+        } catch (const utilities::OperationCancelled&) {
+          throw;
+        } catch (const utilities::MemoryBudgetExceeded&) {
+          throw;
+        } catch (const std::exception&) {
+          // Decoding zeros past the data read so far may fail; only an error with the whole
+          // rest of the stream at hand is genuine.
+          if (m_end_of_stream) {
+            throw;
+          }
+        }
+        if (chunk_bytes.has_value() && chunk_bytes.value() <= data.size()) {
+          consume(chunk_bytes.value());
+          previous_chunk_bytes = chunk_bytes.value();
+          break;
+        }
+        LASPP_ASSERT(!m_end_of_stream, "Unexpected end of stream in LAZ chunk at byte ",
+                     m_position);
+        read_ahead_bytes *= 2;
+      }
+      m_points_read += n_points;
+      f(std::span<T>(points));
+    }
+  }
+
+  void read_evlrs() {
+    if (m_header.EVLR_count() == 0 || m_header.EVLR_offset() < m_position) {
+      return;
+    }
+    skip_to(m_header.EVLR_offset());
+    for (size_t i = 0; i < m_header.EVLR_count(); i++) {
+      RecordWithData<LASEVLR> evlr;
+      read_bytes(&evlr.header, sizeof(LASEVLR));
+      evlr.data = read_vector(evlr.header.record_length_after_header);
+      m_evlrs.push_back(std::move(evlr));
+    }
+  }
+
+ public:
+  explicit LASStreamReader(std::istream& stream) : m_stream(stream) {
+    // LASHeader reads the 1.4 layout in full, which for older files runs on into the VLRs, so
+    // it parses a zero-padded copy of the first bytes rather than the stream itself.
+    fill(sizeof(LASHeader14Packed));
+    std::string header_bytes(sizeof(LASHeader14Packed), '\0');
+    std::memcpy(header_bytes.data(), peek().data(), std::min(buffered(), header_bytes.size()));
+    std::istringstream header_stream(header_bytes);
+    m_header = LASHeader(header_stream);
+    consume(m_header.size());
+
+    for (size_t i = 0; i < m_header.VLR_count(); i++) {
+      RecordWithData<LASVLR> vlr;
+      read_bytes(&vlr.header, sizeof(LASVLR));
+      vlr.data = read_vector(vlr.header.record_length_after_header);
+      if (vlr.header.is_laz_vlr()) {
+        std::istringstream laz_vlr_stream(
+            std::string(reinterpret_cast<const char*>(vlr.data.data()), vlr.data.size()));
+        m_laz_reader.emplace(LAZSpecialVLRContent(laz_vlr_stream));
+      }
+      m_vlrs.push_back(std::move(vlr));
+    }
+    skip_to(m_header.offset_to_point_data());
+
+    if (m_header.is_laz_compressed()) {
+      LASPP_ASSERT(m_laz_reader.has_value(), "LASStreamReader: LAZ point format without LAZ VLR");
+      int64_t chunk_table_offset;  // out of reach until the end of the stream; not needed
+      read_bytes(&chunk_table_offset, sizeof(chunk_table_offset));
+      if (m_laz_reader->special_vlr().compressor == LAZCompressor::LayeredChunked) {
+        for (LAZItemRecord record : m_laz_reader->special_vlr().items_records) {
+          switch (record.item_type) {
+            case LAZItemType::Point14:
+              m_layered_seed_bytes += sizeof(LASPointFormat6);
+              m_layered_n_layers += LASPointFormat6EncoderV4::NUM_LAYERS;
+              break;
+            case LAZItemType::RGB14:
+              m_layered_seed_bytes += sizeof(ColorData);
+              m_layered_n_layers += RGB14Encoder::NUM_LAYERS;
+              break;
+            case LAZItemType::RGBNIR14:
+              m_layered_seed_bytes += sizeof(ColorData) + sizeof(uint16_t);
+              m_layered_n_layers += RGBNIR14Encoder::NUM_LAYERS;
+              break;
+            case LAZItemType::Byte14:
+              m_layered_seed_bytes += record.item_size;
+              m_layered_n_layers += record.item_size;
+              break;
+            default: {
+              const LAZItemType item_type = record.item_type;  // not bound by reference (packed)
+              LASPP_FAIL("Unsupported LAZ item type for layered compression: ", item_type);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  const LASHeader& header() const { return m_header; }
+  size_t num_points() const { return m_header.num_points(); }
+  size_t points_read() const { return m_points_read; }
+
+  const std::vector<RecordWithData<LASVLR>>& vlrs() const { return m_vlrs; }
+  // Empty until read_points() has returned, as EVLRs follow the point data.
+  const std::vector<RecordWithData<LASEVLR>>& evlrs() const { return m_evlrs; }
+
+  std::optional<std::string> wkt() const {
+    std::optional<std::string> math_wkt;
+    for (const RecordWithData<LASVLR>& vlr : m_vlrs) {
+      if (vlr.header.is_ogc_coordinate_system_wkt() && !vlr.data.empty()) {
+        return std::string(reinterpret_cast<const char*>(vlr.data.data()), vlr.data.size() - 1);
+      }
+      if (vlr.header.is_ogc_math_transform_wkt()) {
+        math_wkt.emplace(reinterpret_cast<const char*>(vlr.data.data()), vlr.data.size());
+      }
+    }
+    return math_wkt;
+  }
+
+  // Reads all point data in file order, calling `f(std::span<T>)` with each consecutive run of
+  // points (a batch of records or of LAZ chunks); the span is only valid during the call. Reads
+  // the EVLRs after the last point. Can only be called once.
+  template <typename T, typename Function>
+  void read_points(Function&& f) {
+    LASPP_ASSERT(!m_read_point_data, "LASStreamReader can only read the point data once");
+    m_read_point_data = true;
+    if (!m_laz_reader.has_value()) {
+      read_uncompressed_points<T>(f);
+    } else if (m_laz_reader->special_vlr().compressor == LAZCompressor::LayeredChunked) {
+      read_layered_chunks<T>(f);
+    } else {
+      read_pointwise_chunks<T>(f);
+    }
+    read_evlrs();
+  }
+};
+
+}  // namespace laspp
@@ -6,11 +6,19 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
 #include <numeric>
 #include <span>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -22,6 +30,9 @@
 #include "laz/laz_writer.hpp"
 #include "spatial_index.hpp"
 #include "utilities/assert.hpp"
+#include "utilities/cancellation.hpp"
+#include "utilities/default_init_allocator.hpp"
+#include "utilities/memory_budget.hpp"
 #include "utilities/thread_pool.hpp"
 #include "vlr.hpp"
 
@@ -50,6 +61,17 @@ inline std::ostream& operator<<(std::ostream& os, WritingStage stage) {
   return os;
 }
 
+// The state of a LASWriter part-way through its points, from LASWriter::checkpoint(). A new
+// LASWriter constructed from it continues the file as if it had never stopped, provided the
+// output was truncated to `end_offset` (anything the old writer wrote later is overwritten).
+struct LASWriterCheckpoint {
+  LASHeader header;  // with the counts and bounds of the points written so far
+  int64_t laz_vlr_offset = -1;
+  uint64_t end_offset = 0;  // end of the points written so far
+  std::vector<uint32_t> points_per_chunk;
+  std::vector<uint32_t> compressed_chunk_sizes;
+};
+
 class LASWriter {
  public:
   LASWriter(const LASWriter&) = delete;
@@ -66,6 +88,8 @@ class LASWriter {
   std::optional<LAZWriter> m_laz_writer;
   bool m_written_chunktable = false;
   int64_t m_laz_vlr_offset = -1;
+  size_t m_vlr_padding = 0;
+  int m_uncaught_exceptions = std::uncaught_exceptions();
 
   void write_header() {
     m_output_stream.seekp(0);
@@ -81,9 +105,51 @@ class LASWriter {
     header().write(m_output_stream);
   }
 
+  // Resumes writing points into `ofs` from `checkpoint`; see LASWriterCheckpoint.
+  LASWriter(std::iostream& ofs, const LASWriterCheckpoint& checkpoint)
+      : m_output_stream(ofs), m_header(checkpoint.header), m_stage(WritingStage::POINTS) {
+    if (m_header.is_laz_compressed()) {
+      LASPP_ASSERT_GE(checkpoint.laz_vlr_offset, 0);
+      m_laz_vlr_offset = checkpoint.laz_vlr_offset;
+      LASPP_CHECK_SEEK(m_output_stream, m_laz_vlr_offset + static_cast<int64_t>(sizeof(LASVLR)),
+                       std::ios::beg);
+      LAZSpecialVLRContent laz_vlr_content(m_output_stream);
+      m_output_stream.seekp(static_cast<std::streamoff>(checkpoint.end_offset));
+      m_laz_writer.emplace(m_output_stream, std::move(laz_vlr_content),
+                           static_cast<int64_t>(m_header.offset_to_point_data()),
+                           std::span<const uint32_t>(checkpoint.points_per_chunk),
+                           std::span<const uint32_t>(checkpoint.compressed_chunk_sizes));
+    } else {
+      m_output_stream.seekp(static_cast<std::streamoff>(checkpoint.end_offset));
+    }
+    LASPP_ASSERT(m_output_stream.good(), "Failed to seek to the checkpoint");
+  }
+
   const LASHeader& header() const { return m_header; }
   LASHeader& header() { return m_header; }
 
+  // Flushes the points written so far and returns what is needed to continue writing them after
+  // the process dies. Only valid between writes of points, with no chunks held back. Flushing
+  // only hands the points to the operating system; to survive a crash of the machine, sync the
+  // file (see utilities::sync_file) before saving the checkpoint.
+  LASWriterCheckpoint checkpoint() {
+    LASPP_ASSERT_EQ(m_stage, WritingStage::POINTS, "checkpoint() needs points to be written");
+    m_output_stream.flush();
+    LASPP_ASSERT(m_output_stream.good(), "Failed to flush the output");
+    LASWriterCheckpoint checkpoint{m_header, m_laz_vlr_offset,
+                                   static_cast<uint64_t>(m_output_stream.tellp()), {}, {}};
+    if (m_laz_writer.has_value()) {
+      LASPP_ASSERT_EQ(m_laz_writer->num_held_chunks(), 0u);
+      const LAZChunkTable& chunk_table = m_laz_writer->chunk_table();
+      for (size_t i = 0; i < chunk_table.num_chunks(); i++) {
+        const LAZChunkTable::ChunkLocation chunk = chunk_table.chunk(i);
+        checkpoint.points_per_chunk.push_back(chunk.n_points);
+        checkpoint.compressed_chunk_sizes.push_back(chunk.compressed_size);
+      }
+    }
+    return checkpoint;
+  }
+
   // Copy header metadata from another header (preserves writer-managed fields)
   void copy_header_metadata(const LASHeader& source_header) {
     m_header.m_file_source_id = source_header.m_file_source_id;
@@ -97,6 +163,31 @@ class LASWriter {
     m_header.transform() = source_header.transform();
   }
 
+  // Copies the header metadata and VLRs of `reader`, except its LAZ VLR (compression follows
+  // this file's point format) and, with `drop_spatial_index`, its LAStools spatial index, whose
+  // point indices no longer hold once points are filtered or reordered. The EVLRs follow the
+  // points, see copy_evlrs_from.
+  void copy_metadata_from(LASReader& reader, bool drop_spatial_index) {
+    copy_header_metadata(reader.header());
+    for (const auto& vlr : reader.vlr_headers()) {
+      if (vlr.is_laz_vlr() || (drop_spatial_index && vlr.is_lastools_spatial_index_vlr())) {
+        continue;
+      }
+      write_vlr(vlr, reader.read_vlr_data(vlr));
+    }
+  }
+
+  // Copies the EVLRs of `reader` after the points, with or without its spatial index as for
+  // copy_metadata_from.
+  void copy_evlrs_from(LASReader& reader, bool drop_spatial_index) {
+    for (const auto& evlr : reader.evlr_headers()) {
+      if (drop_spatial_index && evlr.is_lastools_spatial_index_evlr()) {
+        continue;
+      }
+      write_evlr(evlr, reader.read_evlr_data(evlr));
+    }
+  }
+
   void write_vlr(const LASVLR& vlr, std::span<const std::byte> data) {
     LASPP_ASSERT_EQ(m_stage, WritingStage::VLRS);
     LASPP_ASSERT_EQ(vlr.record_length_after_header, data.size());
@@ -108,6 +199,15 @@ class LASWriter {
         static_cast<uint32_t>(sizeof(LASVLR) + vlr.record_length_after_header);
   }
 
+  // Reserves `n_bytes` of zeroed space after the VLRs, counted in offset_to_point_data, so that
+  // LASMetadataEditor can later add or grow VLRs in place without moving the point data.
+  void reserve_vlr_padding(size_t n_bytes) {
+    LASPP_ASSERT_EQ(m_stage, WritingStage::VLRS);
+    LASPP_ASSERT_LE(n_bytes, std::numeric_limits<uint32_t>::max() - header().offset_to_point_data(),
+                    "VLR padding does not fit in the header's 32-bit offset to the point data");
+    m_vlr_padding = n_bytes;
+  }
+
   void write_wkt(const std::string& wkt, bool math_transform_wkt = false) {
     LASVLR wkt_vlr;
     wkt_vlr.reserved = 0;
@@ -130,8 +230,77 @@ class LASWriter {
     }
   }
 
-  template <typename PointType, typename T>
-  void t_write_points(const std::span<const T>& points, std::optional<size_t> chunk_size) {
+  // Writes the padding requested by reserve_vlr_padding() once the last VLR is written.
+  void write_vlr_padding() {
+    LASPP_ASSERT_LE(m_vlr_padding,
+                    std::numeric_limits<uint32_t>::max() - header().offset_to_point_data(),
+                    "VLR padding does not fit in the header's 32-bit offset to the point data");
+    const std::vector<char> zeros(m_vlr_padding, 0);
+    m_output_stream.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+    header().m_offset_to_point_data += static_cast<uint32_t>(m_vlr_padding);
+    m_vlr_padding = 0;
+  }
+
+  // Writes the LAZ VLR describing the point data and starts the compressed point stream.
+  void write_laz_vlr(LAZSpecialVLRContent laz_vlr_content) {
+    std::stringstream laz_vlr_content_stream;
+    laz_vlr_content.write_to(laz_vlr_content_stream);
+    std::vector<char> laz_vlr_content_char(
+        (std::istreambuf_iterator<char>(laz_vlr_content_stream)),
+        std::istreambuf_iterator<char>());
+    std::vector<std::byte> laz_vlr_content_bytes;
+    laz_vlr_content_bytes.reserve(laz_vlr_content_char.size());
+    for (char c : laz_vlr_content_char) {
+      laz_vlr_content_bytes.push_back(static_cast<std::byte>(c));
+    }
+
+    LASVLR laz_vlr;
+    laz_vlr.reserved = 0xAABB;
+    string_to_arr("laszip encoded", laz_vlr.user_id);
+    laz_vlr.record_id = 22204;
+    laz_vlr.record_length_after_header = static_cast<uint16_t>(laz_vlr_content_bytes.size());
+    string_to_arr("LAZ VLR", laz_vlr.description);
+
+    m_laz_vlr_offset = m_output_stream.tellp();
+    write_vlr(laz_vlr, laz_vlr_content_bytes);
+    write_vlr_padding();
+
+    LASPP_ASSERT_EQ(m_header.offset_to_point_data(), m_output_stream.tellp());
+
+    m_laz_writer.emplace(m_output_stream, std::move(laz_vlr_content));
+  }
+
+  // Accounts points written to the file in the header's counts and bounds.
+  void add_to_header(const ChunkSummary& summary) {
+    header().m_number_of_point_records += summary.n_points;
+    for (size_t i = 0; i < 15; i++) {
+      header().m_number_of_points_by_return[i] += summary.points_by_return[i];
+    }
+    if (header().m_number_of_point_records < std::numeric_limits<uint32_t>::max() &&
+        (header().point_format() < 6 ||
+         (header().point_format() >= 128 && header().point_format() < 128 + 6))) {
+      header().m_legacy_number_of_point_records =
+          static_cast<uint32_t>(header().m_number_of_point_records);
+      for (int i = 0; i < 5; i++) {
+        header().m_legacy_number_of_points_by_return[i] =
+            static_cast<uint32_t>(header().m_number_of_points_by_return[i]);
+      }
+    } else {
+      header().m_legacy_number_of_point_records = 0;
+      for (int i = 0; i < 5; i++) {
+        header().m_legacy_number_of_points_by_return[i] = 0;
+      }
+    }
+
+    if (summary.n_points > 0) {
+      header().update_bounds(summary.min_pos);
+      header().update_bounds(summary.max_pos);
+    }
+  }
+
+  // Moves to the point data stage, writing the LAZ VLR for PointType first if needed.
+  template <typename PointType>
+  void begin_point_data() {
     LASPP_ASSERT_EQ(sizeof(PointType), m_header.point_data_record_length());
     LASPP_ASSERT_LE(m_stage, WritingStage::POINTS);
     if (m_header.is_laz_compressed()) {
@@ -175,145 +344,58 @@ class LASWriter {
                 LAZItemRecord(LAZItemType::Byte, m_header.num_extra_bytes()));
           }
         }
-        std::stringstream laz_vlr_content_stream;
-        laz_vlr_content.write_to(laz_vlr_content_stream);
-        std::vector<char> laz_vlr_content_char(
-            (std::istreambuf_iterator<char>(laz_vlr_content_stream)),
-            std::istreambuf_iterator<char>());
-        std::vector<std::byte> laz_vlr_content_bytes;
-        laz_vlr_content_bytes.reserve(laz_vlr_content_char.size());
-        for (char c : laz_vlr_content_char) {
-          laz_vlr_content_bytes.push_back(static_cast<std::byte>(c));
-        }
-
-        LASVLR laz_vlr;
-        laz_vlr.reserved = 0xAABB;
-        string_to_arr("laszip encoded", laz_vlr.user_id);
-        laz_vlr.record_id = 22204;
-        laz_vlr.record_length_after_header = static_cast<uint16_t>(laz_vlr_content_bytes.size());
-        string_to_arr("LAZ VLR", laz_vlr.description);
-
-        m_laz_vlr_offset = m_output_stream.tellp();
-        write_vlr(laz_vlr, laz_vlr_content_bytes);
-
-        LASPP_ASSERT_EQ(m_header.offset_to_point_data(), m_output_stream.tellp());
-
-        m_laz_writer.emplace(m_output_stream, std::move(laz_vlr_content));
+        write_laz_vlr(std::move(laz_vlr_content));
       } else {
         LASPP_ASSERT(m_laz_writer.has_value());
       }
+    } else if (m_stage < WritingStage::POINTS) {
+      write_vlr_padding();
     }
     m_stage = WritingStage::POINTS;
+  }
 
-    std::vector<PointType> points_to_write(points.size());
-    memset(points_to_write.data(), 0, points_to_write.size() * sizeof(PointType));
+  template <typename PointType, typename T>
+  static void serialise_point(PointType& record, const T& point) {
+    std::memset(&record, 0, sizeof(PointType));  // fields `T` does not provide
+    copy_if_possible<LASPointFormat0>(record, point);
+    copy_if_possible<LASPointFormat6>(record, point);
+    copy_if_possible<GPSTime>(record, point);
+    copy_if_possible<ColorData>(record, point);
+    copy_if_possible<NIRData>(record, point);
+    copy_if_possible<WavePacketData>(record, point);
+  }
 
-    size_t points_by_return[15] = {0};
-    int32_t min_pos[3] = {std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(),
-                          std::numeric_limits<int32_t>::max()};
-    int32_t max_pos[3] = {std::numeric_limits<int32_t>::lowest(),
-                          std::numeric_limits<int32_t>::lowest(),
-                          std::numeric_limits<int32_t>::lowest()};
+  template <typename PointType, typename T>
+  void t_write_points(const std::span<const T>& points, std::optional<size_t> chunk_size) {
+    begin_point_data<PointType>();
+
+    utilities::MemoryReservation points_reservation(utilities::get_memory_budget(),
+                                                    points.size() * sizeof(PointType),
+                                                    "LASWriter::write_points serialisation buffer");
+    // Left uninitialised here: each worker zeroes and fills its own records below, so pages
+    // are first touched in parallel.
+    utilities::UninitializedVector<PointType> points_to_write(points.size());
 
     static_assert(is_copy_assignable<LASPointFormat0, ExampleFullLASPoint>());
     static_assert(is_copy_fromable<GPSTime, ExampleFullLASPoint>());
 
     // Parallel copy from user point type into the serialisable PointType buffer.
-    utilities::parallel_for(size_t{0}, points.size(), [&](size_t i) {
-      copy_if_possible<LASPointFormat0>(points_to_write[i], points[i]);
-      copy_if_possible<LASPointFormat6>(points_to_write[i], points[i]);
-      copy_if_possible<GPSTime>(points_to_write[i], points[i]);
-      copy_if_possible<ColorData>(points_to_write[i], points[i]);
-      copy_if_possible<NIRData>(points_to_write[i], points[i]);
-      copy_if_possible<WavePacketData>(points_to_write[i], points[i]);
-    });
+    utilities::parallel_for(size_t{0}, points.size(),
+                            [&](size_t i) { serialise_point(points_to_write[i], points[i]); });
 
     // Parallel reduction to accumulate per-return counts and bounding box.
-    if constexpr (std::is_base_of_v<LASPointFormat0, PointType> ||
-                  std::is_base_of_v<LASPointFormat6, PointType>) {
-      struct PointStats {
-        size_t points_by_return[15]{};
-        int32_t min_pos[3]{std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(),
-                           std::numeric_limits<int32_t>::max()};
-        int32_t max_pos[3]{std::numeric_limits<int32_t>::lowest(),
-                           std::numeric_limits<int32_t>::lowest(),
-                           std::numeric_limits<int32_t>::lowest()};
-
-        void combine(const PointStats& other) {
-          for (size_t j = 0; j < 15; j++) {
-            points_by_return[j] += other.points_by_return[j];
-          }
-          for (size_t j = 0; j < 3; j++) {
-            min_pos[j] = std::min(min_pos[j], other.min_pos[j]);
-            max_pos[j] = std::max(max_pos[j], other.max_pos[j]);
+    ChunkSummary summary;
+    // Use chunking internally: process 1000 points per chunk for better cache locality
+    constexpr size_t reduction_chunk_size = 1000;
+    const size_t num_chunks = (points.size() + reduction_chunk_size - 1) / reduction_chunk_size;
+    utilities::parallel_for_reduction(
+        size_t{0}, num_chunks, summary, [&](size_t chunk_idx, ChunkSummary& local_summary) {
+          const size_t chunk_start = chunk_idx * reduction_chunk_size;
+          const size_t chunk_end = std::min(chunk_start + reduction_chunk_size, points.size());
+          for (size_t i = chunk_start; i < chunk_end; ++i) {
+            local_summary.add(points_to_write[i]);
           }
-        }
-      };
-
-      PointStats result;
-      // Use chunking internally: process 1000 points per chunk for better cache locality
-      constexpr size_t reduction_chunk_size = 1000;
-      const size_t num_chunks = (points.size() + reduction_chunk_size - 1) / reduction_chunk_size;
-      utilities::parallel_for_reduction(
-          size_t{0}, num_chunks, result, [&](size_t chunk_idx, PointStats& local_stats) {
-            // Process all points in this chunk
-            const size_t chunk_start = chunk_idx * reduction_chunk_size;
-            const size_t chunk_end = std::min(chunk_start + reduction_chunk_size, points.size());
-            for (size_t i = chunk_start; i < chunk_end; ++i) {
-              // Accumulate stats for this point
-              if constexpr (std::is_base_of_v<LASPointFormat0, PointType>) {
-                if (points_to_write[i].bit_byte.return_number < 16 &&
-                    points_to_write[i].bit_byte.return_number > 0) {
-                  local_stats.points_by_return[points_to_write[i].bit_byte.return_number - 1]++;
-                }
-              } else if constexpr (std::is_base_of_v<LASPointFormat6, PointType>) {
-                if (points_to_write[i].return_number < 16 && points_to_write[i].return_number > 0) {
-                  local_stats.points_by_return[points_to_write[i].return_number - 1]++;
-                }
-              }
-              // Read x, y, z using memcpy to avoid alignment issues with packed structures
-              int32_t x, y, z;
-              std::memcpy(&x, &points_to_write[i].x, sizeof(x));
-              std::memcpy(&y, &points_to_write[i].y, sizeof(y));
-              std::memcpy(&z, &points_to_write[i].z, sizeof(z));
-              local_stats.min_pos[0] = std::min(local_stats.min_pos[0], x);
-              local_stats.min_pos[1] = std::min(local_stats.min_pos[1], y);
-              local_stats.min_pos[2] = std::min(local_stats.min_pos[2], z);
-              local_stats.max_pos[0] = std::max(local_stats.max_pos[0], x);
-              local_stats.max_pos[1] = std::max(local_stats.max_pos[1], y);
-              local_stats.max_pos[2] = std::max(local_stats.max_pos[2], z);
-            }
-          });
-
-      for (size_t j = 0; j < 15; j++) points_by_return[j] = result.points_by_return[j];
-      for (size_t j = 0; j < 3; j++) {
-        min_pos[j] = result.min_pos[j];
-        max_pos[j] = result.max_pos[j];
-      }
-    }
-
-    header().m_number_of_point_records += points.size();
-    for (int i = 0; i < 15; i++) {
-      header().m_number_of_points_by_return[i] += points_by_return[i];
-    }
-    if (header().m_number_of_point_records < std::numeric_limits<uint32_t>::max() &&
-        (header().point_format() < 6 ||
-         (header().point_format() >= 128 && header().point_format() < 128 + 6))) {
-      header().m_legacy_number_of_point_records =
-          static_cast<uint32_t>(header().m_number_of_point_records);
-      for (int i = 0; i < 5; i++) {
-        header().m_legacy_number_of_points_by_return[i] =
-            static_cast<uint32_t>(header().m_number_of_points_by_return[i]);
-      }
-    } else {
-      header().m_legacy_number_of_point_records = 0;
-      for (int i = 0; i < 5; i++) {
-        header().m_legacy_number_of_points_by_return[i] = 0;
-      }
-    }
-
-    header().update_bounds(std::array<int32_t, 3>{{min_pos[0], min_pos[1], min_pos[2]}});
-    header().update_bounds(std::array<int32_t, 3>{{max_pos[0], max_pos[1], max_pos[2]}});
+        });
 
     if (m_header.is_laz_compressed()) {
       if (chunk_size.has_value()) {
@@ -331,6 +413,8 @@ class LASWriter {
       m_output_stream.write(reinterpret_cast<const char*>(points_to_write.data()),
                             static_cast<int64_t>(points_to_write.size() * sizeof(PointType)));
     }
+    // Counted once written, so that the header never covers chunks of a failed write
+    add_to_header(summary);
   }
 
  public:
@@ -344,17 +428,87 @@ class LASWriter {
     }
   }
 
+  // One chunk of points serialised in the file's point format (and compressed for LAZ output)
+  // by encode_chunk(), waiting to be written by write_encoded_chunk().
+  struct EncodedChunk {
+    ChunkSummary summary;
+    std::string data;
+  };
+
+  // Moves to the point data stage, as the first write_points() would. Needed before
+  // encode_chunk().
+  void begin_points() { LASPP_SWITCH_OVER_POINT_TYPE(header().point_format(), begin_point_data); }
+
+  // Thread-safe: serialises and compresses `points` as one chunk without writing anything, so
+  // that several threads may encode chunks at once. The work runs on the calling thread only.
+  template <typename T>
+  EncodedChunk encode_chunk(std::span<const T> points) {
+    if constexpr (std::is_base_of_v<LASPointFormat0, T> || std::is_base_of_v<LASPointFormat6, T>) {
+      return t_encode_chunk<T>(points);
+    } else {
+      LASPP_SWITCH_OVER_POINT_TYPE_RETURN(header().point_format(), t_encode_chunk, points);
+    }
+  }
+
+  // Writes a chunk from encode_chunk() as the next chunk of the file and counts it in the
+  // header. Not thread-safe: callers encoding concurrently hand their chunks over in order.
+  void write_encoded_chunk(const EncodedChunk& chunk) {
+    LASPP_ASSERT_EQ(m_stage, WritingStage::POINTS, "begin_points() was not called");
+    if (m_header.is_laz_compressed()) {
+      m_laz_writer->write_compressed_chunk(static_cast<uint32_t>(chunk.summary.n_points),
+                                           chunk.data);
+    } else {
+      m_output_stream.write(chunk.data.data(), static_cast<std::streamsize>(chunk.data.size()));
+    }
+    add_to_header(chunk.summary);
+  }
+
  private:
+  template <typename PointType, typename T>
+  EncodedChunk t_encode_chunk(std::span<const T> points) {
+    LASPP_ASSERT_EQ(sizeof(PointType), m_header.point_data_record_length());
+    LASPP_ASSERT_EQ(m_stage, WritingStage::POINTS, "begin_points() was not called");
+    LASPP_ASSERT_GT(points.size(), 0);
+    LASPP_ASSERT_LT(points.size(), std::numeric_limits<uint32_t>::max());
+
+    utilities::MemoryReservation records_reservation(
+        utilities::get_memory_budget(), points.size() * sizeof(PointType),
+        "LASWriter::encode_chunk serialisation buffer");
+    utilities::UninitializedVector<PointType> records(points.size());
+    EncodedChunk chunk;
+    for (size_t i = 0; i < points.size(); i++) {
+      serialise_point(records[i], points[i]);
+      chunk.summary.add(records[i]);
+    }
+    if (m_header.is_laz_compressed()) {
+      chunk.data = m_laz_writer->compress_chunk(std::span<PointType>(records)).str();
+    } else {
+      chunk.data.assign(reinterpret_cast<const char*>(records.data()),
+                        records.size() * sizeof(PointType));
+    }
+    return chunk;
+  }
+
+  void write_file_end() {
+    if (m_stage == WritingStage::VLRS) {
+      write_vlr_padding();
+    }
+    write_chunktable();
+    write_header();
+  }
+
   void write_chunktable() {
     if (header().is_laz_compressed() && !m_written_chunktable) {
       LASPP_ASSERT_LE(m_stage, WritingStage::CHUNKTABLE);
       LASPP_ASSERT_GE(m_laz_vlr_offset, 0);
       m_stage = WritingStage::CHUNKTABLE;
+      m_laz_writer->finish();
+      const std::streampos end = m_output_stream.tellp();
       LAZSpecialVLRContent laz_vlr_content(m_laz_writer->special_vlr());
       m_laz_writer.reset();
       m_output_stream.seekp(m_laz_vlr_offset + static_cast<int64_t>(sizeof(LASVLR)));
       laz_vlr_content.write_to(m_output_stream);
-      m_output_stream.seekp(0, std::ios::end);
+      m_output_stream.seekp(end);
       header().m_start_of_first_extended_variable_length_record =
           static_cast<size_t>(m_output_stream.tellp());
       m_written_chunktable = true;
@@ -363,6 +517,9 @@ class LASWriter {
 
  public:
   void write_evlr(const LASEVLR& evlr, const std::span<const std::byte>& data) {
+    if (m_stage == WritingStage::VLRS) {
+      write_vlr_padding();
+    }
     write_chunktable();
     LASPP_ASSERT_LE(m_stage, WritingStage::EVLRS);
     if (m_stage < WritingStage::EVLRS) {
@@ -407,7 +564,17 @@ class LASWriter {
       if (ppc.empty()) return;
 
       const size_t n_chunks = reader.num_chunks();
-      const size_t batch_size = 20 * utilities::get_num_threads();
+
+      // Shrink the batch under memory pressure. Each batched point is held in one of the two
+      // batch buffers and in write_points' serialisation copy, and at least one chunk must fit
+      // in the LAZ writer.
+      const size_t max_chunk_pts = *std::max_element(ppc.begin(), ppc.end());
+      const size_t bytes_per_chunk = std::max<size_t>(1, max_chunk_pts * sizeof(PointType));
+      utilities::MemoryBudget& budget = utilities::get_memory_budget();
+      size_t batch_size = 20 * utilities::get_num_threads();
+      while (batch_size > 1 && (3 * batch_size + 2) * bytes_per_chunk > budget.available()) {
+        batch_size /= 2;
+      }
 
       // Compute the exact maximum point count across all batches so the buffer
       // is neither over- nor under-allocated (matters for single-chunk non-LAZ
@@ -419,17 +586,63 @@ class LASWriter {
         max_batch_pts = std::max(max_batch_pts, pts);
       }
 
-      std::vector<PointType> batch_buf(max_batch_pts);
-      for (size_t b = 0; b < n_chunks; b += batch_size) {
-        auto pts =
-            reader.read_chunks<PointType>(batch_buf, {b, std::min(b + batch_size, n_chunks)});
-        write_points<PointType>(pts);
+      // Double buffering: while one batch is compressed and written, the next one is decoded
+      // into the other buffer on a separate thread (both stages share the thread pool).
+      const size_t n_buffers = n_chunks > batch_size ? 2 : 1;
+      utilities::MemoryReservation batch_reservation(
+          budget, n_buffers * max_batch_pts * sizeof(PointType),
+          "LASWriter::copy_from_reader batch buffers");
+      using BatchBuffer = utilities::UninitializedVector<PointType>;
+      std::array<BatchBuffer, 2> batch_bufs;
+      for (size_t i = 0; i < n_buffers; i++) {
+        batch_bufs[i].resize(max_batch_pts);
+      }
+      auto read_batch = utilities::with_current_cancellation(
+          [&reader, batch_size, n_chunks](size_t b, BatchBuffer& buf) {
+            return reader.read_chunks<PointType>(buf, {b, std::min(b + batch_size, n_chunks)});
+          });
+
+      std::future<std::span<PointType>> next_batch =
+          std::async(std::launch::async, read_batch, size_t{0}, std::ref(batch_bufs[0]));
+      for (size_t b = 0, slot = 0; b < n_chunks; b += batch_size, slot ^= 1) {
+        std::span<PointType> pts = next_batch.get();
+        if (b + batch_size < n_chunks) {
+          next_batch = std::async(std::launch::async, read_batch, b + batch_size,
+                                  std::ref(batch_bufs[slot ^ 1]));
+        }
+        if (!reader.header().is_laz_compressed()) {
+          write_points<PointType>(pts, 50000);
+          continue;
+        }
+        // Keep the source chunking, passing each run of equal chunks (the last may be shorter)
+        // to write_points at once so that its chunks are compressed in parallel
+        const size_t batch_end = std::min(b + batch_size, n_chunks);
+        size_t offset = 0;
+        for (size_t i = b; i < batch_end;) {
+          const size_t chunk_points = ppc[i];
+          size_t run_points = 0;
+          for (; i < batch_end && ppc[i] == chunk_points; i++) {
+            run_points += ppc[i];
+          }
+          if (i < batch_end && ppc[i] < chunk_points) {
+            run_points += ppc[i++];
+          }
+          if (run_points > 0) {
+            write_points<PointType>(pts.subspan(offset, run_points), chunk_points);
+            offset += run_points;
+          }
+        }
       }
       return;
     }
 
-    // Spatial-index path: reordering requires the full point set in memory.
-    std::vector<PointType> points(reader.num_points());
+    // Spatial-index path: reordering requires the full point set in memory (twice, plus the
+    // cell/index pairs used for sorting).
+    utilities::MemoryReservation full_file_reservation(
+        utilities::get_memory_budget(),
+        reader.num_points() * (2 * sizeof(PointType) + sizeof(std::pair<int32_t, size_t>)),
+        "LASWriter::copy_from_reader with spatial index (full point set)");
+    utilities::UninitializedVector<PointType> points(reader.num_points());
     reader.read_chunks<PointType>(points, {0, reader.num_chunks()});
 
     double scale_x = reader.header().transform().scale_factors().x();
@@ -456,7 +669,7 @@ class LASWriter {
     // Sort by cell index, then by original index
     std::sort(point_cell_pairs.begin(), point_cell_pairs.end());
 
-    std::vector<PointType> reordered_points;
+    utilities::UninitializedVector<PointType> reordered_points;
     reordered_points.reserve(points.size());
     for (const auto& pair : point_cell_pairs) {
       reordered_points.push_back(points[pair.second]);
@@ -469,41 +682,408 @@ class LASWriter {
     write_lastools_spatial_index(spatial_index);
   }
 
+  template <typename PointType, typename Region>
+  void clip_points(LASReader& reader, const Region& region,
+                   std::span<const ChunkSummary> chunk_summaries) {
+    const size_t n_chunks = reader.num_chunks();
+    LASPP_ASSERT(chunk_summaries.empty() || chunk_summaries.size() == n_chunks,
+                 "Expected one summary per chunk of the input");
+    const std::vector<CellCoverage> coverage = reader.chunk_coverage(region, chunk_summaries);
+
+    // Compressed chunks can be copied verbatim when the output uses the input's LAZ items
+    const bool pass_through = header().is_laz_compressed() &&
+                              reader.header().is_laz_compressed() &&
+                              m_stage < WritingStage::POINTS;
+    if (pass_through) {
+      LASPP_ASSERT_EQ(sizeof(PointType), m_header.point_data_record_length());
+      write_laz_vlr(reader.laz_special_vlr().value());
+      m_stage = WritingStage::POINTS;
+    } else {
+      begin_point_data<PointType>();
+    }
+
+    const Transform& transform = reader.header().transform();
+    auto keep_inside = [&](std::span<PointType> points) {
+      size_t n_kept = 0;
+      for (const PointType& point : points) {
+        int32_t x_raw;
+        int32_t y_raw;
+        std::memcpy(&x_raw, &point.x, sizeof(x_raw));
+        std::memcpy(&y_raw, &point.y, sizeof(y_raw));
+        const double x =
+            int32_to_double(x_raw, transform.scale_factors().x(), transform.offsets().x());
+        const double y =
+            int32_to_double(y_raw, transform.scale_factors().y(), transform.offsets().y());
+        if (region.contains(x, y)) {
+          points[n_kept++] = point;
+        }
+      }
+      return points.subspan(0, n_kept);
+    };
+
+    // Batches of chunks are processed in parallel and written in order. Each chunk of a batch
+    // may hold its decoded points and its compressed bytes.
+    const std::vector<size_t> ppc = reader.points_per_chunk();
+    const size_t max_chunk_pts = ppc.empty() ? 0 : *std::max_element(ppc.begin(), ppc.end());
+    const size_t bytes_per_chunk = std::max<size_t>(1, 2 * max_chunk_pts * sizeof(PointType));
+    utilities::MemoryBudget& budget = utilities::get_memory_budget();
+    size_t batch_size = 4 * utilities::get_num_threads();
+    while (batch_size > 1 && batch_size * bytes_per_chunk > budget.available()) {
+      batch_size /= 2;
+    }
+    utilities::MemoryReservation batch_reservation(
+        budget, std::min(batch_size, n_chunks) * bytes_per_chunk,
+        "LASWriter::clip_from_reader chunk batch");
+
+    struct ClippedChunk {
+      utilities::UninitializedVector<PointType> points;
+      std::span<PointType> kept;
+      std::vector<std::byte> compressed;  // input chunk, copied verbatim when fully inside
+      std::string recompressed;           // surviving points of a boundary chunk
+      ChunkSummary summary;
+    };
+    for (size_t b = 0; b < n_chunks; b += batch_size) {
+      const size_t batch_end = std::min(b + batch_size, n_chunks);
+      if (pass_through) {
+        std::vector<ClippedChunk> clipped(batch_end - b);
+        for (size_t i = b; i < batch_end; i++) {
+          if (coverage[i] != CellCoverage::Outside) {
+            clipped[i - b].compressed = reader.read_compressed_chunk(i);
+          }
+        }
+        utilities::parallel_for(b, batch_end, [&](size_t i) {
+          ClippedChunk& chunk = clipped[i - b];
+          if (coverage[i] == CellCoverage::Outside) {
+            return;
+          }
+          if (coverage[i] == CellCoverage::Inside && !chunk_summaries.empty()) {
+            chunk.summary = chunk_summaries[i];
+            return;
+          }
+          chunk.points.resize(ppc[i]);
+          reader.decompress_chunk(i, chunk.compressed, std::span<PointType>(chunk.points));
+          if (coverage[i] == CellCoverage::Inside) {
+            for (const PointType& point : chunk.points) chunk.summary.add(point);
+            return;
+          }
+          chunk.compressed.clear();
+          chunk.kept = keep_inside(std::span<PointType>(chunk.points));
+          for (const PointType& point : chunk.kept) chunk.summary.add(point);
+          if (!chunk.kept.empty()) {
+            chunk.recompressed = m_laz_writer->compress_chunk(chunk.kept).str();
+          }
+        });
+        for (ClippedChunk& chunk : clipped) {
+          if (chunk.summary.n_points == 0) {
+            continue;
+          }
+          const std::string_view bytes =
+              chunk.compressed.empty()
+                  ? std::string_view(chunk.recompressed)
+                  : std::string_view(reinterpret_cast<const char*>(chunk.compressed.data()),
+                                     chunk.compressed.size());
+          LASPP_ASSERT_LT(chunk.summary.n_points, std::numeric_limits<uint32_t>::max());
+          m_laz_writer->write_compressed_chunk(static_cast<uint32_t>(chunk.summary.n_points),
+                                               bytes);
+          add_to_header(chunk.summary);
+        }
+      } else {
+        std::vector<size_t> chunk_indices;
+        for (size_t i = b; i < batch_end; i++) {
+          if (coverage[i] != CellCoverage::Outside) {
+            chunk_indices.push_back(i);
+          }
+        }
+        // read_chunks_list decodes in parallel into one buffer; split it back per chunk
+        size_t n_batch_points = 0;
+        for (size_t i : chunk_indices) n_batch_points += ppc[i];
+        utilities::UninitializedVector<PointType> batch_points(n_batch_points);
+        reader.read_chunks_list(std::span<PointType>(batch_points), chunk_indices);
+        // Filter each boundary chunk, packing the surviving points to the front of the buffer,
+        // and write the batch at once so that its output chunks are encoded in parallel
+        size_t offset = 0;
+        size_t n_kept = 0;
+        for (size_t i : chunk_indices) {
+          std::span<PointType> points(batch_points.data() + offset, ppc[i]);
+          offset += ppc[i];
+          if (coverage[i] != CellCoverage::Inside) {
+            points = keep_inside(points);
+          }
+          if (points.data() != batch_points.data() + n_kept) {
+            std::copy(points.begin(), points.end(), batch_points.data() + n_kept);
+          }
+          n_kept += points.size();
+        }
+        if (n_kept > 0) {
+          write_points<PointType>(std::span<const PointType>(batch_points.data(), n_kept),
+                                  reader.header().is_laz_compressed() ? max_chunk_pts : 50000);
+        }
+      }
+    }
+  }
+
+  // Replaces the header's point counts and bounds by those of `source`, for output holding
+  // exactly the source's points.
+  void copy_point_statistics(const LASHeader& source) {
+    header().m_number_of_point_records = source.m_number_of_point_records;
+    header().m_legacy_number_of_point_records = source.m_legacy_number_of_point_records;
+    std::copy(std::begin(source.m_number_of_points_by_return),
+              std::end(source.m_number_of_points_by_return),
+              std::begin(header().m_number_of_points_by_return));
+    std::copy(std::begin(source.m_legacy_number_of_points_by_return),
+              std::end(source.m_legacy_number_of_points_by_return),
+              std::begin(header().m_legacy_number_of_points_by_return));
+    header().m_bounds = source.m_bounds;
+  }
+
+  // Adds the point counts and bounds of `source`, which uses this file's transform, for output
+  // that appends the source's points.
+  void add_point_statistics(const LASHeader& source) {
+    ChunkSummary summary;
+    summary.n_points = source.num_points();
+    const std::array<size_t, 15> by_return = source.num_points_by_return();
+    std::copy(by_return.begin(), by_return.end(), summary.points_by_return.begin());
+    const Bound3D& bounds = source.bounds();
+    const std::array<double, 3> min = {bounds.min_x(), bounds.min_y(), bounds.min_z()};
+    const std::array<double, 3> max = {bounds.max_x(), bounds.max_y(), bounds.max_z()};
+    const Transform& transform = header().transform();
+    for (size_t j = 0; j < 3; j++) {
+      const double scale = transform.scale_factors()[j];
+      const double offset = transform.offsets()[j];
+      summary.min_pos[j] = static_cast<int32_t>(std::llround((min[j] - offset) / scale));
+      summary.max_pos[j] = static_cast<int32_t>(std::llround((max[j] - offset) / scale));
+    }
+    add_to_header(summary);
+  }
+
+  template <typename PointType>
+  void rechunk_points(LASReader& reader, size_t target_chunk_points,
+                      std::optional<size_t> max_chunk_bytes) {
+    LASPP_ASSERT_EQ(sizeof(PointType), m_header.point_data_record_length());
+    LASPP_ASSERT_LT(m_stage, WritingStage::POINTS);
+    write_laz_vlr(reader.laz_special_vlr().value());
+    m_stage = WritingStage::POINTS;
+
+    const size_t n_chunks = reader.num_chunks();
+    const std::vector<size_t> ppc = reader.points_per_chunk();
+    const std::vector<size_t> chunk_bytes = reader.compressed_chunk_sizes();
+    auto oversized = [&](size_t i) {
+      return ppc[i] > target_chunk_points ||
+             (max_chunk_bytes.has_value() && chunk_bytes[i] > max_chunk_bytes.value());
+    };
+    // Points per re-encoded chunk, assuming the pieces compress like the chunk they come from
+    auto piece_points = [&](size_t i) {
+      size_t n_points = target_chunk_points;
+      if (max_chunk_bytes.has_value() && chunk_bytes[i] > max_chunk_bytes.value()) {
+        const size_t n_by_bytes = static_cast<size_t>(
+            static_cast<double>(ppc[i]) * static_cast<double>(max_chunk_bytes.value()) /
+            static_cast<double>(chunk_bytes[i]));
+        n_points = std::min(n_points, std::max<size_t>(n_by_bytes, 1));
+      }
+      return n_points;
+    };
+
+    struct RechunkedChunk {
+      std::vector<std::byte> compressed;  // copied verbatim unless the chunk is split
+      utilities::UninitializedVector<PointType> points;
+      size_t piece_points = 0;
+      std::vector<std::string> pieces;
+    };
+    utilities::MemoryBudget& budget = utilities::get_memory_budget();
+    const size_t max_batch_chunks = 4 * utilities::get_num_threads();
+    for (size_t b = 0; b < n_chunks;) {
+      // A batch takes consecutive chunks while they fit the budget, counting the decoded points
+      // and the re-encoded pieces of the chunks to split; a batch holds at least one chunk.
+      size_t batch_end = b;
+      size_t batch_bytes = 0;
+      while (batch_end < n_chunks && batch_end - b < max_batch_chunks) {
+        const size_t bytes =
+            chunk_bytes[batch_end] +
+            (oversized(batch_end) ? 2 * ppc[batch_end] * sizeof(PointType) : 0);
+        if (batch_end > b && batch_bytes + bytes > budget.available()) {
+          break;
+        }
+        batch_bytes += bytes;
+        batch_end++;
+      }
+      utilities::MemoryReservation batch_reservation(budget, batch_bytes,
+                                                     "LASWriter::rechunk_from_reader chunk batch");
+
+      std::vector<RechunkedChunk> chunks(batch_end - b);
+      std::vector<size_t> to_split;
+      for (size_t i = b; i < batch_end; i++) {
+        chunks[i - b].compressed = reader.read_compressed_chunk(i);
+        if (oversized(i)) {
+          to_split.push_back(i);
+        }
+      }
+
+      // Decode the chunks to split, then encode all of their pieces, each stage in parallel
+      std::vector<std::pair<size_t, size_t>> pieces;  // (chunk, piece) pairs
+      for (size_t i : to_split) {
+        RechunkedChunk& chunk = chunks[i - b];
+        chunk.piece_points = piece_points(i);
+        const size_t n_pieces = (ppc[i] + chunk.piece_points - 1) / chunk.piece_points;
+        chunk.pieces.resize(n_pieces);
+        for (size_t k = 0; k < n_pieces; k++) pieces.emplace_back(i - b, k);
+      }
+      utilities::parallel_for(size_t{0}, to_split.size(), [&](size_t k) {
+        const size_t i = to_split[k];
+        RechunkedChunk& chunk = chunks[i - b];
+        chunk.points.resize(ppc[i]);
+        reader.decompress_chunk(i, chunk.compressed, std::span<PointType>(chunk.points));
+        chunk.compressed = {};
+      });
+      utilities::parallel_for(size_t{0}, pieces.size(), [&](size_t p) {
+        RechunkedChunk& chunk = chunks[pieces[p].first];
+        const size_t start = pieces[p].second * chunk.piece_points;
+        const size_t n_points = std::min(chunk.piece_points, chunk.points.size() - start);
+        chunk.pieces[pieces[p].second] =
+            m_laz_writer
+                ->compress_chunk(std::span<PointType>(chunk.points).subspan(start, n_points))
+                .str();
+      });
+
+      for (size_t i = b; i < batch_end; i++) {
+        const RechunkedChunk& chunk = chunks[i - b];
+        if (chunk.pieces.empty()) {
+          m_laz_writer->write_compressed_chunk(
+              static_cast<uint32_t>(ppc[i]),
+              std::string_view(reinterpret_cast<const char*>(chunk.compressed.data()),
+                               chunk.compressed.size()));
+          continue;
+        }
+        for (size_t k = 0; k < chunk.pieces.size(); k++) {
+          const size_t n_points =
+              std::min(chunk.piece_points, ppc[i] - k * chunk.piece_points);
+          m_laz_writer->write_compressed_chunk(static_cast<uint32_t>(n_points), chunk.pieces[k]);
+        }
+      }
+      b = batch_end;
+    }
+  }
+
  public:
-  // Copy all data from a reader to this writer
-  void copy_from_reader(LASReader& reader, bool add_spatial_index = false) {
-    // Copy header metadata (preserves writer-managed fields)
-    copy_header_metadata(reader.header());
+  // Copies the points of `reader` that lie inside `region` (a Bound2D or Polygon2D), with its
+  // VLRs and EVLRs except any spatial index, whose point indices would no longer hold. Chunks
+  // that the reader's spatial index places entirely outside the region are skipped, and only
+  // chunks straddling its boundary are decoded, filtered and re-encoded, in parallel. When both
+  // files are LAZ, chunks entirely inside are copied compressed; the header statistics they
+  // contribute come from `chunk_summaries` (one per input chunk, see
+  // LASReader::chunk_summaries) when given, and otherwise from decoding them.
+  template <typename Region>
+  void clip_from_reader(LASReader& reader, const Region& region,
+                        std::span<const ChunkSummary> chunk_summaries = {}) {
+    copy_metadata_from(reader, true);
+    LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(), clip_points, reader, region,
+                                 chunk_summaries);
+    copy_evlrs_from(reader, true);
+  }
 
-    // Copy VLRs (skip LAZ VLR since compression is handled by point format;
-    // skip existing LAStools spatial index VLR when we're building a new one)
-    for (const auto& vlr : reader.vlr_headers()) {
-      if (vlr.is_laz_vlr()) {
-        continue;
+  // Copies a LAZ file re-chunked for parallel reading. Chunks of more than
+  // `target_chunk_points` points, or of more than `max_chunk_bytes` compressed bytes when given,
+  // are decoded and re-encoded in parallel as chunks within both limits (the byte limit is
+  // met by estimate, from the size per point of the original chunk); all other chunks are
+  // copied compressed. Point order is unchanged, so VLRs and EVLRs (including any
+  // spatial index) are copied as they are. The output must use the input's point format.
+  void rechunk_from_reader(LASReader& reader, size_t target_chunk_points = 50000,
+                           std::optional<size_t> max_chunk_bytes = std::nullopt) {
+    LASPP_ASSERT(reader.header().is_laz_compressed() && header().is_laz_compressed(),
+                 "rechunk_from_reader requires LAZ input and output");
+    LASPP_ASSERT_EQ(reader.header().point_format(), header().point_format());
+    LASPP_ASSERT_EQ(reader.header().point_data_record_length(),
+                    header().point_data_record_length());
+    LASPP_ASSERT_GT(target_chunk_points, 0);
+    LASPP_ASSERT_LT(target_chunk_points, std::numeric_limits<uint32_t>::max());
+    copy_metadata_from(reader, false);
+    LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(), rechunk_points, reader,
+                                 target_chunk_points, max_chunk_bytes);
+    copy_point_statistics(reader.header());
+    copy_evlrs_from(reader, false);
+  }
+
+  // Concatenates LAZ files holding consecutive point ranges of one source (see plan_partitions)
+  // into this LAZ file without re-encoding: compressed chunks are copied in order and the header
+  // statistics are combined from the parts' headers. Header metadata, VLRs and EVLRs come from
+  // the first part, except any spatial index. The parts must share this file's point format and
+  // the first part's LAZ item records and transform.
+  void merge_from_readers(std::span<LASReader* const> parts) {
+    LASPP_ASSERT(!parts.empty(), "merge_from_readers needs at least one part");
+    LASPP_ASSERT(header().is_laz_compressed(), "merge_from_readers requires LAZ output");
+    LASReader& first = *parts.front();
+    for (LASReader* part : parts) {
+      LASPP_ASSERT(part->laz_special_vlr().has_value(), "merge_from_readers requires LAZ parts");
+    }
+    const LAZSpecialVLRContent first_vlr = first.laz_special_vlr().value();
+    for (LASReader* part : parts) {
+      LASPP_ASSERT_EQ(part->header().point_format(), header().point_format());
+      LASPP_ASSERT_EQ(part->header().point_data_record_length(),
+                      header().point_data_record_length());
+      LASPP_ASSERT_EQ(part->header().transform().scale_factors(),
+                      first.header().transform().scale_factors());
+      LASPP_ASSERT_EQ(part->header().transform().offsets(), first.header().transform().offsets());
+      const LAZSpecialVLRContent vlr = part->laz_special_vlr().value();
+      LASPP_ASSERT(vlr.compressor == first_vlr.compressor &&
+                       vlr.items_records.size() == first_vlr.items_records.size(),
+                   "Parts use different LAZ item records");
+      for (size_t i = 0; i < vlr.items_records.size(); i++) {
+        LASPP_ASSERT(vlr.items_records[i].item_type == first_vlr.items_records[i].item_type &&
+                         vlr.items_records[i].item_size == first_vlr.items_records[i].item_size &&
+                         vlr.items_records[i].item_version ==
+                             first_vlr.items_records[i].item_version,
+                     "Parts use different LAZ item records");
       }
-      if (add_spatial_index && vlr.is_lastools_spatial_index_vlr()) {
-        continue;  // Skip existing spatial index, we'll write a new one
+    }
+
+    copy_metadata_from(first, true);
+    LASPP_ASSERT_LT(m_stage, WritingStage::POINTS);
+    write_laz_vlr(first_vlr);
+    m_stage = WritingStage::POINTS;
+    for (LASReader* part : parts) {
+      const std::vector<size_t> points_per_chunk = part->points_per_chunk();
+      for (size_t c = 0; c < points_per_chunk.size(); c++) {
+        utilities::check_cancellation();
+        const std::vector<std::byte> compressed = part->read_compressed_chunk(c);
+        m_laz_writer->write_compressed_chunk(
+            static_cast<uint32_t>(points_per_chunk[c]),
+            std::string_view(reinterpret_cast<const char*>(compressed.data()), compressed.size()));
       }
-      write_vlr(vlr, reader.read_vlr_data(vlr));
+      add_point_statistics(part->header());
     }
+    copy_evlrs_from(first, true);
+  }
+
+  // Copy all data from a reader to this writer
+  void copy_from_reader(LASReader& reader, bool add_spatial_index = false) {
+    // Copy header metadata and VLRs, skipping any existing spatial index when we're building a
+    // new one
+    copy_metadata_from(reader, add_spatial_index);
 
     // Read and write points (with optional spatial index)
     LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(), copy_points_with_spatial_index,
                                  reader, add_spatial_index);
 
-    // Copy EVLRs (skip spatial index EVLR if we're adding a new one)
-    for (const auto& evlr : reader.evlr_headers()) {
-      if (add_spatial_index && evlr.is_lastools_spatial_index_evlr()) {
-        continue;  // Skip existing spatial index, we'll write a new one
-      }
-      auto data = reader.read_evlr_data(evlr);
-      write_evlr(evlr, data);
-    }
+    copy_evlrs_from(reader, add_spatial_index);
   }
 
   ~LASWriter() {
-    write_chunktable();
-    write_header();
+    if (std::uncaught_exceptions() > m_uncaught_exceptions) {
+      // Unwinding from a failed or cancelled write (e.g. OperationCancelled): finalise the
+      // points the header counts, i.e. those of the writes that completed, dropping any chunks
+      // of the failed one. The stream is not shrunk, so bytes of dropped chunks may remain
+      // after the chunk table, unreferenced by the header. A failure to finalise (e.g. of a LAZ
+      // file that never got to its point data) leaves the output invalid rather than masking
+      // the original error.
+      try {
+        if (m_laz_writer.has_value()) {
+          m_laz_writer->truncate(header().num_points());
+        }
+        write_file_end();
+      } catch (...) {
+      }
+      return;
+    }
+    write_file_end();
   }
 };
 
@@ -5,8 +5,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <limits>
+#include <utility>
 #include <vector>
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -22,6 +25,7 @@
 #include "utilities/assert.hpp"
 #include "utilities/macros.hpp"
 #include "utilities/printing.hpp"
+#include "utilities/thread_pool.hpp"
 
 namespace laspp {
 
@@ -40,14 +44,75 @@ struct LASPP_PACKED LAZChunkTableHeader {
 
 #pragma pack(pop)
 
+// Chunk sizes are stored as 32-bit values and offsets as 64-bit prefix sums. Tables with a
+// constant chunk size (the common case) keep no per-chunk point counts or point offsets at all:
+// both follow from the chunk index. That is 12 bytes per chunk, or 24 for variable-size tables.
 class LAZChunkTable : LAZChunkTableHeader {
   std::vector<uint32_t> m_compressed_chunk_size;
+  std::vector<uint64_t> m_compressed_chunk_offsets;
   std::optional<uint32_t> m_constant_chunk_size;
-  std::vector<size_t> m_n_points_per_chunk;
-  std::vector<size_t> m_compressed_chunk_offsets;
-  std::vector<size_t> m_decompressed_chunk_offsets;
+  uint32_t m_last_chunk_n_points = 0;  // constant-size tables only
+  // Variable-size tables only (empty while m_constant_chunk_size is set)
+  std::vector<uint32_t> m_n_points_per_chunk;
+  std::vector<uint64_t> m_decompressed_chunk_offsets;
+
+  static constexpr uint64_t FIRST_CHUNK_OFFSET = 8;  // after the chunk table offset
+
+  // Exclusive prefix sums of `values` starting at `initial`. Large tables are summed block-wise
+  // on the thread pool (block totals, a serial pass over the blocks, then a fill per block).
+  static std::vector<uint64_t> prefix_sums(const std::vector<uint32_t>& values, uint64_t initial) {
+    constexpr size_t BLOCK_SIZE = size_t{1} << 16;
+    std::vector<uint64_t> sums(values.size());
+    const size_t n_blocks = (values.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::vector<uint64_t> block_start(n_blocks, initial);
+    auto block_total = [&](size_t block) {
+      uint64_t total = 0;
+      for (size_t i = block * BLOCK_SIZE; i < std::min(values.size(), (block + 1) * BLOCK_SIZE);
+           i++) {
+        total += values[i];
+      }
+      block_start[block] = total;
+    };
+    auto fill_block = [&](size_t block) {
+      uint64_t running = block_start[block];
+      for (size_t i = block * BLOCK_SIZE; i < std::min(values.size(), (block + 1) * BLOCK_SIZE);
+           i++) {
+        sums[i] = running;
+        running += values[i];
+      }
+    };
+    if (n_blocks <= 1) {
+      for (size_t block = 0; block < n_blocks; block++) fill_block(block);
+      return sums;
+    }
+    utilities::parallel_for(size_t{0}, n_blocks, block_total);
+    uint64_t running = initial;
+    for (uint64_t& start : block_start) {
+      running += std::exchange(start, running);
+    }
+    utilities::parallel_for(size_t{0}, n_blocks, fill_block);
+    return sums;
+  }
+
+  // Switches a constant-size table to the explicit per-chunk representation.
+  void materialize_points_per_chunk() {
+    m_n_points_per_chunk.resize(number_of_chunks);
+    for (size_t i = 0; i < number_of_chunks; i++) {
+      m_n_points_per_chunk[i] = points_in_chunk(i);
+    }
+    m_decompressed_chunk_offsets = prefix_sums(m_n_points_per_chunk, 0);
+    m_constant_chunk_size = std::nullopt;
+  }
 
  public:
+  // Everything needed to read one chunk.
+  struct ChunkLocation {
+    uint64_t compressed_offset;  // relative to the start of the point data
+    uint32_t compressed_size;
+    uint64_t first_point;
+    uint32_t n_points;
+  };
+
   explicit LAZChunkTable(std::istream& istream,
                          std::optional<uint32_t> constant_chunk_size = std::nullopt,
                          size_t total_n_points = 0)
@@ -60,35 +125,42 @@ class LAZChunkTable : LAZChunkTableHeader {
         LASPP_ASSERT_EQ(
             (total_n_points + constant_chunk_size.value() - 1) / constant_chunk_size.value(),
             number_of_chunks);
+        if (number_of_chunks > 0) {
+          m_last_chunk_n_points = static_cast<uint32_t>(
+              total_n_points - size_t{number_of_chunks - 1} * constant_chunk_size.value());
+        }
       }
     }
 
+    // The arithmetic-coded deltas can only be decoded serially; the offsets are built afterwards.
     InStream decoder(istream);
     IntegerEncoder<32> compressed_size_int_decoder;
     IntegerEncoder<32> n_points_int_decoder;
+    m_compressed_chunk_size.resize(number_of_chunks);
+    if (!m_constant_chunk_size) {
+      m_n_points_per_chunk.resize(number_of_chunks);
+    }
+    int64_t previous_n_points = 0;
+    int64_t previous_compressed_size = 0;
     for (size_t i = 0; i < number_of_chunks; i++) {
-      if (m_constant_chunk_size) {
-        m_n_points_per_chunk.push_back(
-            i == number_of_chunks - 1
-                ? static_cast<uint32_t>(total_n_points - i * constant_chunk_size.value())
-                : constant_chunk_size.value());
-      } else {
-        int32_t decoded_delta = n_points_int_decoder.decode_int(decoder);
-        int64_t previous_value = i == 0 ? 0LL : static_cast<int64_t>(m_n_points_per_chunk[i - 1]);
-        int64_t current_value = previous_value + decoded_delta;
+      if (!m_constant_chunk_size) {
+        int64_t current_value = previous_n_points + n_points_int_decoder.decode_int(decoder);
         LASPP_ASSERT_GE(current_value, 0);
-        m_n_points_per_chunk.push_back(static_cast<size_t>(current_value));
+        LASPP_ASSERT_LE(current_value, std::numeric_limits<uint32_t>::max());
+        m_n_points_per_chunk[i] = static_cast<uint32_t>(current_value);
+        previous_n_points = current_value;
       }
-      m_decompressed_chunk_offsets.push_back(
-          i == 0 ? 0 : m_decompressed_chunk_offsets[i - 1] + m_n_points_per_chunk[i - 1]);
 
-      int32_t decoded_delta = compressed_size_int_decoder.decode_int(decoder);
-      int64_t previous_value = i == 0 ? 0LL : static_cast<int64_t>(m_compressed_chunk_size[i - 1]);
-      int64_t current_value = previous_value + decoded_delta;
+      int64_t current_value =
+          previous_compressed_size + compressed_size_int_decoder.decode_int(decoder);
       LASPP_ASSERT_GE(current_value, 0);
-      m_compressed_chunk_size.push_back(static_cast<uint32_t>(current_value));
-      m_compressed_chunk_offsets.push_back(
-          i == 0 ? 8 : m_compressed_chunk_offsets[i - 1] + m_compressed_chunk_size[i - 1]);
+      m_compressed_chunk_size[i] = static_cast<uint32_t>(current_value);
+      previous_compressed_size = current_value;
+    }
+
+    m_compressed_chunk_offsets = prefix_sums(m_compressed_chunk_size, FIRST_CHUNK_OFFSET);
+    if (!m_constant_chunk_size) {
+      m_decompressed_chunk_offsets = prefix_sums(m_n_points_per_chunk, 0);
     }
   }
 
@@ -102,8 +174,7 @@ class LAZChunkTable : LAZChunkTableHeader {
     IntegerEncoder<32> n_points_int_encoder;
     for (size_t i = 0; i < number_of_chunks; i++) {
       if (!m_constant_chunk_size.has_value()) {
-        uint32_t previous_n_points =
-            i == 0 ? 0u : static_cast<uint32_t>(m_n_points_per_chunk[i - 1]);
+        uint32_t previous_n_points = i == 0 ? 0u : m_n_points_per_chunk[i - 1];
         n_points_int_encoder.encode_int(
             encoder, static_cast<int32_t>(m_n_points_per_chunk[i] - previous_n_points));
       }
@@ -117,30 +188,76 @@ class LAZChunkTable : LAZChunkTableHeader {
   size_t chunk_offset(size_t i) const { return m_compressed_chunk_offsets.at(i); }
   size_t compressed_chunk_size(size_t i) const { return m_compressed_chunk_size.at(i); }
 
+  // Unchecked accessors for hot paths: callers validate chunk indices once up front.
+  uint32_t points_in_chunk(size_t i) const {
+    LASPP_DEBUG_ASSERT_LT(i, number_of_chunks);
+    if (m_constant_chunk_size) {
+      return i + 1 == number_of_chunks ? m_last_chunk_n_points : m_constant_chunk_size.value();
+    }
+    return m_n_points_per_chunk[i];
+  }
+  uint64_t decompressed_chunk_offset(size_t i) const {
+    LASPP_DEBUG_ASSERT_LT(i, number_of_chunks);
+    if (m_constant_chunk_size) {
+      return uint64_t{i} * m_constant_chunk_size.value();
+    }
+    return m_decompressed_chunk_offsets[i];
+  }
+  ChunkLocation chunk(size_t i) const {
+    LASPP_DEBUG_ASSERT_LT(i, number_of_chunks);
+    return {m_compressed_chunk_offsets[i], m_compressed_chunk_size[i],
+            decompressed_chunk_offset(i), points_in_chunk(i)};
+  }
+
+  // Index of the chunk containing point `point_index`; points past the end map to the last
+  // chunk. Requires a non-empty table.
+  size_t chunk_containing_point(uint64_t point_index) const {
+    LASPP_ASSERT_GT(number_of_chunks, 0u);
+    if (m_constant_chunk_size) {
+      return static_cast<size_t>(std::min<uint64_t>(point_index / m_constant_chunk_size.value(),
+                                                    number_of_chunks - 1));
+    }
+    auto it = std::upper_bound(m_decompressed_chunk_offsets.begin(),
+                               m_decompressed_chunk_offsets.end(), point_index);
+    return static_cast<size_t>(it - m_decompressed_chunk_offsets.begin()) - 1;
+  }
+
   void add_chunk(uint32_t num_points, uint32_t compressed_size) {
-    if (m_constant_chunk_size && m_compressed_chunk_size.size() > 0) {
-      if (m_n_points_per_chunk.back() != m_constant_chunk_size.value()) {
-        m_constant_chunk_size = std::nullopt;
+    if (m_constant_chunk_size && number_of_chunks > 0) {
+      if (m_last_chunk_n_points != m_constant_chunk_size.value() ||
+          num_points > m_constant_chunk_size.value()) {
+        materialize_points_per_chunk();
       }
-    } else if (m_n_points_per_chunk.size() == 0 && !m_constant_chunk_size) {
+    } else if (number_of_chunks == 0 && !m_constant_chunk_size) {
       m_constant_chunk_size = num_points;
     }
     m_compressed_chunk_offsets.push_back(
         m_compressed_chunk_offsets.empty()
-            ? 8
+            ? FIRST_CHUNK_OFFSET
             : (m_compressed_chunk_offsets.back() + m_compressed_chunk_size.back()));
     m_compressed_chunk_size.push_back(compressed_size);
-    m_decompressed_chunk_offsets.push_back(m_decompressed_chunk_offsets.empty()
-                                               ? 0
-                                               : m_decompressed_chunk_offsets.back() +
-                                                     m_n_points_per_chunk.back());
-    m_n_points_per_chunk.push_back(num_points);
+    if (m_constant_chunk_size) {
+      m_last_chunk_n_points = num_points;
+    } else {
+      m_decompressed_chunk_offsets.push_back(m_decompressed_chunk_offsets.empty()
+                                                 ? 0
+                                                 : m_decompressed_chunk_offsets.back() +
+                                                       m_n_points_per_chunk.back());
+      m_n_points_per_chunk.push_back(num_points);
+    }
     number_of_chunks++;
   }
 
-  const std::vector<size_t>& points_per_chunk() const { return m_n_points_per_chunk; }
-  const std::vector<size_t>& decompressed_chunk_offsets() const {
-    return m_decompressed_chunk_offsets;
+  // Materialised per-chunk vectors (O(num_chunks) per call); prefer the accessors above.
+  std::vector<size_t> points_per_chunk() const {
+    std::vector<size_t> result(number_of_chunks);
+    for (size_t i = 0; i < number_of_chunks; i++) result[i] = points_in_chunk(i);
+    return result;
+  }
+  std::vector<size_t> decompressed_chunk_offsets() const {
+    std::vector<size_t> result(number_of_chunks);
+    for (size_t i = 0; i < number_of_chunks; i++) result[i] = decompressed_chunk_offset(i);
+    return result;
   }
   std::optional<uint32_t> constant_chunk_size() const { return m_constant_chunk_size; }
 
@@ -149,8 +266,8 @@ class LAZChunkTable : LAZChunkTableHeader {
     os << "Compressed chunk sizes: " << chunk_table.m_compressed_chunk_size << std::endl;
     os << "Constant chunk size: " << chunk_table.m_constant_chunk_size << std::endl;
     os << "Compressed chunk offsets: " << chunk_table.m_compressed_chunk_offsets << std::endl;
-    os << "Decompressed chunk offsets: " << chunk_table.m_decompressed_chunk_offsets << std::endl;
-    os << "# points by chunk: " << chunk_table.m_n_points_per_chunk << std::endl;
+    os << "Decompressed chunk offsets: " << chunk_table.decompressed_chunk_offsets() << std::endl;
+    os << "# points by chunk: " << chunk_table.points_per_chunk() << std::endl;
     return os;
   }
 };
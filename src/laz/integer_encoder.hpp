@@ -95,6 +95,22 @@ class IntegerEncoder {
   explicit IntegerEncoder(std::optional<std::shared_ptr<SymbolEncoders>> symbol_encoders)
       : m_symbol_encoders(symbol_encoders.value_or(std::make_shared<SymbolEncoders>())) {}
 
+  // Copies get their own symbol models, so a copy continues independently of the original.
+  IntegerEncoder(const IntegerEncoder& other)
+      : m_k_encoder(other.m_k_encoder),
+        m_symbol_encoders(std::make_shared<SymbolEncoders>(*other.m_symbol_encoders)) {}
+  // Copies the k model of `other` but uses (possibly shared) `symbol_encoders`.
+  IntegerEncoder(const IntegerEncoder& other, std::shared_ptr<SymbolEncoders> symbol_encoders)
+      : m_k_encoder(other.m_k_encoder), m_symbol_encoders(std::move(symbol_encoders)) {}
+  IntegerEncoder& operator=(const IntegerEncoder& other) {
+    if (this != &other) {
+      *this = IntegerEncoder(other);
+    }
+    return *this;
+  }
+  IntegerEncoder(IntegerEncoder&&) = default;
+  IntegerEncoder& operator=(IntegerEncoder&&) = default;
+
   int32_t decode_int(InStream& stream) {
     uint_fast16_t k = m_k_encoder.decode_symbol(stream);
     m_symbol_encoders->m_prev_k = k;
@@ -164,6 +180,24 @@ class MultiInstanceIntegerEncoder {
     }
   }
 
+  // The copy's instances share one copy of the symbol models, like the original's.
+  MultiInstanceIntegerEncoder(const MultiInstanceIntegerEncoder& other)
+      : m_symbol_encoders(std::make_shared<typename IntegerEncoder<n_bits>::SymbolEncoders>(
+            *other.m_symbol_encoders)) {
+    for (size_t i = 0; i < n_instances; i++) {
+      m_integer_encoders[i] =
+          IntegerEncoder<n_bits>(other.m_integer_encoders[i], m_symbol_encoders);
+    }
+  }
+  MultiInstanceIntegerEncoder& operator=(const MultiInstanceIntegerEncoder& other) {
+    if (this != &other) {
+      *this = MultiInstanceIntegerEncoder(other);
+    }
+    return *this;
+  }
+  MultiInstanceIntegerEncoder(MultiInstanceIntegerEncoder&&) = default;
+  MultiInstanceIntegerEncoder& operator=(MultiInstanceIntegerEncoder&&) = default;
+
   int32_t decode_int(uint32_t instance, InStream& stream) {
     return m_integer_encoders[instance].decode_int(stream);
   }
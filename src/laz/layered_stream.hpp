@@ -43,7 +43,6 @@ class AlwaysConstructedArray {
 template <std::size_t N_STREAMS>
 class LayeredInStreams {
  public:
-  LayeredInStreams(const LayeredInStreams&) = delete;
   LayeredInStreams& operator=(const LayeredInStreams&) = delete;
   LayeredInStreams(LayeredInStreams&&) = delete;
   LayeredInStreams& operator=(LayeredInStreams&&) = delete;
@@ -83,6 +82,13 @@ class LayeredInStreams {
     }
   }
 
+  // Copies every layer's decoder position.
+  LayeredInStreams(const LayeredInStreams& other) : m_non_empty(other.m_non_empty) {
+    for (std::size_t i = 0; i < N_STREAMS; ++i) {
+      m_streams.construct(i, other.m_streams[i]);
+    }
+  }
+
   bool non_empty(std::size_t i) const noexcept { return m_non_empty[i]; }
 
   InStream& operator[](std::size_t i) noexcept { return m_streams[i]; }
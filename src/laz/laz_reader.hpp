@@ -6,13 +6,18 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <span>
 #include <type_traits>
+#include <variant>
+#include <vector>
 
 #include "chunktable.hpp"
 #include "las_point.hpp"
@@ -29,6 +34,7 @@
 #include "laz/stream.hpp"
 #include "laz_vlr.hpp"
 #include "utilities/assert.hpp"
+#include "utilities/cancellation.hpp"
 #include "utilities/macros.hpp"
 
 namespace laspp {
@@ -57,52 +63,58 @@ void copy_from_if_possible(TDest& dest, const TSrc& src) {
   }
 }
 
-class LAZReader {
-  LAZSpecialVLRContent m_special_vlr;
-  std::optional<LAZChunkTable> m_chunk_table;
+// Incremental decoder for one compressed LAZ chunk: decodes the chunk's points in order, over
+// any number of decode()/skip() calls. Copying a decoder snapshots its full state (entropy models
+// and stream positions), so decoding can later resume from the copy instead of from the start of
+// the chunk. The compressed data must outlive the decoder and all of its copies.
+class LAZChunkDecoder {
+  // Byte14 items: one LayeredInStreams<1> per slot, stored as a vector.
+  // Standard items: one LayeredInStreams<N> per encoder.
+  using Byte14InStreams = std::vector<std::unique_ptr<LayeredInStreams<1>>>;
+  using LayeredInStreamsVariant =
+      std::variant<std::unique_ptr<LayeredInStreams<1>>, std::unique_ptr<LayeredInStreams<2>>,
+                   std::unique_ptr<LayeredInStreams<9>>, Byte14InStreams>;
 
-  std::optional<size_t> chunk_size() const {
-    if (m_special_vlr.chunk_size == std::numeric_limits<uint32_t>::max()) {
-      return std::nullopt;
-    }
-    return m_special_vlr.chunk_size;
-  }
-
- public:
-  explicit LAZReader(const LAZSpecialVLRContent& special_vlr) : m_special_vlr(special_vlr) {}
+  // Decodes into nothing; used to skip points.
+  struct DiscardedPoint {};
 
-  void read_chunk_table(std::istream& in_stream, size_t n_points) {
-    int64_t chunk_table_offset;
-    LASPP_CHECK_READ(in_stream, &chunk_table_offset, sizeof(chunk_table_offset));
-    if (chunk_table_offset == -1) {
-      LASPP_UNIMPLEMENTED("Reading chunk table from LAS file");
-    }
+  LAZCompressor m_compressor;
+  std::vector<LAZEncoder> m_encoders;
+  std::vector<LayeredInStreamsVariant> m_layered_in_streams;  // layered compression
+  std::unique_ptr<InStream> m_in_stream;                      // pointwise compression
+  const std::byte* m_data_begin;
+  size_t m_n_points;
+  size_t m_next_point = 0;
+  std::vector<uint32_t> m_layer_sizes;  // layered compression
+  // Time spent decoding each item, when requested by time_items()
+  std::vector<std::chrono::nanoseconds>* m_item_decode_times = nullptr;
 
-    LASPP_CHECK_SEEK(in_stream, chunk_table_offset, std::ios::beg);
-    m_chunk_table.emplace(LAZChunkTable(in_stream, chunk_size(), n_points));
+  template <typename Ptr>
+  static Ptr deep_copy(const Ptr& ptr) {
+    return std::make_unique<typename Ptr::element_type>(*ptr);
   }
 
-  const LAZChunkTable& chunk_table() const { return m_chunk_table.value(); }
-
-  template <typename T>
-  std::span<T> decompress_chunk(std::span<const std::byte> compressed_data,
-                                std::span<T> decompressed_data) {
-    std::vector<LAZEncoder> encoders;
+ public:
+  LAZChunkDecoder(const LAZSpecialVLRContent& special_vlr,
+                  std::span<const std::byte> compressed_data, size_t n_points)
+      : m_compressor(special_vlr.compressor),
+        m_data_begin(compressed_data.data()),
+        m_n_points(n_points) {
     {
       std::optional<uint8_t> context;
-      for (LAZItemRecord record : m_special_vlr.items_records) {
+      for (LAZItemRecord record : special_vlr.items_records) {
         switch (record.item_type) {
           case LAZItemType::Point14: {
             LASPP_ASSERT(compressed_data.size() >= sizeof(LASPointFormat6));
             LASPointFormat6 seed{};
             std::memcpy(&seed, compressed_data.data(), sizeof(seed));
             if (record.item_version == LAZItemVersion::Version4) {
-              encoders.emplace_back(std::make_unique<LASPointFormat6EncoderV4>(seed));
-              context = std::get<std::unique_ptr<LASPointFormat6EncoderV4>>(encoders.back())
+              m_encoders.emplace_back(std::make_unique<LASPointFormat6EncoderV4>(seed));
+              context = std::get<std::unique_ptr<LASPointFormat6EncoderV4>>(m_encoders.back())
                             ->get_active_context();
             } else {
-              encoders.emplace_back(std::make_unique<LASPointFormat6EncoderV3>(seed));
-              context = std::get<std::unique_ptr<LASPointFormat6EncoderV3>>(encoders.back())
+              m_encoders.emplace_back(std::make_unique<LASPointFormat6EncoderV3>(seed));
+              context = std::get<std::unique_ptr<LASPointFormat6EncoderV3>>(m_encoders.back())
                             ->get_active_context();
             }
             compressed_data = compressed_data.subspan(sizeof(LASPointFormat6));
@@ -116,7 +128,7 @@ class LAZReader {
             ColorData seed{};
             std::memcpy(&seed, compressed_data.data(), sizeof(seed));
             const bool use_v3_context_quirk = (record.item_version == LAZItemVersion::Version3);
-            encoders.emplace_back(
+            m_encoders.emplace_back(
                 std::make_unique<RGB14Encoder>(seed, context.value(), use_v3_context_quirk));
             compressed_data = compressed_data.subspan(sizeof(ColorData));
             break;
@@ -125,7 +137,7 @@ class LAZReader {
             LASPP_ASSERT(compressed_data.size() >= sizeof(LASPointFormat0));
             LASPointFormat0 seed{};
             std::memcpy(&seed, compressed_data.data(), sizeof(seed));
-            encoders.emplace_back(std::make_unique<LASPointFormat0Encoder>(seed));
+            m_encoders.emplace_back(std::make_unique<LASPointFormat0Encoder>(seed));
             compressed_data = compressed_data.subspan(sizeof(LASPointFormat0));
             break;
           }
@@ -133,7 +145,7 @@ class LAZReader {
             LASPP_ASSERT(compressed_data.size() >= sizeof(GPSTime));
             GPSTime seed{};
             std::memcpy(&seed, compressed_data.data(), sizeof(seed));
-            encoders.emplace_back(std::make_unique<GPSTime11Encoder>(seed));
+            m_encoders.emplace_back(std::make_unique<GPSTime11Encoder>(seed));
             compressed_data = compressed_data.subspan(sizeof(GPSTime));
             break;
           }
@@ -143,9 +155,9 @@ class LAZReader {
             std::memcpy(&seed, compressed_data.data(), sizeof(seed));
             const bool use_v2 = (record.item_version == LAZItemVersion::Version2);
             if (use_v2) {
-              encoders.emplace_back(std::make_unique<RGB12EncoderV2>(seed));
+              m_encoders.emplace_back(std::make_unique<RGB12EncoderV2>(seed));
             } else {
-              encoders.emplace_back(std::make_unique<RGB12EncoderV1>(seed));
+              m_encoders.emplace_back(std::make_unique<RGB12EncoderV1>(seed));
             }
             compressed_data = compressed_data.subspan(sizeof(ColorData));
             break;
@@ -153,7 +165,7 @@ class LAZReader {
           case LAZItemType::Byte: {
             std::vector<std::byte> last_bytes(record.item_size);
             std::copy_n(compressed_data.data(), record.item_size, last_bytes.begin());
-            encoders.emplace_back(std::make_unique<BytesEncoder>(last_bytes));
+            m_encoders.emplace_back(std::make_unique<BytesEncoder>(last_bytes));
             compressed_data = compressed_data.subspan(record.item_size);
             break;
           }
@@ -165,10 +177,9 @@ class LAZReader {
             std::vector<Byte14Encoder> byte14_encoders;
             byte14_encoders.reserve(record.item_size);
             for (size_t j = 0; j < record.item_size; j++) {
-              byte14_encoders.emplace_back(
-                  *reinterpret_cast<const std::byte*>(compressed_data.data() + j), context.value());
+              byte14_encoders.emplace_back(compressed_data[j], context.value());
             }
-            encoders.emplace_back(std::move(byte14_encoders));
+            m_encoders.emplace_back(std::move(byte14_encoders));
             compressed_data = compressed_data.subspan(record.item_size);
             break;
           }
@@ -183,7 +194,7 @@ class LAZReader {
             LASPP_ASSERT(context.has_value(),
                          "RGBNIR14 requires Point14-derived context; ensure item records are "
                          "ordered so Point14 runs before RGBNIR14.");
-            encoders.emplace_back(
+            m_encoders.emplace_back(
                 std::make_unique<RGBNIR14Encoder>(initial, context.value(), use_v3_quirk));
             compressed_data = compressed_data.subspan(sizeof(ColorData) + sizeof(uint16_t));
             break;
@@ -195,25 +206,27 @@ class LAZReader {
           case LAZItemType::Double: {
             std::vector<std::byte> last_bytes(record.item_size);
             std::copy_n(compressed_data.data(), record.item_size, last_bytes.begin());
-            encoders.emplace_back(std::make_unique<RawBytesEncoder>(last_bytes));
+            m_encoders.emplace_back(std::make_unique<RawBytesEncoder>(last_bytes));
             compressed_data = compressed_data.subspan(record.item_size);
             break;
           }
           case LAZItemType::Wavepacket13:
           case LAZItemType::Wavepacket14:
-          default:
-            LASPP_FAIL("Currently unsupported LAZ item type: ", LAZItemType(record.item_type), " (",
-                       static_cast<uint16_t>(record.item_type), ")");
+          default: {
+            const LAZItemType item_type = record.item_type;  // not bound by reference (packed)
+            LASPP_FAIL("Currently unsupported LAZ item type: ", item_type, " (",
+                       static_cast<uint16_t>(item_type), ")");
+          }
         }
       }
     }
 
-    if (m_special_vlr.compressor == LAZCompressor::LayeredChunked) {
+    if (m_compressor == LAZCompressor::LayeredChunked) {
       {
         uint32_t num_points;
         std::memcpy(&num_points, compressed_data.data(), sizeof(num_points));
         compressed_data = compressed_data.subspan(sizeof(uint32_t));
-        LASPP_ASSERT_EQ(num_points, decompressed_data.size());
+        LASPP_ASSERT_EQ(num_points, n_points);
       }
 
       static_assert(has_num_layers<laspp::LASPointFormat6Encoder>::value,
@@ -222,7 +235,7 @@ class LAZReader {
       // Count total layers: unique_ptr encoders use their compile-time NUM_LAYERS;
       // vector<Byte14Encoder> contributes one layer per slot.
       size_t total_n_layers = 0;
-      for (const LAZEncoder& encoder : encoders) {
+      for (const LAZEncoder& encoder : m_encoders) {
         std::visit(
             [&total_n_layers](auto&& enc) {
               using ET = std::decay_t<decltype(enc)>;
@@ -239,20 +252,14 @@ class LAZReader {
             },
             encoder);
       }
+      m_layer_sizes.resize(total_n_layers);
+      std::memcpy(m_layer_sizes.data(), compressed_data.data(), total_n_layers * sizeof(uint32_t));
       std::span<const std::byte> compressed_layer_data =
           compressed_data.subspan(total_n_layers * sizeof(uint32_t));
 
-      // Byte14 items: one LayeredInStreams<1> per slot, stored as a vector.
-      // Standard items: one LayeredInStreams<N> per encoder.
-      using Byte14InStreams = std::vector<std::unique_ptr<LayeredInStreams<1>>>;
-      std::vector<
-          std::variant<std::unique_ptr<LayeredInStreams<1>>, std::unique_ptr<LayeredInStreams<2>>,
-                       std::unique_ptr<LayeredInStreams<9>>, Byte14InStreams>>
-          layered_in_streams_for_encoders;
-      for (const LAZEncoder& encoder : encoders) {
+      for (const LAZEncoder& encoder : m_encoders) {
         std::visit(
-            [&compressed_data, &compressed_layer_data,
-             &layered_in_streams_for_encoders](auto&& enc) {
+            [this, &compressed_data, &compressed_layer_data](auto&& enc) {
               using ET = std::decay_t<decltype(enc)>;
               if constexpr (std::is_same_v<ET, std::vector<Byte14Encoder>>) {
                 Byte14InStreams streams;
@@ -261,10 +268,10 @@ class LAZReader {
                   streams.emplace_back(std::make_unique<LayeredInStreams<1>>(
                       compressed_data, compressed_layer_data));
                 }
-                layered_in_streams_for_encoders.emplace_back(std::move(streams));
+                m_layered_in_streams.emplace_back(std::move(streams));
               } else if constexpr (has_num_layers_v<std::decay_t<decltype(*enc)>>) {
                 using EncT = std::decay_t<decltype(*enc)>;
-                layered_in_streams_for_encoders.emplace_back(
+                m_layered_in_streams.emplace_back(
                     std::make_unique<LayeredInStreams<EncT::NUM_LAYERS>>(compressed_data,
                                                                          compressed_layer_data));
               } else {
@@ -274,24 +281,128 @@ class LAZReader {
             encoder);
       }
       LASPP_ASSERT_EQ(compressed_layer_data.size(), 0);
+    } else {
+      m_in_stream = std::make_unique<InStream>(compressed_data.data(), compressed_data.size());
+    }
+  }
+
+  LAZChunkDecoder(const LAZChunkDecoder& other)
+      : m_compressor(other.m_compressor),
+        m_data_begin(other.m_data_begin),
+        m_n_points(other.m_n_points),
+        m_next_point(other.m_next_point),
+        m_layer_sizes(other.m_layer_sizes) {
+    m_encoders.reserve(other.m_encoders.size());
+    for (const LAZEncoder& encoder : other.m_encoders) {
+      std::visit(
+          [this](const auto& enc) {
+            using ET = std::decay_t<decltype(enc)>;
+            if constexpr (std::is_same_v<ET, std::vector<Byte14Encoder>>) {
+              m_encoders.emplace_back(enc);
+            } else {
+              m_encoders.emplace_back(deep_copy(enc));
+            }
+          },
+          encoder);
+    }
+    m_layered_in_streams.reserve(other.m_layered_in_streams.size());
+    for (const LayeredInStreamsVariant& streams : other.m_layered_in_streams) {
+      std::visit(
+          [this](const auto& in_streams) {
+            using ST = std::decay_t<decltype(in_streams)>;
+            if constexpr (std::is_same_v<ST, Byte14InStreams>) {
+              Byte14InStreams copies;
+              copies.reserve(in_streams.size());
+              for (const auto& slot_streams : in_streams) copies.push_back(deep_copy(slot_streams));
+              m_layered_in_streams.emplace_back(std::move(copies));
+            } else {
+              m_layered_in_streams.emplace_back(deep_copy(in_streams));
+            }
+          },
+          streams);
+    }
+    if (other.m_in_stream != nullptr) {
+      m_in_stream = deep_copy(other.m_in_stream);
+    }
+  }
+  LAZChunkDecoder& operator=(const LAZChunkDecoder&) = delete;
+  LAZChunkDecoder(LAZChunkDecoder&&) = default;
+  LAZChunkDecoder& operator=(LAZChunkDecoder&&) = default;
+
+  size_t n_points() const { return m_n_points; }
+  // Index (within the chunk) of the next point decode() returns.
+  size_t next_point() const { return m_next_point; }
+
+  // Compressed bytes of every layer, in item order (layered compression only; empty otherwise).
+  const std::vector<uint32_t>& layer_sizes() const { return m_layer_sizes; }
 
+  // Adds the time spent decoding each item record to `times` (one entry per item) on later
+  // decode() calls, for diagnostics; pass nullptr to stop. Timing every item of every point has a
+  // cost of its own, so this is off by default. Not copied with the decoder.
+  void time_items(std::vector<std::chrono::nanoseconds>* times) {
+    if (times != nullptr) {
+      times->resize(m_encoders.size());
+    }
+    m_item_decode_times = times;
+  }
+
+  // Bytes of compressed data read so far (pointwise compression only). The arithmetic decoder
+  // reads exactly the bytes the encoder wrote, so once every point is decoded this is the size
+  // of the chunk; it exceeds the data given when decoding ran past its end.
+  size_t bytes_consumed() const {
+    LASPP_ASSERT(m_in_stream != nullptr, "bytes_consumed requires pointwise compression");
+    return m_in_stream->bytes_read(m_data_begin);
+  }
+
+  // Decodes the next decompressed_data.size() points of the chunk. Checks for cancellation (see
+  // utilities::CancellationScope) every CANCELLATION_CHECK_INTERVAL points.
+  template <typename T>
+  std::span<T> decode(std::span<T> decompressed_data) {
+    LASPP_ASSERT_LE(m_next_point + decompressed_data.size(), m_n_points);
+    for (size_t first = 0; first < decompressed_data.size();
+         first += CANCELLATION_CHECK_INTERVAL) {
+      if (first > 0) {
+        utilities::check_cancellation();
+      }
+      decode_batch(decompressed_data.subspan(
+          first, std::min(CANCELLATION_CHECK_INTERVAL, decompressed_data.size() - first)));
+    }
+    return decompressed_data;
+  }
+
+  // Advances past the next n points without converting them.
+  void skip(size_t n) {
+    std::array<DiscardedPoint, 256> discarded;
+    while (n > 0) {
+      const size_t batch = std::min(n, discarded.size());
+      decode(std::span<DiscardedPoint>(discarded.data(), batch));
+      n -= batch;
+    }
+  }
+
+ private:
+  static constexpr size_t CANCELLATION_CHECK_INTERVAL = 4096;
+
+  template <typename T>
+  void decode_batch(std::span<T> decompressed_data) {
+    if (m_compressor == LAZCompressor::LayeredChunked) {
       for (size_t i = 0; i < decompressed_data.size(); i++) {
         if (i + 3 < decompressed_data.size()) {
           LASPP_PREFETCH(&decompressed_data[i + 3]);
         }
 
+        const bool is_seed = m_next_point + i == 0;
         std::optional<uint8_t> context;
-        for (size_t encoder_idx = 0; encoder_idx < encoders.size(); encoder_idx++) {
-          LAZEncoder& laz_encoder = encoders[encoder_idx];
+        for (size_t encoder_idx = 0; encoder_idx < m_encoders.size(); encoder_idx++) {
+          LAZEncoder& laz_encoder = m_encoders[encoder_idx];
+          const std::chrono::steady_clock::time_point start = item_timer_start();
 
           std::visit(
-              [&decompressed_data, &i, &layered_in_streams_for_encoders, encoder_idx,
-               &context](auto&& enc) {
+              [this, &decompressed_data, i, is_seed, encoder_idx, &context](auto&& enc) {
                 using ET = std::decay_t<decltype(enc)>;
                 if constexpr (std::is_same_v<ET, std::vector<Byte14Encoder>>) {
-                  auto& streams =
-                      std::get<Byte14InStreams>(layered_in_streams_for_encoders[encoder_idx]);
-                  if (i > 0) {
+                  auto& streams = std::get<Byte14InStreams>(m_layered_in_streams[encoder_idx]);
+                  if (!is_seed) {
                     LASPP_ASSERT(context.has_value(),
                                  "Byte14 decode requires Point14-derived context; ensure item "
                                  "records are ordered so Point14 runs before Byte14.");
@@ -308,17 +419,17 @@ class LAZReader {
                   if constexpr (has_num_layers_v<EncType>) {
                     LayeredInStreams<EncType::NUM_LAYERS>& layered_in_stream =
                         *std::get<std::unique_ptr<LayeredInStreams<EncType::NUM_LAYERS>>>(
-                            layered_in_streams_for_encoders[encoder_idx]);
+                            m_layered_in_streams[encoder_idx]);
                     if constexpr (std::is_same_v<EncType, LASPointFormat6EncoderV3> ||
                                   std::is_same_v<EncType, LASPointFormat6EncoderV4>) {
-                      if (i > 0) {
+                      if (!is_seed) {
                         auto decoded_val = encoder.decode(layered_in_stream);
                         context = encoder.get_active_context();
                         copy_from_if_possible(decompressed_data[i], decoded_val);
                         return;
                       }
                     } else {
-                      if (i > 0) {
+                      if (!is_seed) {
                         auto decoded_val = encoder.decode(layered_in_stream, context.value());
                         // RGBNIR14 decodes to RGBNIRData; copy RGB and NIR independently so
                         // destination point types only need to support ColorData/NIRData.
@@ -333,9 +444,9 @@ class LAZReader {
                         return;
                       }
                     }
-                    // i == 0 uses encoder.last_value() (the seed). If this is RGBNIRData, we need
-                    // to copy the RGB and NIR components independently because we do not require
-                    // a direct copy_from(RGBNIRData, PointT) overload.
+                    // The first point of the chunk is encoder.last_value() (the seed). If this is
+                    // RGBNIRData, we need to copy the RGB and NIR components independently because
+                    // we do not require a direct copy_from(RGBNIRData, PointT) overload.
                     if constexpr (std::is_same_v<EncType, RGBNIR14Encoder>) {
                       const RGBNIRData& seed = encoder.last_value();
                       copy_from_if_possible(decompressed_data[i], seed.rgb);
@@ -351,14 +462,17 @@ class LAZReader {
                 }
               },
               laz_encoder);
+          add_item_time(encoder_idx, start);
         }
       }
     } else {
-      InStream compressed_in_stream(compressed_data.data(), compressed_data.size());
       for (size_t i = 0; i < decompressed_data.size(); i++) {
-        for (LAZEncoder& laz_encoder : encoders) {
+        const bool is_seed = m_next_point + i == 0;
+        for (size_t encoder_idx = 0; encoder_idx < m_encoders.size(); encoder_idx++) {
+          LAZEncoder& laz_encoder = m_encoders[encoder_idx];
+          const std::chrono::steady_clock::time_point start = item_timer_start();
           std::visit(
-              [&compressed_in_stream, &decompressed_data, &i](auto&& enc) {
+              [this, &decompressed_data, i, is_seed](auto&& enc) {
                 using ET = std::decay_t<decltype(enc)>;
                 if constexpr (std::is_same_v<ET, std::vector<Byte14Encoder>>) {
                   LASPP_FAIL("Cannot use layered encoder with non-layered compression.");
@@ -368,16 +482,98 @@ class LAZReader {
                   if constexpr (has_num_layers_v<EncType>) {
                     LASPP_FAIL("Cannot use layered encoder with non-layered compression.");
                   } else {
-                    if (i > 0) encoder.decode(compressed_in_stream);
+                    if (!is_seed) encoder.decode(*m_in_stream);
                     copy_from_if_possible(decompressed_data[i], encoder.last_value());
                   }
                 }
               },
               laz_encoder);
+          add_item_time(encoder_idx, start);
         }
       }
     }
-    return decompressed_data;
+    m_next_point += decompressed_data.size();
+  }
+
+  std::chrono::steady_clock::time_point item_timer_start() const {
+    return m_item_decode_times != nullptr ? std::chrono::steady_clock::now()
+                                          : std::chrono::steady_clock::time_point{};
+  }
+
+  void add_item_time(size_t item, std::chrono::steady_clock::time_point start) {
+    if (m_item_decode_times != nullptr) {
+      (*m_item_decode_times)[item] += std::chrono::steady_clock::now() - start;
+    }
+  }
+};
+
+class LAZReader {
+  LAZSpecialVLRContent m_special_vlr;
+  mutable std::optional<LAZChunkTable> m_chunk_table;
+
+  // Deferred chunk table source (see defer_chunk_table)
+  std::istream* m_chunk_table_stream = nullptr;
+  int64_t m_chunk_table_stream_offset = 0;
+  size_t m_chunk_table_n_points = 0;
+  mutable std::once_flag m_chunk_table_loaded;
+
+  std::optional<size_t> chunk_size() const {
+    if (m_special_vlr.chunk_size == std::numeric_limits<uint32_t>::max()) {
+      return std::nullopt;
+    }
+    return m_special_vlr.chunk_size;
+  }
+
+  void load_chunk_table(std::istream& in_stream, size_t n_points) const {
+    int64_t chunk_table_offset;
+    LASPP_CHECK_READ(in_stream, &chunk_table_offset, sizeof(chunk_table_offset));
+    if (chunk_table_offset == -1) {
+      LASPP_UNIMPLEMENTED("Reading chunk table from LAS file");
+    }
+
+    LASPP_CHECK_SEEK(in_stream, chunk_table_offset, std::ios::beg);
+    m_chunk_table.emplace(LAZChunkTable(in_stream, chunk_size(), n_points));
+  }
+
+ public:
+  explicit LAZReader(const LAZSpecialVLRContent& special_vlr) : m_special_vlr(special_vlr) {}
+
+  const LAZSpecialVLRContent& special_vlr() const { return m_special_vlr; }
+
+  void read_chunk_table(std::istream& in_stream, size_t n_points) {
+    load_chunk_table(in_stream, n_points);
+  }
+
+  // Reads the chunk table on first access to chunk_table() instead, starting at the current
+  // position of `in_stream` (which must outlive this reader). Opening a file then costs nothing
+  // for callers that never touch the point data.
+  void defer_chunk_table(std::istream& in_stream, size_t n_points) {
+    m_chunk_table_stream = &in_stream;
+    m_chunk_table_stream_offset = in_stream.tellg();
+    m_chunk_table_n_points = n_points;
+  }
+
+  const LAZChunkTable& chunk_table() const {
+    if (m_chunk_table_stream != nullptr) {
+      std::call_once(m_chunk_table_loaded, [this]() {
+        if (m_chunk_table.has_value()) {
+          return;
+        }
+        LASPP_CHECK_SEEK(*m_chunk_table_stream, m_chunk_table_stream_offset, std::ios::beg);
+        load_chunk_table(*m_chunk_table_stream, m_chunk_table_n_points);
+      });
+    }
+    return m_chunk_table.value();
+  }
+
+  LAZChunkDecoder chunk_decoder(std::span<const std::byte> compressed_data, size_t n_points) const {
+    return LAZChunkDecoder(m_special_vlr, compressed_data, n_points);
+  }
+
+  template <typename T>
+  std::span<T> decompress_chunk(std::span<const std::byte> compressed_data,
+                                std::span<T> decompressed_data) {
+    return chunk_decoder(compressed_data, decompressed_data.size()).decode(decompressed_data);
   }
 };
 
@@ -6,13 +6,18 @@
 #pragma once
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -27,6 +32,9 @@
 #include "laz/rgb14_encoder.hpp"
 #include "laz/rgbnir14_encoder.hpp"
 #include "laz_vlr.hpp"
+#include "utilities/cancellation.hpp"
+#include "utilities/memory_budget.hpp"
+#include "utilities/thread_pool.hpp"
 
 namespace laspp {
 
@@ -37,12 +45,44 @@ class LAZWriter {
   LAZWriter(LAZWriter&&) = delete;
   LAZWriter& operator=(LAZWriter&&) = delete;
 
+  // Order in which chunks handed to submit_chunk() are written.
+  enum class SubmissionOrder {
+    Sequential,  // by sequence number, holding chunks that arrive early
+    Completion,  // as they arrive, ignoring sequence numbers
+  };
+
  private:
   LAZSpecialVLRContent m_special_vlr;
   LAZChunkTable m_chunk_table;
   std::iostream& m_stream;
   int64_t m_initial_stream_offset;
 
+  // Guards the stream, chunk table and held chunks for concurrent submit_chunk() callers.
+  std::mutex m_write_mutex;
+  std::condition_variable m_chunk_written;
+  SubmissionOrder m_submission_order = SubmissionOrder::Sequential;
+  struct HeldChunk {
+    uint32_t n_points;
+    std::string compressed_data;
+    utilities::MemoryReservation reservation;
+  };
+  std::map<size_t, HeldChunk> m_held_chunks;  // keyed by sequence number
+  bool m_finished = false;
+
+  // Appends a compressed chunk to the stream. Requires m_write_mutex.
+  void append_chunk(uint32_t n_points, std::string_view compressed_data) {
+    LASPP_ASSERT_LT(compressed_data.size(), std::numeric_limits<uint32_t>::max());
+    m_chunk_table.add_chunk(n_points, static_cast<uint32_t>(compressed_data.size()));
+    m_stream.write(compressed_data.data(), static_cast<std::streamsize>(compressed_data.size()));
+    update_chunk_size();
+  }
+
+  void update_chunk_size() {
+    m_special_vlr.chunk_size = m_chunk_table.constant_chunk_size().has_value()
+                                   ? m_chunk_table.constant_chunk_size().value()
+                                   : std::numeric_limits<uint32_t>::max();
+  }
+
  public:
   template <typename... Args>
   explicit LAZWriter(std::iostream& stream, Args... laz_special_vlr_args)
@@ -53,11 +93,30 @@ class LAZWriter {
     m_stream.write(reinterpret_cast<const char*>(&chunk_table_offset), sizeof(chunk_table_offset));
   }
 
+  // Continues a point section that starts at `initial_stream_offset` and already holds the
+  // chunks described by `points_per_chunk` and `compressed_chunk_sizes`, e.g. from a
+  // checkpoint of an interrupted write. The stream must be positioned after the last of them.
+  LAZWriter(std::iostream& stream, LAZSpecialVLRContent special_vlr, int64_t initial_stream_offset,
+            std::span<const uint32_t> points_per_chunk,
+            std::span<const uint32_t> compressed_chunk_sizes)
+      : m_special_vlr(std::move(special_vlr)),
+        m_stream(stream),
+        m_initial_stream_offset(initial_stream_offset) {
+    LASPP_ASSERT_EQ(points_per_chunk.size(), compressed_chunk_sizes.size());
+    for (size_t i = 0; i < points_per_chunk.size(); i++) {
+      m_chunk_table.add_chunk(points_per_chunk[i], compressed_chunk_sizes[i]);
+    }
+    update_chunk_size();
+  }
+
   const LAZSpecialVLRContent& special_vlr() const { return m_special_vlr; }
   LAZSpecialVLRContent& special_vlr() { return m_special_vlr; }
+  const LAZChunkTable& chunk_table() const { return m_chunk_table; }
 
+  // With `parallel_items`, the items of a layered (LAZ 1.4) chunk are encoded concurrently on
+  // the global thread pool; the output is identical either way.
   template <typename T>
-  std::stringstream compress_chunk(const std::span<T>& points) {
+  std::stringstream compress_chunk(const std::span<T>& points, bool parallel_items = false) {
     LASPP_ASSERT_GT(points.size(), 0);
     std::stringstream compressed_data;
 
@@ -73,6 +132,7 @@ class LAZWriter {
         layered_streams;
     std::vector<size_t> encoder_num_layers;
     size_t total_layer_count = 0;
+    uint8_t (*active_context_after)(uint8_t, uint8_t) = nullptr;
     {
       std::optional<uint8_t> context;
       for (LAZItemRecord record : m_special_vlr.items_records) {
@@ -98,10 +158,12 @@ class LAZWriter {
               encoders.emplace_back(std::make_unique<LASPointFormat6EncoderV4>(point));
               context = std::get<std::unique_ptr<LASPointFormat6EncoderV4>>(encoders.back())
                             ->get_active_context();
+              active_context_after = &LASPointFormat6EncoderV4::active_context_after;
             } else {
               encoders.emplace_back(std::make_unique<LASPointFormat6EncoderV3>(point));
               context = std::get<std::unique_ptr<LASPointFormat6EncoderV3>>(encoders.back())
                             ->get_active_context();
+              active_context_after = &LASPointFormat6EncoderV3::active_context_after;
             }
             compressed_data.write(reinterpret_cast<const char*>(&point), sizeof(LASPointFormat6));
             layered_streams.emplace_back(
@@ -288,111 +350,151 @@ class LAZWriter {
         compressed_out_stream = std::make_unique<OutStream>(compressed_data);
       }
 
-      for (size_t i = 1; i < points.size(); i++) {
-        std::optional<uint8_t> context;
-        for (size_t encoder_index = 0; encoder_index < encoders.size(); encoder_index++) {
-          LAZEncoder& laz_encoder = encoders[encoder_index];
-          std::visit(
-              [&](auto&& enc) {
-                using ET = std::decay_t<decltype(enc)>;
-                if constexpr (std::is_same_v<ET, std::vector<Byte14Encoder>>) {
+      // Encodes point i with one item. A Point14 item updates `context` for the items after it.
+      auto encode_point = [&](size_t encoder_index, size_t i, std::optional<uint8_t>& context) {
+        std::visit(
+            [&](auto&& enc) {
+              using ET = std::decay_t<decltype(enc)>;
+              if constexpr (std::is_same_v<ET, std::vector<Byte14Encoder>>) {
+                LASPP_ASSERT(layered_compression);
+                auto& b14_streams = std::get<Byte14OutStreams>(layered_streams[encoder_index]);
+                std::vector<std::byte> bytes_to_encode(enc.size());
+                for (size_t j = 0; j < enc.size(); j++) bytes_to_encode[j] = enc[j].last_value();
+                if constexpr (is_copy_assignable<std::vector<std::byte>, T>()) {
+                  bytes_to_encode = points[i];
+                } else if constexpr (is_copy_fromable<std::vector<std::byte>, T>()) {
+                  copy_from(bytes_to_encode, points[i]);
+                }
+                LASPP_ASSERT_EQ(bytes_to_encode.size(), enc.size());
+                LASPP_ASSERT(context.has_value(),
+                             "Byte14 encode requires Point14-derived context; ensure item "
+                             "records are ordered so Point14 runs before Byte14.");
+                for (size_t j = 0; j < enc.size(); j++) {
+                  enc[j].encode(*b14_streams[j], bytes_to_encode[j], context.value());
+                }
+              } else if constexpr (std::is_same_v<std::decay_t<decltype(*enc)>,
+                                                  RGBNIR14Encoder>) {
+                LASPP_ASSERT(layered_compression);
+                auto& encoder = *enc;
+                RGBNIRData last_value = encoder.last_value();
+                using PointT = std::remove_cv_t<T>;
+                if constexpr (is_copy_fromable<ColorData, PointT>()) {
+                  copy_from(last_value.rgb, points[i]);
+                } else if constexpr (is_copy_assignable<ColorData, PointT>()) {
+                  last_value.rgb = points[i];
+                } else if constexpr (std::is_base_of_v<ColorData, PointT>) {
+                  last_value.rgb = static_cast<const ColorData&>(points[i]);
+                }
+
+                if constexpr (is_copy_fromable<NIRData, PointT>()) {
+                  NIRData nir{};
+                  copy_from(nir, points[i]);
+                  last_value.nir = nir.NIR;
+                } else if constexpr (is_copy_assignable<NIRData, PointT>()) {
+                  NIRData nir = points[i];
+                  last_value.nir = nir.NIR;
+                } else if constexpr (std::is_base_of_v<NIRData, PointT>) {
+                  last_value.nir = static_cast<const NIRData&>(points[i]).NIR;
+                }
+                auto& streams =
+                    *std::get<std::unique_ptr<LayeredOutStreams<RGBNIR14Encoder::NUM_LAYERS>>>(
+                        layered_streams[encoder_index]);
+                encoder.encode(streams, last_value, context.value());
+              } else if constexpr (std::is_same_v<std::decay_t<decltype(*enc)>, BytesEncoder>) {
+                LASPP_ASSERT(!layered_compression);
+                LASPP_ASSERT(compressed_out_stream != nullptr);
+                auto& encoder = *enc;
+                std::vector<std::byte> bytes_to_encode = encoder.last_value();
+                if constexpr (is_copy_assignable<std::vector<std::byte>, T>()) {
+                  bytes_to_encode = points[i];
+                } else if constexpr (is_copy_fromable<std::vector<std::byte>, T>()) {
+                  copy_from(bytes_to_encode, points[i]);
+                }
+                LASPP_ASSERT_EQ(bytes_to_encode.size(), encoder.last_value().size());
+                encoder.encode(*compressed_out_stream, bytes_to_encode);
+              } else if constexpr (std::is_same_v<std::decay_t<decltype(*enc)>,
+                                                  RawBytesEncoder>) {
+                LASPP_ASSERT(!layered_compression);
+                LASPP_ASSERT(compressed_out_stream != nullptr);
+                auto& encoder = *enc;
+                std::vector<std::byte> bytes_to_encode = encoder.last_value();
+                if constexpr (is_copy_assignable<std::vector<std::byte>, T>()) {
+                  bytes_to_encode = points[i];
+                } else if constexpr (is_copy_fromable<std::vector<std::byte>, T>()) {
+                  copy_from(bytes_to_encode, points[i]);
+                }
+                LASPP_ASSERT_EQ(bytes_to_encode.size(), encoder.last_value().size());
+                encoder.encode(*compressed_out_stream, bytes_to_encode);
+              } else if constexpr (is_copy_assignable<std::remove_const_t<std::remove_reference_t<
+                                                          decltype(enc->last_value())>>,
+                                                      T>()) {
+                auto& encoder = *enc;
+                using EncoderType = std::remove_reference_t<decltype(encoder)>;
+                decltype(encoder.last_value()) last_value = points[i];
+                if constexpr (std::is_same_v<EncoderType, LASPointFormat6EncoderV3> ||
+                              std::is_same_v<EncoderType, LASPointFormat6EncoderV4>) {
                   LASPP_ASSERT(layered_compression);
-                  auto& b14_streams = std::get<Byte14OutStreams>(layered_streams[encoder_index]);
-                  std::vector<std::byte> bytes_to_encode(enc.size());
-                  for (size_t j = 0; j < enc.size(); j++) bytes_to_encode[j] = enc[j].last_value();
-                  if constexpr (is_copy_assignable<std::vector<std::byte>, T>()) {
-                    bytes_to_encode = points[i];
-                  } else if constexpr (is_copy_fromable<std::vector<std::byte>, T>()) {
-                    copy_from(bytes_to_encode, points[i]);
-                  }
-                  LASPP_ASSERT_EQ(bytes_to_encode.size(), enc.size());
-                  LASPP_ASSERT(context.has_value(),
-                               "Byte14 encode requires Point14-derived context; ensure item "
-                               "records are ordered so Point14 runs before Byte14.");
-                  for (size_t j = 0; j < enc.size(); j++) {
-                    enc[j].encode(*b14_streams[j], bytes_to_encode[j], context.value());
-                  }
-                } else if constexpr (std::is_same_v<std::decay_t<decltype(*enc)>,
-                                                    RGBNIR14Encoder>) {
+                  auto& streams =
+                      *std::get<std::unique_ptr<LayeredOutStreams<EncoderType::NUM_LAYERS>>>(
+                          layered_streams[encoder_index]);
+                  encoder.encode(streams, last_value);
+                  context = encoder.get_active_context();
+                } else if constexpr (std::is_same_v<EncoderType, RGB14Encoder>) {
                   LASPP_ASSERT(layered_compression);
-                  auto& encoder = *enc;
-                  RGBNIRData last_value = encoder.last_value();
-                  using PointT = std::remove_cv_t<T>;
-                  if constexpr (is_copy_fromable<ColorData, PointT>()) {
-                    copy_from(last_value.rgb, points[i]);
-                  } else if constexpr (is_copy_assignable<ColorData, PointT>()) {
-                    last_value.rgb = points[i];
-                  } else if constexpr (std::is_base_of_v<ColorData, PointT>) {
-                    last_value.rgb = static_cast<const ColorData&>(points[i]);
-                  }
-
-                  if constexpr (is_copy_fromable<NIRData, PointT>()) {
-                    NIRData nir{};
-                    copy_from(nir, points[i]);
-                    last_value.nir = nir.NIR;
-                  } else if constexpr (is_copy_assignable<NIRData, PointT>()) {
-                    NIRData nir = points[i];
-                    last_value.nir = nir.NIR;
-                  } else if constexpr (std::is_base_of_v<NIRData, PointT>) {
-                    last_value.nir = static_cast<const NIRData&>(points[i]).NIR;
-                  }
                   auto& streams =
-                      *std::get<std::unique_ptr<LayeredOutStreams<RGBNIR14Encoder::NUM_LAYERS>>>(
+                      *std::get<std::unique_ptr<LayeredOutStreams<RGB14Encoder::NUM_LAYERS>>>(
                           layered_streams[encoder_index]);
                   encoder.encode(streams, last_value, context.value());
-                } else if constexpr (std::is_same_v<std::decay_t<decltype(*enc)>, BytesEncoder>) {
+                } else {
                   LASPP_ASSERT(!layered_compression);
                   LASPP_ASSERT(compressed_out_stream != nullptr);
-                  auto& encoder = *enc;
-                  std::vector<std::byte> bytes_to_encode = encoder.last_value();
-                  if constexpr (is_copy_assignable<std::vector<std::byte>, T>()) {
-                    bytes_to_encode = points[i];
-                  } else if constexpr (is_copy_fromable<std::vector<std::byte>, T>()) {
-                    copy_from(bytes_to_encode, points[i]);
-                  }
-                  LASPP_ASSERT_EQ(bytes_to_encode.size(), encoder.last_value().size());
-                  encoder.encode(*compressed_out_stream, bytes_to_encode);
-                } else if constexpr (std::is_same_v<std::decay_t<decltype(*enc)>,
-                                                    RawBytesEncoder>) {
-                  LASPP_ASSERT(!layered_compression);
-                  LASPP_ASSERT(compressed_out_stream != nullptr);
-                  auto& encoder = *enc;
-                  std::vector<std::byte> bytes_to_encode = encoder.last_value();
-                  if constexpr (is_copy_assignable<std::vector<std::byte>, T>()) {
-                    bytes_to_encode = points[i];
-                  } else if constexpr (is_copy_fromable<std::vector<std::byte>, T>()) {
-                    copy_from(bytes_to_encode, points[i]);
-                  }
-                  LASPP_ASSERT_EQ(bytes_to_encode.size(), encoder.last_value().size());
-                  encoder.encode(*compressed_out_stream, bytes_to_encode);
-                } else if constexpr (is_copy_assignable<std::remove_const_t<std::remove_reference_t<
-                                                            decltype(enc->last_value())>>,
-                                                        T>()) {
-                  auto& encoder = *enc;
-                  using EncoderType = std::remove_reference_t<decltype(encoder)>;
-                  decltype(encoder.last_value()) last_value = points[i];
-                  if constexpr (std::is_same_v<EncoderType, LASPointFormat6EncoderV3> ||
-                                std::is_same_v<EncoderType, LASPointFormat6EncoderV4>) {
-                    LASPP_ASSERT(layered_compression);
-                    auto& streams =
-                        *std::get<std::unique_ptr<LayeredOutStreams<EncoderType::NUM_LAYERS>>>(
-                            layered_streams[encoder_index]);
-                    encoder.encode(streams, last_value);
-                    context = encoder.get_active_context();
-                  } else if constexpr (std::is_same_v<EncoderType, RGB14Encoder>) {
-                    LASPP_ASSERT(layered_compression);
-                    auto& streams =
-                        *std::get<std::unique_ptr<LayeredOutStreams<RGB14Encoder::NUM_LAYERS>>>(
-                            layered_streams[encoder_index]);
-                    encoder.encode(streams, last_value, context.value());
-                  } else {
-                    LASPP_ASSERT(!layered_compression);
-                    LASPP_ASSERT(compressed_out_stream != nullptr);
-                    encoder.encode(*compressed_out_stream, last_value);
-                  }
+                  encoder.encode(*compressed_out_stream, last_value);
                 }
-              },
-              laz_encoder);
+              }
+            },
+            encoders[encoder_index]);
+      };
+
+      // Items of a layered chunk only depend on each other through the Point14 context, which
+      // follows from the scanner channels alone. Compute that sequence up front and encode item
+      // by item: every item owns its streams, so items can run concurrently.
+      std::vector<uint8_t> contexts;
+      if constexpr (is_copy_assignable<LASPointFormat6, T>()) {
+        if (layered_compression && active_context_after != nullptr) {
+          contexts.resize(points.size());
+          LASPointFormat6 point;
+          point = points[0];
+          uint8_t previous_channel = point.scanner_channel;
+          contexts[0] = previous_channel;
+          for (size_t i = 1; i < points.size(); i++) {
+            point = points[i];
+            contexts[i] = active_context_after(previous_channel, point.scanner_channel);
+            previous_channel = point.scanner_channel;
+          }
+        }
+      }
+
+      if (!contexts.empty()) {
+        auto encode_item = [&](size_t encoder_index) {
+          for (size_t i = 1; i < points.size(); i++) {
+            std::optional<uint8_t> context = contexts[i];
+            encode_point(encoder_index, i, context);
+            LASPP_DEBUG_ASSERT_EQ(context.value(), contexts[i]);
+          }
+        };
+        if (parallel_items && encoders.size() > 1) {
+          utilities::parallel_for(size_t{0}, encoders.size(), encode_item);
+        } else {
+          for (size_t encoder_index = 0; encoder_index < encoders.size(); encoder_index++) {
+            encode_item(encoder_index);
+          }
+        }
+      } else {
+        for (size_t i = 1; i < points.size(); i++) {
+          std::optional<uint8_t> context;
+          for (size_t encoder_index = 0; encoder_index < encoders.size(); encoder_index++) {
+            encode_point(encoder_index, i, context);
+          }
         }
       }
     }
@@ -447,22 +549,99 @@ class LAZWriter {
     return compressed_data;
   }
 
+  // Compresses `points` and writes them as the next chunk. With `index`, behaves like
+  // submit_chunk(index, ...) so that several threads may call it concurrently.
   template <typename T>
   void write_chunk(const std::span<T>& points, std::optional<uint32_t> index = std::nullopt) {
-    std::stringstream compressed_chunk = compress_chunk(points);
-    int64_t compressed_chunk_size = compressed_chunk.tellp();
     LASPP_ASSERT_LT(points.size(), std::numeric_limits<uint32_t>::max());
-    LASPP_ASSERT_LT(compressed_chunk_size, std::numeric_limits<uint32_t>::max());
+    std::string compressed_chunk = compress_chunk(points, true).str();
     if (index.has_value()) {
-      while (index.value() > m_chunk_table.num_chunks()) {
+      submit_chunk(index.value(), static_cast<uint32_t>(points.size()),
+                   std::move(compressed_chunk));
+      return;
+    }
+    write_compressed_chunk(static_cast<uint32_t>(points.size()), compressed_chunk);
+  }
+
+  // Writes an already compressed chunk of `n_points` points as the next chunk, e.g. one copied
+  // verbatim from a LAZ file with the same item records.
+  void write_compressed_chunk(uint32_t n_points, std::string_view compressed_chunk) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    append_chunk(n_points, compressed_chunk);
+    m_chunk_written.notify_all();
+  }
+
+  void set_submission_order(SubmissionOrder order) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    m_submission_order = order;
+  }
+
+  // Thread-safe: hands over a chunk of `n_points` points that the caller compressed with
+  // compress_chunk(), typically on its own thread. Sequence numbers count every chunk of the
+  // file, so chunk `sequence` is written as soon as all chunks before it have been. Chunks that
+  // arrive early are held, reserving their size against the global memory budget; when that
+  // fails the caller waits (without spinning) until its turn comes or memory frees up. In
+  // SubmissionOrder::Completion mode chunks are written immediately and `sequence` is ignored.
+  // Producers should claim sequence numbers in increasing order (e.g. from a shared counter) so
+  // that a waiting producer never holds back the chunk it is waiting for.
+  void submit_chunk(size_t sequence, uint32_t n_points, std::string compressed_chunk) {
+    std::unique_lock<std::mutex> lock(m_write_mutex);
+    if (m_submission_order == SubmissionOrder::Sequential) {
+      LASPP_ASSERT_GE(sequence, m_chunk_table.num_chunks(), "Chunk was already written");
+      LASPP_ASSERT(!m_held_chunks.contains(sequence), "Chunk ", sequence, " submitted twice");
+      if (sequence != m_chunk_table.num_chunks()) {
+        std::optional<utilities::MemoryReservation> reservation;
+        m_chunk_written.wait(lock, [&]() {
+          return sequence == m_chunk_table.num_chunks() ||
+                 (reservation = utilities::MemoryReservation::try_reserve(
+                      utilities::get_memory_budget(), compressed_chunk.size()))
+                     .has_value();
+        });
+        if (sequence != m_chunk_table.num_chunks()) {
+          m_held_chunks.emplace(
+              sequence, HeldChunk{n_points, std::move(compressed_chunk), std::move(*reservation)});
+          return;
+        }
       }
     }
-    m_chunk_table.add_chunk(static_cast<uint32_t>(points.size()),
-                            static_cast<uint32_t>(compressed_chunk_size));
-    m_stream.write(compressed_chunk.str().c_str(), compressed_chunk_size);
-    m_special_vlr.chunk_size = m_chunk_table.constant_chunk_size().has_value()
-                                   ? m_chunk_table.constant_chunk_size().value()
-                                   : std::numeric_limits<uint32_t>::max();
+
+    append_chunk(n_points, compressed_chunk);
+    for (auto it = m_held_chunks.begin();
+         it != m_held_chunks.end() && it->first == m_chunk_table.num_chunks();
+         it = m_held_chunks.erase(it)) {
+      append_chunk(it->second.n_points, it->second.compressed_data);
+    }
+    m_chunk_written.notify_all();
+  }
+
+  // Chunks submitted ahead of a missing predecessor and not yet written.
+  size_t num_held_chunks() {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    return m_held_chunks.size();
+  }
+
+  // Keeps only the chunks holding the first `n_points` points, which must end on a chunk
+  // boundary, dropping later and held chunks, and moves the write position back to the end of
+  // the kept chunks. The stream cannot shrink: the next chunk or the chunk table overwrites the
+  // dropped bytes, and any left beyond the end of the file's content stay as unreferenced
+  // trailing bytes until whoever owns the file resizes it. Used to finalise the chunks written
+  // before a write failed.
+  void truncate(uint64_t n_points) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    m_held_chunks.clear();
+    LAZChunkTable kept;
+    uint64_t kept_points = 0;
+    uint64_t end_offset = sizeof(int64_t);  // after the chunk table offset
+    for (size_t i = 0; i < m_chunk_table.num_chunks() && kept_points < n_points; i++) {
+      const LAZChunkTable::ChunkLocation chunk = m_chunk_table.chunk(i);
+      kept.add_chunk(chunk.n_points, chunk.compressed_size);
+      kept_points += chunk.n_points;
+      end_offset = chunk.compressed_offset + chunk.compressed_size;
+    }
+    LASPP_ASSERT_EQ(kept_points, n_points, "Point count does not end on a chunk boundary");
+    m_chunk_table = std::move(kept);
+    update_chunk_size();
+    m_stream.seekp(m_initial_stream_offset + static_cast<int64_t>(end_offset));
   }
 
   template <typename T>
@@ -475,41 +654,93 @@ class LAZWriter {
       uint32_t points_count;
     };
 
-    std::vector<std::future<ChunkResult>> compression_futures;
-    compression_futures.reserve(chunks.size());
+    struct InFlightChunk {
+      std::future<ChunkResult> result;
+      utilities::MemoryReservation reservation;
+    };
+
+    // Each in-flight chunk reserves room for its compressed payload (bounded by roughly the
+    // raw point size, held twice while the stringstream is copied out). Under memory pressure
+    // fewer chunks are kept in flight; the oldest is written out before launching another.
+    utilities::MemoryBudget& budget = utilities::get_memory_budget();
+    std::deque<InFlightChunk> in_flight;
+
+    // With fewer chunks than threads, also spread the items of each chunk across the pool.
+    const bool parallel_items = chunks.size() < utilities::get_num_threads();
+
+    auto write_oldest = [this, &in_flight]() {
+      ChunkResult result = in_flight.front().result.get();
+      {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        append_chunk(result.points_count,
+                     std::string_view(result.payload).substr(0, result.compressed_size));
+        m_chunk_written.notify_all();
+      }
+      in_flight.pop_front();
+    };
 
     for (size_t i = 0; i < chunks.size(); i++) {
-      compression_futures.push_back(
-          std::async(std::launch::async, [this, chunk = chunks[i]]() -> ChunkResult {
-            std::stringstream compressed_chunk = compress_chunk(chunk);
-            int64_t compressed_chunk_size = compressed_chunk.tellp();
-            LASPP_ASSERT_LT(chunk.size(), std::numeric_limits<uint32_t>::max());
-            LASPP_ASSERT_LT(compressed_chunk_size, std::numeric_limits<uint32_t>::max());
-
-            ChunkResult result;
-            result.payload = compressed_chunk.str();
-            result.compressed_size = static_cast<uint32_t>(compressed_chunk_size);
-            result.points_count = static_cast<uint32_t>(chunk.size());
-            return result;
-          }));
+      utilities::check_cancellation();
+      const size_t payload_estimate = 2 * chunks[i].size() * sizeof(T);
+      std::optional<utilities::MemoryReservation> reservation;
+      while (!(reservation = utilities::MemoryReservation::try_reserve(budget, payload_estimate))) {
+        if (in_flight.empty()) {
+          reservation.emplace(budget, payload_estimate, "LAZ chunk compression");
+          break;
+        }
+        write_oldest();
+      }
+
+      in_flight.push_back(InFlightChunk{
+          std::async(std::launch::async,
+                     utilities::with_current_cancellation(
+                         [this, chunk = chunks[i], parallel_items]() -> ChunkResult {
+                           std::stringstream compressed_chunk =
+                               compress_chunk(chunk, parallel_items);
+                           int64_t compressed_chunk_size = compressed_chunk.tellp();
+                           LASPP_ASSERT_LT(chunk.size(), std::numeric_limits<uint32_t>::max());
+                           LASPP_ASSERT_LT(compressed_chunk_size,
+                                           std::numeric_limits<uint32_t>::max());
+
+                           ChunkResult result;
+                           result.payload = compressed_chunk.str();
+                           result.compressed_size = static_cast<uint32_t>(compressed_chunk_size);
+                           result.points_count = static_cast<uint32_t>(chunk.size());
+                           return result;
+                         })),
+          std::move(*reservation)});
     }
 
-    for (size_t i = 0; i < chunks.size(); i++) {
-      ChunkResult result = compression_futures[i].get();
-      m_chunk_table.add_chunk(result.points_count, result.compressed_size);
-      m_stream.write(result.payload.data(), static_cast<std::streamsize>(result.compressed_size));
-      m_special_vlr.chunk_size = m_chunk_table.constant_chunk_size().has_value()
-                                     ? m_chunk_table.constant_chunk_size().value()
-                                     : std::numeric_limits<uint32_t>::max();
+    while (!in_flight.empty()) {
+      write_oldest();
     }
   }
 
-  ~LAZWriter() {
+  // Writes the chunk table after the last chunk and points the chunk table offset at it.
+  // Throws if a sequence number was never submitted, leaving later chunks held back. Called by
+  // the destructor unless called before; the destructor cannot report missing chunks, so it
+  // then leaves the chunk table unwritten and the output invalid.
+  void finish() {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    if (m_finished) {
+      return;
+    }
+    LASPP_ASSERT(m_held_chunks.empty(), "Chunk ", m_chunk_table.num_chunks(),
+                 " was never submitted, holding back ", m_held_chunks.size(), " later chunks");
     int64_t chunk_table_offset = m_stream.tellp();
     m_chunk_table.write(m_stream);
+    // Not the end of the stream, which after truncate() may still hold dropped chunks
+    const std::streampos end = m_stream.tellp();
     m_stream.seekp(m_initial_stream_offset);
     m_stream.write(reinterpret_cast<const char*>(&chunk_table_offset), sizeof(chunk_table_offset));
-    m_stream.seekp(0, std::ios::end);
+    m_stream.seekp(end);
+    m_finished = true;
+  }
+
+  ~LAZWriter() {
+    if (!m_finished && m_held_chunks.empty()) {
+      finish();
+    }
   }
 };
 
@@ -377,6 +377,17 @@ class LASPointFormat6EncoderBase {
 
   uint8_t get_active_context() const { return m_external_context; }
 
+  // Active context after encoding a point on `scanner_channel` when the previous point was on
+  // `previous_channel`. Depends only on the scanner channels, so the context sequence the other
+  // layered items need can be computed for a whole chunk without running this encoder.
+  static uint8_t active_context_after(uint8_t previous_channel, uint8_t scanner_channel) {
+    if (scanner_channel != previous_channel) {
+      return scanner_channel;
+    }
+    // Workaround for issue with context setting in V3 (see encode()).
+    return Version == 3 ? 0 : scanner_channel;
+  }
+
  private:
   inline void handle_scanner_channel_context_change(LASPointFormat6Context& prev_context,
                                                     uint_fast16_t changed_values,
@@ -130,7 +130,18 @@ class InStream : StreamVariables {
   }
 
  public:
-  InStream(const InStream&) = delete;
+  // Copying snapshots the decoder position (see LAZChunkDecoder). A copy of a stream that owns
+  // its data gets its own buffer; otherwise both read the same in-memory data.
+  InStream(const InStream& other)
+      : StreamVariables(other),
+        m_ptr(other.m_ptr),
+        m_end(other.m_end),
+        m_owned_data(other.m_owned_data) {
+    if (!m_owned_data.empty()) {
+      m_ptr = m_owned_data.data() + (other.m_ptr - other.m_owned_data.data());
+      m_end = m_owned_data.data() + m_owned_data.size();
+    }
+  }
   InStream& operator=(const InStream&) = delete;
   InStream(InStream&&) = delete;
   InStream& operator=(InStream&&) = delete;
@@ -168,6 +179,17 @@ class InStream : StreamVariables {
 
   uint32_t length() const noexcept { return m_length; }
 
+  // Bytes read so far from `begin`, the start of the data, counting those the next
+  // renormalisation reads: the encoder renormalises after each symbol, the decoder only before
+  // the next one. Past the end of the data once decoding has run beyond it.
+  size_t bytes_read(const std::byte* begin) const noexcept {
+    const size_t pending = m_length < (1u << 8)    ? 3
+                           : m_length < (1u << 16) ? 2
+                           : m_length < (1u << 24) ? 1
+                                                   : 0;
+    return static_cast<size_t>(m_ptr - begin) + pending;
+  }
+
   void update_range(uint32_t lower, uint32_t upper) noexcept {
     m_value -= lower;
     m_length = upper - lower;
@@ -5,6 +5,8 @@
 
 #include <cstring>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 #include "laz/chunktable.hpp"
 
@@ -64,5 +66,95 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     LASPP_ASSERT(!read_chunktable.constant_chunk_size().has_value(), "Expected empty optional");
   }
 
+  // Large tables: offsets are built block-wise in parallel and match a serial prefix sum
+  for (bool constant : {true, false}) {
+    constexpr uint32_t N_CHUNKS = 200000;
+    LAZChunkTable chunktable;
+    for (uint32_t i = 0; i < N_CHUNKS; i++) {
+      const uint32_t n_points = constant ? (i + 1 == N_CHUNKS ? 7u : 50u) : 1u + i % 97u;
+      chunktable.add_chunk(n_points, 100u + (i * 7919u) % 1000u);
+    }
+    LASPP_ASSERT_EQ(chunktable.constant_chunk_size().has_value(), constant);
+
+    std::stringstream ss;
+    chunktable.write(ss);
+    const size_t total_points = chunktable.decompressed_chunk_offset(N_CHUNKS - 1) +
+                                chunktable.points_in_chunk(N_CHUNKS - 1);
+    LAZChunkTable read_chunktable(ss, chunktable.constant_chunk_size(), total_points);
+    LASPP_ASSERT_EQ(read_chunktable.num_chunks(), N_CHUNKS);
+
+    uint64_t compressed_offset = 8;
+    uint64_t first_point = 0;
+    for (uint32_t i = 0; i < N_CHUNKS; i++) {
+      LAZChunkTable::ChunkLocation chunk = read_chunktable.chunk(i);
+      LASPP_ASSERT_EQ(chunk.compressed_offset, compressed_offset);
+      LASPP_ASSERT_EQ(chunk.compressed_size, 100u + (i * 7919u) % 1000u);
+      LASPP_ASSERT_EQ(chunk.first_point, first_point);
+      LASPP_ASSERT_EQ(chunk.n_points, chunktable.points_in_chunk(i));
+      LASPP_ASSERT_EQ(read_chunktable.chunk_offset(i), compressed_offset);
+      LASPP_ASSERT_EQ(read_chunktable.chunk_containing_point(first_point), i);
+      LASPP_ASSERT_EQ(read_chunktable.chunk_containing_point(first_point + chunk.n_points - 1), i);
+      compressed_offset += chunk.compressed_size;
+      first_point += chunk.n_points;
+    }
+    LASPP_ASSERT_EQ(read_chunktable.chunk_containing_point(first_point + 1000), N_CHUNKS - 1);
+    LASPP_ASSERT_THROWS(read_chunktable.chunk_offset(N_CHUNKS), std::out_of_range);
+  }
+
+  // A writer table falls back to per-chunk counts once the chunk size stops being constant
+  {
+    LAZChunkTable chunktable;
+    chunktable.add_chunk(100, 10);
+    chunktable.add_chunk(100, 20);
+    chunktable.add_chunk(60, 30);
+    LASPP_ASSERT_EQ(chunktable.constant_chunk_size(), 100);
+    chunktable.add_chunk(100, 40);
+    LASPP_ASSERT(!chunktable.constant_chunk_size().has_value(), "Expected empty optional");
+
+    const std::vector<size_t> expected_points = {100, 100, 60, 100};
+    const std::vector<size_t> expected_offsets = {0, 100, 200, 260};
+    LASPP_ASSERT_EQ(chunktable.points_per_chunk(), expected_points);
+    LASPP_ASSERT_EQ(chunktable.decompressed_chunk_offsets(), expected_offsets);
+    LASPP_ASSERT_EQ(chunktable.chunk_containing_point(259), 2u);
+    LASPP_ASSERT_EQ(chunktable.chunk_containing_point(260), 3u);
+    LASPP_ASSERT_EQ(chunktable.chunk(3).compressed_offset, 8u + 10u + 20u + 30u);
+  }
+
+  // ... and as soon as a later chunk is larger than the first
+  {
+    LAZChunkTable chunktable;
+    chunktable.add_chunk(500, 10);
+    chunktable.add_chunk(1000, 20);
+    LASPP_ASSERT(!chunktable.constant_chunk_size().has_value(), "Expected empty optional");
+
+    const std::vector<size_t> expected_points = {500, 1000};
+    const std::vector<size_t> expected_offsets = {0, 500};
+    LASPP_ASSERT_EQ(chunktable.points_per_chunk(), expected_points);
+    LASPP_ASSERT_EQ(chunktable.decompressed_chunk_offsets(), expected_offsets);
+    LASPP_ASSERT_EQ(chunktable.chunk_containing_point(499), 0u);
+    LASPP_ASSERT_EQ(chunktable.chunk_containing_point(1499), 1u);
+
+    std::stringstream ss;
+    chunktable.write(ss);
+    LAZChunkTable read_chunktable(ss, chunktable.constant_chunk_size(), 1500);
+    LASPP_ASSERT_EQ(read_chunktable.points_per_chunk(), expected_points);
+  }
+
+  // Point lookups past 2^32 resolve to the right chunk in both table layouts
+  {
+    constexpr uint32_t BIG_CHUNK = uint32_t{1} << 31;
+    LAZChunkTable constant_table;
+    LAZChunkTable variable_table;
+    for (size_t i = 0; i < 4; i++) {
+      constant_table.add_chunk(BIG_CHUNK, 10);
+      variable_table.add_chunk(i == 0 ? 5u : BIG_CHUNK, 10);
+    }
+    LASPP_ASSERT_EQ(constant_table.chunk_containing_point(uint64_t{1} << 32), 2u);
+    LASPP_ASSERT_EQ(constant_table.chunk_containing_point((uint64_t{3} << 31) + 1), 3u);
+    LASPP_ASSERT_EQ(variable_table.chunk_containing_point((uint64_t{1} << 32) + 4), 2u);
+    LASPP_ASSERT_EQ(variable_table.chunk_containing_point((uint64_t{1} << 32) + 5), 3u);
+    LASPP_ASSERT_EQ(variable_table.decompressed_chunk_offset(3), (uint64_t{1} << 32) + 5);
+  }
+
   return 0;
 }
@@ -69,5 +69,35 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     }
   }
 
+  // Copies (including the shared models of multi-instance encoders) continue independently
+  {
+    std::stringstream encoded_stream;
+    {
+      laspp::OutStream ostream(encoded_stream);
+      laspp::MultiInstanceIntegerEncoder<32, 2> int_encoder;
+      for (int32_t i = 0; i < 2000; i++) {
+        int_encoder.encode_int(static_cast<uint32_t>(i % 2), ostream, i * 37 - 5000);
+      }
+    }
+    {
+      laspp::InStream instream(encoded_stream);
+      laspp::MultiInstanceIntegerEncoder<32, 2> int_encoder;
+      for (int32_t i = 0; i < 1000; i++) {
+        LASPP_ASSERT_EQ(int_encoder.decode_int(static_cast<uint32_t>(i % 2), instream),
+                        i * 37 - 5000);
+      }
+      laspp::InStream instream_copy(instream);
+      laspp::MultiInstanceIntegerEncoder<32, 2> int_encoder_copy(int_encoder);
+      for (int32_t i = 1000; i < 2000; i++) {
+        LASPP_ASSERT_EQ(int_encoder.decode_int(static_cast<uint32_t>(i % 2), instream),
+                        i * 37 - 5000);
+      }
+      for (int32_t i = 1000; i < 2000; i++) {
+        LASPP_ASSERT_EQ(int_encoder_copy.decode_int(static_cast<uint32_t>(i % 2), instream_copy),
+                        i * 37 - 5000);
+      }
+    }
+  }
+
   return 0;
 }
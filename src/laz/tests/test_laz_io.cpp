@@ -5,10 +5,14 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <numeric>
 #include <random>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 #include "las_point.hpp"
 #include "laz/laz_reader.hpp"
@@ -309,5 +313,274 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     }
   }
 
+  // Encoding the items of a layered chunk concurrently produces identical bytes
+  {
+    std::mt19937_64 gen(31337);
+    std::vector<LASPointFormat7WithExtra> points;
+    for (size_t i = 0; i < 5000; i++) {
+      points.push_back(LASPointFormat7WithExtra::RandomData(gen));
+    }
+    std::vector<LASPointFormat8> points8;
+    for (size_t i = 0; i < 5000; i++) {
+      points8.push_back(LASPointFormat8::RandomData(gen));
+    }
+
+    for (LAZItemVersion version : {LAZItemVersion::Version3, LAZItemVersion::Version4}) {
+      std::stringstream stream;
+      LAZWriter writer(stream, LAZCompressor::LayeredChunked);
+      for (LAZItemRecord record :
+           {LAZItemRecord(LAZItemType::Point14), LAZItemRecord(LAZItemType::RGB14),
+            LAZItemRecord(LAZItemType::Byte14, LASPointFormat7WithExtra::ExtraSize)}) {
+        record.item_version = version;
+        writer.special_vlr().add_item_record(record);
+      }
+
+      std::string serial =
+          writer.compress_chunk(std::span<LASPointFormat7WithExtra>(points), false).str();
+      std::string parallel =
+          writer.compress_chunk(std::span<LASPointFormat7WithExtra>(points), true).str();
+      LASPP_ASSERT_EQ(serial.size(), parallel.size());
+      LASPP_ASSERT(serial == parallel);
+    }
+
+    {
+      std::stringstream stream;
+      LAZWriter writer(stream, LAZCompressor::LayeredChunked);
+      writer.special_vlr().add_item_record(LAZItemRecord(LAZItemType::Point14));
+      writer.special_vlr().add_item_record(LAZItemRecord(LAZItemType::RGBNIR14));
+      std::string serial = writer.compress_chunk(std::span<LASPointFormat8>(points8), false).str();
+      std::string parallel = writer.compress_chunk(std::span<LASPointFormat8>(points8), true).str();
+      LASPP_ASSERT(serial == parallel);
+    }
+  }
+
+  // A chunk decoder copied mid-chunk resumes exactly where the original stands
+  {
+    std::mt19937_64 gen(80);
+    std::vector<LASPointFormat1> points1;
+    std::vector<LASPointFormat7WithExtra> points7;
+    for (size_t i = 0; i < 3000; i++) {
+      points1.push_back(LASPointFormat1::RandomData(gen));
+      points7.push_back(LASPointFormat7WithExtra::RandomData(gen));
+    }
+
+    auto check_resume = [](LAZWriter& writer, auto& points) {
+      using PointType = typename std::remove_reference_t<decltype(points)>::value_type;
+      std::string compressed = writer.compress_chunk(std::span<PointType>(points)).str();
+      std::span<const std::byte> compressed_data(
+          reinterpret_cast<const std::byte*>(compressed.data()), compressed.size());
+      LAZReader reader(writer.special_vlr());
+
+      LAZChunkDecoder decoder = reader.chunk_decoder(compressed_data, points.size());
+      std::vector<PointType> decoded(points.size());
+      decoder.decode(std::span<PointType>(decoded).subspan(0, 1000));
+      LAZChunkDecoder checkpoint(decoder);
+      LASPP_ASSERT_EQ(checkpoint.next_point(), 1000u);
+      decoder.decode(std::span<PointType>(decoded).subspan(1000));
+
+      std::vector<PointType> resumed(points.size() - 1000);
+      checkpoint.decode(std::span<PointType>(resumed));
+      for (size_t i = 0; i < points.size(); i++) {
+        LASPP_ASSERT(decoded[i] == points[i]);
+      }
+      for (size_t i = 0; i < resumed.size(); i++) {
+        LASPP_ASSERT(resumed[i] == points[1000 + i]);
+      }
+
+      LAZChunkDecoder skipping = reader.chunk_decoder(compressed_data, points.size());
+      skipping.skip(2500);
+      std::vector<PointType> one(1);
+      skipping.decode(std::span<PointType>(one));
+      LASPP_ASSERT(one[0] == points[2500]);
+      LASPP_ASSERT_EQ(skipping.next_point(), 2501u);
+    };
+
+    {
+      std::stringstream stream;
+      LAZWriter writer(stream, LAZCompressor::PointwiseChunked);
+      writer.special_vlr().add_item_record(LAZItemRecord(LAZItemType::Point10));
+      writer.special_vlr().add_item_record(LAZItemRecord(LAZItemType::GPSTime11));
+      check_resume(writer, points1);
+    }
+    {
+      std::stringstream stream;
+      LAZWriter writer(stream, LAZCompressor::LayeredChunked);
+      writer.special_vlr().add_item_record(LAZItemRecord(LAZItemType::Point14));
+      writer.special_vlr().add_item_record(LAZItemRecord(LAZItemType::RGB14));
+      writer.special_vlr().add_item_record(
+          LAZItemRecord(LAZItemType::Byte14, LASPointFormat7WithExtra::ExtraSize));
+      check_resume(writer, points7);
+    }
+  }
+
+  // Several producers compress chunks concurrently and submit them to one writer
+  {
+    constexpr size_t n_chunks = 24;
+    constexpr size_t chunk_size = 400;
+    std::mt19937_64 gen(81);
+    std::vector<LASPointFormat1> points(n_chunks * chunk_size);
+    for (LASPointFormat1& point : points) {
+      point = LASPointFormat1::RandomData(gen);
+    }
+    auto chunk = [&](size_t c) {
+      return std::span<LASPointFormat1>(points).subspan(c * chunk_size, chunk_size);
+    };
+    auto add_items = [](LAZWriter& writer) {
+      writer.special_vlr().add_item_record(LAZItemRecord(LAZItemType::Point10));
+      writer.special_vlr().add_item_record(LAZItemRecord(LAZItemType::GPSTime11));
+    };
+
+    std::stringstream expected_stream;
+    {
+      LAZWriter writer(expected_stream, LAZCompressor::PointwiseChunked);
+      add_items(writer);
+      for (size_t c = 0; c < n_chunks; c++) {
+        writer.write_chunk(chunk(c));
+      }
+    }
+
+    // Producers claim chunks in order but finish out of order. With a budget too small to hold
+    // any early chunk, producers wait for their turn instead.
+    utilities::MemoryBudget& budget = utilities::get_memory_budget();
+    const std::optional<size_t> original_limit = budget.limit();
+    for (std::optional<size_t> limit : {std::optional<size_t>(), std::optional<size_t>(1)}) {
+      budget.set_limit(limit);
+      std::stringstream stream;
+      {
+        LAZWriter writer(stream, LAZCompressor::PointwiseChunked);
+        add_items(writer);
+        std::atomic<size_t> next_chunk{0};
+        std::vector<std::thread> producers;
+        for (size_t t = 0; t < 4; t++) {
+          producers.emplace_back([&, t]() {
+            for (size_t c; (c = next_chunk++) < n_chunks;) {
+              std::string compressed = writer.compress_chunk(chunk(c)).str();
+              std::this_thread::sleep_for(std::chrono::milliseconds((t * 7 + c) % 5));
+              writer.submit_chunk(c, chunk_size, std::move(compressed));
+            }
+          });
+        }
+        for (std::thread& producer : producers) producer.join();
+        LASPP_ASSERT_EQ(writer.num_held_chunks(), 0u);
+      }
+      LASPP_ASSERT(stream.str() == expected_stream.str());
+    }
+    budget.set_limit(original_limit);
+
+    // Any submission order, including the reverse, yields the same file
+    {
+      std::stringstream stream;
+      {
+        LAZWriter writer(stream, LAZCompressor::PointwiseChunked);
+        add_items(writer);
+        for (size_t c = n_chunks; c-- > 1;) {
+          writer.submit_chunk(c, chunk_size, writer.compress_chunk(chunk(c)).str());
+        }
+        LASPP_ASSERT_EQ(writer.num_held_chunks(), n_chunks - 1);
+        writer.write_chunk(chunk(0), 0);
+        LASPP_ASSERT_EQ(writer.num_held_chunks(), 0u);
+      }
+      LASPP_ASSERT(stream.str() == expected_stream.str());
+    }
+
+    // Finishing with a sequence number never submitted throws, and the destructor then leaves
+    // the chunk table offset unset
+    {
+      std::stringstream stream;
+      {
+        LAZWriter writer(stream, LAZCompressor::PointwiseChunked);
+        add_items(writer);
+        writer.write_chunk(chunk(0), 0);
+        writer.submit_chunk(2, chunk_size, writer.compress_chunk(chunk(2)).str());
+        LASPP_ASSERT_THROWS(writer.finish(), std::runtime_error);
+        LASPP_ASSERT_EQ(writer.num_held_chunks(), 1u);
+      }
+      int64_t chunk_table_offset = 0;
+      stream.seekg(0);
+      stream.read(reinterpret_cast<char*>(&chunk_table_offset), sizeof(chunk_table_offset));
+      LASPP_ASSERT_EQ(chunk_table_offset, -1);
+    }
+
+    // Truncating drops later and held chunks, and writing resumes after the chunks kept
+    {
+      std::stringstream stream;
+      {
+        LAZWriter writer(stream, LAZCompressor::PointwiseChunked);
+        add_items(writer);
+        for (size_t c = 0; c < 10; c++) {
+          writer.write_chunk(chunk(c));
+        }
+        writer.submit_chunk(12, chunk_size, writer.compress_chunk(chunk(12)).str());
+        writer.truncate(6 * chunk_size);
+        LASPP_ASSERT_EQ(writer.chunk_table().num_chunks(), 6u);
+        LASPP_ASSERT_EQ(writer.num_held_chunks(), 0u);
+        for (size_t c = 6; c < n_chunks; c++) {
+          writer.write_chunk(chunk(c));
+        }
+      }
+      LASPP_ASSERT(stream.str() == expected_stream.str());
+    }
+
+    // Truncating without writing on leaves the dropped chunks' bytes after the chunk table, and
+    // the write position at its end, where the owner of the file can cut it
+    {
+      std::stringstream stream;
+      std::unique_ptr<LAZSpecialVLRContent> laz_special_vlr;
+      std::streampos end;
+      {
+        LAZWriter writer(stream, LAZCompressor::PointwiseChunked);
+        add_items(writer);
+        for (size_t c = 0; c < n_chunks; c++) {
+          writer.write_chunk(chunk(c));
+        }
+        writer.truncate(3 * chunk_size);
+        writer.finish();
+        end = stream.tellp();
+        laz_special_vlr = std::make_unique<LAZSpecialVLRContent>(writer.special_vlr());
+      }
+      const std::string data = stream.str();
+      LASPP_ASSERT_LT(static_cast<size_t>(end), data.size());
+      std::istringstream cut(data.substr(0, static_cast<size_t>(end)));
+      LAZReader chunk_reader(*laz_special_vlr);
+      chunk_reader.read_chunk_table(cut, 3 * chunk_size);
+      LASPP_ASSERT_EQ(chunk_reader.chunk_table().num_chunks(), 3u);
+      LASPP_ASSERT(!cut.fail());
+    }
+
+    // Completion order writes chunks as they arrive
+    {
+      std::stringstream stream;
+      std::vector<size_t> order(n_chunks);
+      std::iota(order.begin(), order.end(), size_t{0});
+      std::shuffle(order.begin(), order.end(), gen);
+      std::unique_ptr<LAZSpecialVLRContent> laz_special_vlr;
+      {
+        LAZWriter writer(stream, LAZCompressor::PointwiseChunked);
+        add_items(writer);
+        writer.set_submission_order(LAZWriter::SubmissionOrder::Completion);
+        for (size_t c : order) {
+          writer.submit_chunk(c, chunk_size, writer.compress_chunk(chunk(c)).str());
+          LASPP_ASSERT_EQ(writer.num_held_chunks(), 0u);
+        }
+        laz_special_vlr = std::make_unique<LAZSpecialVLRContent>(writer.special_vlr());
+      }
+
+      LAZReader chunk_reader(*laz_special_vlr);
+      chunk_reader.read_chunk_table(stream, points.size());
+      LASPP_ASSERT_EQ(chunk_reader.chunk_table().num_chunks(), n_chunks);
+      std::string data = stream.str();
+      std::vector<LASPointFormat1> decoded(chunk_size);
+      for (size_t i = 0; i < n_chunks; i++) {
+        std::span<const std::byte> compressed(
+            reinterpret_cast<const std::byte*>(data.data()) +
+                chunk_reader.chunk_table().chunk_offset(i),
+            chunk_reader.chunk_table().compressed_chunk_size(i));
+        chunk_reader.decompress_chunk(compressed, std::span<LASPointFormat1>(decoded));
+        const std::span<LASPointFormat1> expected = chunk(order[i]);
+        LASPP_ASSERT(std::equal(decoded.begin(), decoded.end(), expected.begin()));
+      }
+    }
+  }
+
   return 0;
 }
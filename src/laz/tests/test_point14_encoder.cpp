@@ -82,5 +82,31 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     }
   }
 
+  // The active context sequence can be derived from the scanner channels alone
+  {
+    std::mt19937_64 gen(7);
+    std::vector<LASPointFormat6> points;
+    for (size_t i = 0; i < 1000; i++) {
+      points.push_back(LASPointFormat6::RandomData(gen));
+      if (i % 3 != 0 && i > 0) {
+        // Keep some runs on the same channel
+        points.back().scanner_channel = points[i - 1].scanner_channel;
+      }
+    }
+
+    auto check_contexts = [&points](auto encoder) {
+      using EncoderType = decltype(encoder);
+      typename EncoderType::LayerOutStreams out_streams;
+      for (size_t i = 1; i < points.size(); i++) {
+        encoder.encode(out_streams, points[i]);
+        LASPP_ASSERT_EQ(encoder.get_active_context(),
+                        EncoderType::active_context_after(points[i - 1].scanner_channel,
+                                                          points[i].scanner_channel));
+      }
+    };
+    check_contexts(LASPointFormat6EncoderV3(points[0]));
+    check_contexts(LASPointFormat6EncoderV4(points[0]));
+  }
+
   return 0;
 }
@@ -3,7 +3,9 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <cstdint>
 #include <cstring>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
@@ -404,5 +406,34 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     LASPP_ASSERT(caught, "Expected std::runtime_error for duplicate cell_index");
   }
 
+  // Point indices beyond 32 bits are held in memory but cannot be written as LAX
+  {
+    constexpr uint64_t FIRST_POINT = (uint64_t{1} << 32) + 10;
+    QuadtreeSpatialIndex index;
+    index.add_cell(3, {{0, 9}, {FIRST_POINT, FIRST_POINT + 4}});
+    const auto& cell = index.cells().at(3);
+    LASPP_ASSERT_EQ(cell.number_points, 15u);
+    LASPP_ASSERT_EQ(cell.intervals[1].start, FIRST_POINT);
+    LASPP_ASSERT(!index.is_lax_representable());
+
+    std::stringstream ss;
+    bool caught = false;
+    try {
+      index.write(ss);
+    } catch (const std::runtime_error& e) {
+      caught = std::string(e.what()).find("32-bit") != std::string::npos;
+    }
+    LASPP_ASSERT(caught, "Expected std::runtime_error for out-of-range LAX point index");
+
+    QuadtreeSpatialIndex small_index;
+    small_index.add_cell(3, {{0, 9}, {100, std::numeric_limits<uint32_t>::max()}});
+    LASPP_ASSERT(small_index.is_lax_representable());
+    std::stringstream small_ss;
+    small_index.write(small_ss);
+    QuadtreeSpatialIndex read_index(small_ss);
+    LASPP_ASSERT_EQ(read_index.cells().at(3).intervals[1].end,
+                    uint64_t{std::numeric_limits<uint32_t>::max()});
+  }
+
   return 0;
 }
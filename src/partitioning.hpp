@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "point_pipeline.hpp"
+#include "utilities/assert.hpp"
+
+namespace laspp {
+
+// A contiguous range of a file's points, for one worker of a partitioned conversion. For LAZ
+// input the range covers whole chunks [first_chunk, end_chunk); LAS input has a single chunk.
+struct PartitionRange {
+  size_t first_chunk;
+  size_t end_chunk;
+  uint64_t first_point;
+  uint64_t end_point;
+  uint64_t bytes;  // compressed bytes for LAZ, point record bytes for LAS
+
+  uint64_t num_points() const { return end_point - first_point; }
+
+  friend std::ostream& operator<<(std::ostream& os, const PartitionRange& range) {
+    return os << "chunks [" << range.first_chunk << ", " << range.end_chunk << ") points ["
+              << range.first_point << ", " << range.end_point << ") bytes " << range.bytes;
+  }
+};
+
+// Splits the points of `reader` into at most `n_partitions` consecutive, non-empty ranges of
+// about equal size. LAZ files are split on chunk boundaries, balancing the compressed bytes
+// from the chunk table, so each worker decodes about the same amount of data; LAS files are
+// split evenly by point count. Fewer ranges are returned if there are not enough chunks.
+inline std::vector<PartitionRange> plan_partitions(const LASReader& reader, size_t n_partitions) {
+  LASPP_ASSERT_GT(n_partitions, 0u);
+  std::vector<PartitionRange> partitions;
+  if (!reader.header().is_laz_compressed()) {
+    const uint64_t n_points = reader.num_points();
+    const uint64_t record_length = reader.header().point_data_record_length();
+    const uint64_t n = std::max<uint64_t>(1, std::min<uint64_t>(n_partitions, n_points));
+    for (uint64_t k = 0; k < n; k++) {
+      const uint64_t first_point = n_points * k / n;
+      const uint64_t end_point = n_points * (k + 1) / n;
+      partitions.push_back(
+          {0, 1, first_point, end_point, (end_point - first_point) * record_length});
+    }
+    return partitions;
+  }
+
+  const std::vector<size_t> sizes = reader.compressed_chunk_sizes();
+  const std::vector<size_t> points_per_chunk = reader.points_per_chunk();
+  const size_t n_chunks = sizes.size();
+  std::vector<uint64_t> byte_prefix(n_chunks + 1, 0);
+  std::vector<uint64_t> point_prefix(n_chunks + 1, 0);
+  for (size_t c = 0; c < n_chunks; c++) {
+    byte_prefix[c + 1] = byte_prefix[c] + sizes[c];
+    point_prefix[c + 1] = point_prefix[c] + points_per_chunk[c];
+  }
+  const size_t n = std::max<size_t>(1, std::min(n_partitions, n_chunks));
+  size_t first_chunk = 0;
+  for (size_t k = 1; k <= n; k++) {
+    size_t end_chunk = n_chunks;
+    if (k < n) {
+      // The chunk boundary closest to the k-th fraction of the bytes, leaving at least one chunk
+      // for this and every later partition
+      const uint64_t target = byte_prefix[n_chunks] * k / n;
+      end_chunk = static_cast<size_t>(
+          std::lower_bound(byte_prefix.begin(), byte_prefix.end(), target) - byte_prefix.begin());
+      if (end_chunk > 0 && target - byte_prefix[end_chunk - 1] < byte_prefix[end_chunk] - target) {
+        end_chunk--;
+      }
+      end_chunk = std::clamp(end_chunk, first_chunk + 1, n_chunks - (n - k));
+    }
+    partitions.push_back({first_chunk, end_chunk, point_prefix[first_chunk],
+                          point_prefix[end_chunk],
+                          byte_prefix[end_chunk] - byte_prefix[first_chunk]});
+    first_chunk = end_chunk;
+  }
+  return partitions;
+}
+
+namespace detail {
+
+template <typename PointType>
+void convert_partition_points(LASReader& reader, const PartitionRange& range, LASWriter& writer) {
+  PointPipeline<PointType> pipeline(reader);
+  pipeline.point_range(range.first_point, range.end_point).keep_input_chunks();
+  pipeline.run(writer);
+}
+
+}  // namespace detail
+
+// Converts one planned partition of `reader` into `writer`, keeping the chunking of LAZ input.
+// The output is a partial file with its own chunk table and header statistics for just its
+// points; the LAZ outputs of all partitions can be joined by LASWriter::merge_from_readers()
+// without re-encoding.
+inline void convert_partition(LASReader& reader, const PartitionRange& range, LASWriter& writer) {
+  LASPP_SWITCH_OVER_POINT_TYPE(reader.header().point_format(), detail::convert_partition_points,
+                               reader, range, writer);
+}
+
+}  // namespace laspp
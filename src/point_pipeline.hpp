@@ -0,0 +1,619 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/cancellation.hpp"
+#include "utilities/default_init_allocator.hpp"
+#include "utilities/thread_pool.hpp"
+
+namespace laspp {
+
+// A chunk-sized run of consecutive source points on its way through a PointPipeline.
+template <typename PointType>
+struct PointBatch {
+  size_t sequence;       // position of the batch in the source; the sink writes in this order
+  uint64_t first_point;  // index in the source file of the batch's first point before any stage
+  utilities::UninitializedVector<PointType> points;
+};
+
+// Work done by one pipeline stage during PointPipeline::run().
+struct PipelineStageStatistics {
+  std::string name;
+  size_t batches = 0;
+  uint64_t points_in = 0;
+  uint64_t points_out = 0;
+  std::chrono::nanoseconds busy_time{0};  // summed over the threads that ran the stage
+
+  double points_per_second() const {
+    const double seconds = std::chrono::duration<double>(busy_time).count();
+    return seconds > 0 ? static_cast<double>(points_in) / seconds : 0.0;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const PipelineStageStatistics& stats) {
+    return os << std::left << std::setw(16) << stats.name << std::right << " batches "
+              << stats.batches << ", points " << stats.points_in << " -> " << stats.points_out
+              << ", busy " << std::fixed << std::setprecision(3)
+              << std::chrono::duration<double>(stats.busy_time).count() << " s, "
+              << std::setprecision(0) << stats.points_per_second() << " points/s"
+              << std::defaultfloat;
+  }
+};
+
+// Streams the points of a LASReader through a chain of stages into a LASWriter in one pass.
+//
+// The source produces one batch per LAZ chunk (or per UNCOMPRESSED_BATCH_SIZE points of a LAS
+// file); every stage transforms batches in place, and the sink gathers the surviving points in
+// source order into output chunks of output_chunk_size points (or keeps the input chunks, see
+// keep_input_chunks). Reading, stage work, encoding and writing all run on the shared thread
+// pool: each worker repeatedly picks the most downstream piece of work that is ready, so stages
+// overlap and a stage processes as many batches at once as it has workers (up to its
+// max_parallelism, oldest batches first). LAZ decoding and the serialisation and compression of
+// output chunks run in parallel; only reading compressed bytes, cutting batches into chunks and
+// writing the encoded chunks in order are serialised.
+// Backpressure: the source stops reading while max_batches_in_flight batches are between it
+// and the sink, or as many output chunks wait to be encoded or written, which bounds every
+// queue and the memory held by the pipeline.
+template <typename PointType>
+class PointPipeline {
+ public:
+  using Batch = PointBatch<PointType>;
+  using StageFunction = std::function<void(Batch&)>;
+
+  static constexpr size_t UNCOMPRESSED_BATCH_SIZE = 50000;
+
+  explicit PointPipeline(LASReader& reader,
+                         size_t max_batches_in_flight = 2 * utilities::get_num_threads() + 2)
+      : m_reader(reader), m_max_batches_in_flight(max_batches_in_flight) {
+    LASPP_ASSERT_GE(m_max_batches_in_flight, 1u);
+  }
+
+  // Processes only the source points [first_point, end_point), e.g. one partition of a file
+  // (see plan_partitions). For LAZ input both ends must fall on chunk boundaries.
+  PointPipeline& point_range(uint64_t first_point, uint64_t end_point) {
+    LASPP_ASSERT_LE(first_point, end_point);
+    LASPP_ASSERT_LE(end_point, m_reader.num_points());
+    m_point_range.emplace(first_point, end_point);
+    return *this;
+  }
+
+  // Points per output LAZ chunk, by default the largest chunk of the input (UNCOMPRESSED_BATCH_SIZE
+  // for LAS input). Only the last chunk of the output may be smaller, however many points the
+  // stages drop.
+  PointPipeline& output_chunk_size(size_t n_points) {
+    LASPP_ASSERT_GE(n_points, 1u);
+    m_output_chunk_size = n_points;
+    m_keep_input_chunks = false;
+    return *this;
+  }
+
+  // Writes every batch as one chunk instead, so that a pipeline whose stages drop no points
+  // reproduces the chunking of LAZ input, uneven chunks included.
+  PointPipeline& keep_input_chunks() {
+    m_keep_input_chunks = true;
+    return *this;
+  }
+
+  // Appends a stage that transforms each batch in place, dropping or modifying its points. Up to
+  // max_parallelism batches are processed at once, in no particular order; a stage with
+  // max_parallelism = 1 instead sees batches one at a time in source order, so it may carry
+  // state from one batch to the next.
+  PointPipeline& add_stage(std::string name, StageFunction function,
+                           size_t max_parallelism = std::numeric_limits<size_t>::max()) {
+    LASPP_ASSERT_GE(max_parallelism, 1u);
+    m_stages.push_back(Stage{std::move(name), std::move(function), max_parallelism});
+    return *this;
+  }
+
+  // Keeps the points for which keep(point) is true.
+  template <typename Predicate>
+  PointPipeline& filter(std::string name, Predicate keep) {
+    return add_stage(std::move(name), [keep = std::move(keep)](Batch& batch) {
+      batch.points.erase(std::remove_if(batch.points.begin(), batch.points.end(),
+                                        [&](const PointType& point) { return !keep(point); }),
+                         batch.points.end());
+    });
+  }
+
+  // Keeps the points whose scaled X/Y lie in `region`.
+  PointPipeline& crop(const Bound2D& region) {
+    return filter("crop", [region, transform = transform()](const PointType& point) {
+      const Vector3D position = transform.transform_point(point.x, point.y, point.z);
+      return region.contains(position.x(), position.y());
+    });
+  }
+
+  // Keeps the points with one of the given classifications.
+  PointPipeline& keep_classes(const std::vector<uint8_t>& classes) {
+    std::array<bool, 256> keep{};
+    for (uint8_t classification : classes) {
+      keep[classification] = true;
+    }
+    return filter("keep-classes", [keep](const PointType& point) {
+      return keep[classification_of(point)];
+    });
+  }
+
+  // Moves every point by (dx, dy, dz) in scaled units, rounded to the nearest multiple of the
+  // scale factors so that the header transform stays unchanged.
+  PointPipeline& translate(double dx, double dy, double dz) {
+    const Vector3D& scale = transform().scale_factors();
+    const int32_t ix = static_cast<int32_t>(std::llround(dx / scale.x()));
+    const int32_t iy = static_cast<int32_t>(std::llround(dy / scale.y()));
+    const int32_t iz = static_cast<int32_t>(std::llround(dz / scale.z()));
+    return add_stage("translate", [ix, iy, iz](Batch& batch) {
+      for (PointType& point : batch.points) {
+        point.x += ix;
+        point.y += iy;
+        point.z += iz;
+      }
+    });
+  }
+
+  // Keeps the first of every n points reaching this stage, counted across batches in source
+  // order.
+  PointPipeline& thin(size_t n) {
+    LASPP_ASSERT_GE(n, 1u);
+    return add_stage(
+        "thin",
+        [n, n_seen = uint64_t{0}](Batch& batch) mutable {
+          size_t n_kept = 0;
+          for (size_t i = 0; i < batch.points.size(); i++, n_seen++) {
+            if (n_seen % n == 0) {
+              batch.points[n_kept++] = batch.points[i];
+            }
+          }
+          batch.points.resize(n_kept);
+        },
+        1);
+  }
+
+  // Changes classification `from` to `to`.
+  PointPipeline& reclassify(uint8_t from, uint8_t to) {
+    if constexpr (std::is_base_of_v<LASPointFormat0, PointType>) {
+      LASPP_ASSERT_LT(to, 32, "Point formats 0-5 store classifications below 32");
+    }
+    return add_stage("reclassify", [from, to](Batch& batch) {
+      for (PointType& point : batch.points) {
+        if (classification_of(point) == from) {
+          set_classification(point, to);
+        }
+      }
+    });
+  }
+
+  // Applies `affine` to the scaled coordinates of every point and requantises them to
+  // `output_transform`, by default the current scale factors with the offsets mapped through
+  // `affine`. The output file takes this transform, and stages added later work in it. The map
+  // and both quantisations are fused into a single integer-to-integer affine step per point.
+  // Throws if a transformed point does not fit the output transform.
+  PointPipeline& affine_transform(const AffineTransform& affine,
+                                  std::optional<Transform> output_transform = std::nullopt) {
+    const Transform input = transform();
+    if (!output_transform.has_value()) {
+      output_transform = Transform(input.scale_factors(), affine.apply(input.offsets()));
+    }
+    const Transform& output = *output_transform;
+    // q' = (A (S q + o) + t - o') / s'
+    std::array<std::array<double, 4>, 3> m;
+    for (size_t r = 0; r < 3; r++) {
+      const std::array<double, 4>& row = affine.row(r);
+      const double out_scale = output.scale_factors()[r];
+      m[r][3] = (row[3] - output.offsets()[r]) / out_scale;
+      for (size_t c = 0; c < 3; c++) {
+        m[r][c] = row[c] * input.scale_factors()[c] / out_scale;
+        m[r][3] += row[c] * input.offsets()[c] / out_scale;
+      }
+    }
+    m_output_transform = output;
+    return add_stage("affine-transform",
+                     [m](Batch& batch) { requantise(std::span<PointType>(batch.points), m); });
+  }
+
+  // Runs the pipeline to completion. Header metadata, VLRs and EVLRs are copied from the reader,
+  // except for its spatial index. Exceptions thrown by a stage (including OperationCancelled)
+  // stop the pipeline and are rethrown here once all workers have stopped.
+  void run(LASWriter& writer) {
+    writer.copy_metadata_from(m_reader, true);
+    writer.header().transform() = transform();
+
+    const std::vector<Unit> units = plan_units();
+    m_statistics.assign(m_stages.size() + 2, PipelineStageStatistics{});
+    m_statistics.front().name = "read";
+    for (size_t s = 0; s < m_stages.size(); s++) {
+      m_statistics[s + 1].name = m_stages[s].name;
+    }
+    m_statistics.back().name = "write";
+    m_peak_batches_in_flight = 0;
+
+    State state(m_stages.size(), m_output_chunk_size.value_or(input_chunk_size()));
+    const size_t n_workers = std::max<size_t>(1, std::min(utilities::get_num_threads(),
+                                                          units.size()));
+    utilities::parallel_for(size_t{0}, n_workers,
+                            [&](size_t) { work(state, units, writer); });
+    if (state.error) {
+      std::rethrow_exception(state.error);
+    }
+    writer.copy_evlrs_from(m_reader, true);
+  }
+
+  // One entry per stage of the last run(): the source ("read"), the added stages in order, and
+  // the sink ("write").
+  const std::vector<PipelineStageStatistics>& statistics() const { return m_statistics; }
+
+  size_t max_batches_in_flight() const { return m_max_batches_in_flight; }
+  // Most batches held between source and sink at once during the last run().
+  size_t peak_batches_in_flight() const { return m_peak_batches_in_flight; }
+
+ private:
+  struct Stage {
+    std::string name;
+    StageFunction function;
+    size_t max_parallelism;
+  };
+
+  struct Unit {
+    size_t chunk_index;  // LAZ only
+    uint64_t first_point;
+    size_t n_points;
+  };
+
+  struct State {
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next_unit = 0;
+    size_t n_written = 0;
+    size_t n_in_flight = 0;
+    bool source_busy = false;
+    bool sink_busy = false;
+    bool writer_busy = false;
+    std::vector<std::map<size_t, Batch>> queues;  // input of each stage, by sequence
+    std::vector<size_t> n_active;                 // batches each stage is processing
+    std::vector<size_t> n_done;                   // batches each stage has finished
+    std::map<size_t, Batch> ready;  // finished batches waiting for their turn to be written
+    size_t chunk_size;
+    utilities::UninitializedVector<PointType> pending;  // gathered points short of a full chunk
+    bool began_points = false;                          // touched by the sink only
+    // Output chunks numbered in file order: waiting for a worker to encode them, then for their
+    // turn to be written
+    std::map<size_t, utilities::UninitializedVector<PointType>> to_encode;
+    std::map<size_t, LASWriter::EncodedChunk> encoded;
+    size_t n_chunks = 0;
+    size_t n_chunks_written = 0;
+    std::exception_ptr error;
+
+    State(size_t n_stages, size_t points_per_chunk)
+        : queues(n_stages),
+          n_active(n_stages, 0),
+          n_done(n_stages, 0),
+          chunk_size(points_per_chunk) {}
+  };
+
+  // The transform of the points leaving the last stage added so far.
+  const Transform& transform() const {
+    return m_output_transform.has_value() ? *m_output_transform : m_reader.header().transform();
+  }
+
+  // Maps integer coordinates through the 3x4 matrix `m` in blocks: loads, the multiply-add and
+  // rounding run over flat arrays that the compiler can vectorise.
+  static void requantise(std::span<PointType> points,
+                         const std::array<std::array<double, 4>, 3>& m) {
+    constexpr size_t BLOCK_SIZE = 256;
+    std::array<std::array<double, BLOCK_SIZE>, 3> in;
+    std::array<std::array<double, BLOCK_SIZE>, 3> out;
+    for (size_t begin = 0; begin < points.size(); begin += BLOCK_SIZE) {
+      const size_t n = std::min(BLOCK_SIZE, points.size() - begin);
+      for (size_t i = 0; i < n; i++) {
+        in[0][i] = points[begin + i].x;
+        in[1][i] = points[begin + i].y;
+        in[2][i] = points[begin + i].z;
+      }
+      for (size_t r = 0; r < 3; r++) {
+        double lowest = std::numeric_limits<double>::max();
+        double highest = std::numeric_limits<double>::lowest();
+        for (size_t i = 0; i < n; i++) {
+          out[r][i] = std::nearbyint(m[r][0] * in[0][i] + m[r][1] * in[1][i] +
+                                     m[r][2] * in[2][i] + m[r][3]);
+          lowest = std::min(lowest, out[r][i]);
+          highest = std::max(highest, out[r][i]);
+        }
+        LASPP_ASSERT(lowest >= std::numeric_limits<int32_t>::min() &&
+                         highest <= std::numeric_limits<int32_t>::max(),
+                     "Transformed coordinates do not fit the output transform");
+      }
+      for (size_t i = 0; i < n; i++) {
+        points[begin + i].x = static_cast<int32_t>(out[0][i]);
+        points[begin + i].y = static_cast<int32_t>(out[1][i]);
+        points[begin + i].z = static_cast<int32_t>(out[2][i]);
+      }
+    }
+  }
+
+  static uint8_t classification_of(const PointType& point) {
+    if constexpr (std::is_base_of_v<LASPointFormat0, PointType>) {
+      return static_cast<uint8_t>(point.classification_byte.classification);
+    } else {
+      return static_cast<uint8_t>(point.classification);
+    }
+  }
+
+  static void set_classification(PointType& point, uint8_t classification) {
+    if constexpr (std::is_base_of_v<LASPointFormat0, PointType>) {
+      point.classification_byte.classification = static_cast<LASClassification>(classification);
+    } else {
+      point.classification = static_cast<LASClassification>(classification);
+    }
+  }
+
+  size_t input_chunk_size() const {
+    if (!m_reader.header().is_laz_compressed()) {
+      return UNCOMPRESSED_BATCH_SIZE;
+    }
+    const std::vector<size_t> points_per_chunk = m_reader.points_per_chunk();
+    const auto largest = std::max_element(points_per_chunk.begin(), points_per_chunk.end());
+    if (largest == points_per_chunk.end() || *largest == 0) {
+      return UNCOMPRESSED_BATCH_SIZE;
+    }
+    return *largest;
+  }
+
+  std::vector<Unit> plan_units() const {
+    const uint64_t begin = m_point_range.has_value() ? m_point_range->first : 0;
+    const uint64_t end = m_point_range.has_value() ? m_point_range->second : m_reader.num_points();
+    std::vector<Unit> units;
+    if (m_reader.header().is_laz_compressed()) {
+      uint64_t first_point = 0;
+      const std::vector<size_t> points_per_chunk = m_reader.points_per_chunk();
+      for (size_t c = 0; c < points_per_chunk.size(); c++) {
+        if (first_point >= begin && first_point < end) {
+          units.push_back(Unit{c, first_point, points_per_chunk[c]});
+        }
+        first_point += points_per_chunk[c];
+      }
+      LASPP_ASSERT(begin == end || (!units.empty() && units.front().first_point == begin &&
+                                    units.back().first_point + units.back().n_points == end),
+                   "Point range [", begin, ", ", end, ") does not follow chunk boundaries");
+    } else {
+      for (uint64_t first = begin; first < end; first += UNCOMPRESSED_BATCH_SIZE) {
+        const uint64_t n_points = std::min<uint64_t>(UNCOMPRESSED_BATCH_SIZE, end - first);
+        units.push_back(Unit{0, first, static_cast<size_t>(n_points)});
+      }
+    }
+    return units;
+  }
+
+  static void record(PipelineStageStatistics& stats, uint64_t points_in, uint64_t points_out,
+                     std::chrono::steady_clock::time_point start) {
+    stats.batches++;
+    stats.points_in += points_in;
+    stats.points_out += points_out;
+    stats.busy_time += std::chrono::steady_clock::now() - start;
+  }
+
+  // Hands a batch that left `stage` to the next stage, or to the sink after the last one.
+  static void forward(State& state, size_t stage, Batch&& batch) {
+    const size_t sequence = batch.sequence;
+    if (stage < state.queues.size()) {
+      state.queues[stage].emplace(sequence, std::move(batch));
+    } else {
+      state.ready.emplace(sequence, std::move(batch));
+    }
+  }
+
+  // Runs `f` with the lock released. Returns false, having recorded the exception, if it threw.
+  template <typename Function>
+  static bool unlocked(State& state, std::unique_lock<std::mutex>& lock, Function&& f) {
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      utilities::check_cancellation();
+      f();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    if (error && !state.error) {
+      state.error = error;
+    }
+    state.changed.notify_all();
+    return !error;
+  }
+
+  void work(State& state, const std::vector<Unit>& units, LASWriter& writer) {
+    using clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.error &&
+           (state.n_written < units.size() || state.n_chunks_written < state.n_chunks)) {
+      // Write the next encoded chunk in file order
+      if (!state.writer_busy && !state.encoded.empty() &&
+          state.encoded.begin()->first == state.n_chunks_written) {
+        const LASWriter::EncodedChunk chunk = std::move(state.encoded.begin()->second);
+        state.encoded.erase(state.encoded.begin());
+        state.writer_busy = true;
+        const auto start = clock::now();
+        const bool ok = unlocked(state, lock, [&]() { writer.write_encoded_chunk(chunk); });
+        state.writer_busy = false;
+        if (ok) {
+          m_statistics.back().busy_time += clock::now() - start;
+          state.n_chunks_written++;
+        }
+        continue;
+      }
+
+      // Serialise and compress the oldest output chunk; any number of workers may do so at once
+      if (!state.to_encode.empty()) {
+        const size_t sequence = state.to_encode.begin()->first;
+        const utilities::UninitializedVector<PointType> points =
+            std::move(state.to_encode.begin()->second);
+        state.to_encode.erase(state.to_encode.begin());
+        LASWriter::EncodedChunk chunk;
+        const auto start = clock::now();
+        const bool ok = unlocked(state, lock, [&]() {
+          chunk = writer.encode_chunk(std::span<const PointType>(points));
+        });
+        if (ok) {
+          m_statistics.back().busy_time += clock::now() - start;
+          state.encoded.emplace(sequence, std::move(chunk));
+        }
+        continue;
+      }
+
+      // Sink: append the next batch in source order and cut the points gathered so far into
+      // output chunks
+      if (!state.sink_busy && !state.ready.empty() &&
+          state.ready.begin()->first == state.n_written) {
+        Batch batch = std::move(state.ready.begin()->second);
+        state.ready.erase(state.ready.begin());
+        state.sink_busy = true;
+        const size_t n_points = batch.points.size();
+        const bool last = batch.sequence + 1 == units.size();
+        std::vector<utilities::UninitializedVector<PointType>> chunks;
+        const auto start = clock::now();
+        const bool ok = unlocked(state, lock, [&]() {
+          if (m_keep_input_chunks) {
+            if (!batch.points.empty()) {
+              chunks.push_back(std::move(batch.points));
+            }
+          } else {
+            state.pending.insert(state.pending.end(), batch.points.begin(), batch.points.end());
+            size_t n_cut = 0;
+            for (; state.pending.size() - n_cut >= state.chunk_size; n_cut += state.chunk_size) {
+              chunks.emplace_back(state.pending.begin() + static_cast<std::ptrdiff_t>(n_cut),
+                                  state.pending.begin() +
+                                      static_cast<std::ptrdiff_t>(n_cut + state.chunk_size));
+            }
+            state.pending.erase(state.pending.begin(),
+                                state.pending.begin() + static_cast<std::ptrdiff_t>(n_cut));
+            if (last && !state.pending.empty()) {
+              chunks.push_back(std::move(state.pending));
+              state.pending.clear();
+            }
+          }
+          if (!chunks.empty() && !state.began_points) {
+            writer.begin_points();
+            state.began_points = true;
+          }
+        });
+        state.sink_busy = false;
+        if (ok) {
+          record(m_statistics.back(), n_points, n_points, start);
+          for (utilities::UninitializedVector<PointType>& chunk : chunks) {
+            state.to_encode.emplace(state.n_chunks++, std::move(chunk));
+          }
+          state.n_written++;
+          state.n_in_flight--;
+        }
+        continue;
+      }
+
+      // Stages, most downstream first so that batches drain before new ones are read
+      bool ran_stage = false;
+      for (size_t s = m_stages.size(); s-- > 0;) {
+        std::map<size_t, Batch>& queue = state.queues[s];
+        if (queue.empty() || state.n_active[s] >= m_stages[s].max_parallelism ||
+            (m_stages[s].max_parallelism == 1 && queue.begin()->first != state.n_done[s])) {
+          continue;
+        }
+        Batch batch = std::move(queue.begin()->second);
+        queue.erase(queue.begin());
+        state.n_active[s]++;
+        const size_t points_in = batch.points.size();
+        const auto start = clock::now();
+        const bool ok = unlocked(state, lock, [&]() { m_stages[s].function(batch); });
+        state.n_active[s]--;
+        state.n_done[s]++;
+        if (ok) {
+          record(m_statistics[s + 1], points_in, batch.points.size(), start);
+          forward(state, s + 1, std::move(batch));
+        }
+        ran_stage = true;
+        break;
+      }
+      if (ran_stage) {
+        continue;
+      }
+
+      // Source: read the next unit unless too many batches are already in flight
+      if (!state.source_busy && state.next_unit < units.size() &&
+          state.n_in_flight < m_max_batches_in_flight &&
+          state.n_chunks - state.n_chunks_written < m_max_batches_in_flight) {
+        const size_t sequence = state.next_unit++;
+        const Unit& unit = units[sequence];
+        state.n_in_flight++;
+        m_peak_batches_in_flight = std::max(m_peak_batches_in_flight, state.n_in_flight);
+        state.source_busy = true;
+        Batch batch{sequence, unit.first_point, {}};
+        std::vector<std::byte> compressed;
+        const auto start = clock::now();
+        bool ok = unlocked(state, lock, [&]() {
+          if (m_reader.header().is_laz_compressed()) {
+            compressed = m_reader.read_compressed_chunk(unit.chunk_index);
+          } else {
+            std::vector<size_t> indices(unit.n_points);
+            std::iota(indices.begin(), indices.end(), unit.first_point);
+            batch.points.resize(unit.n_points);
+            m_reader.read_points_by_index(std::span<PointType>(batch.points),
+                                          std::span<const size_t>(indices));
+          }
+        });
+        state.source_busy = false;
+        if (ok && !compressed.empty()) {
+          // Decoding does not touch the file, so other workers may read meanwhile
+          ok = unlocked(state, lock, [&]() {
+            batch.points.resize(unit.n_points);
+            m_reader.decompress_chunk(unit.chunk_index, std::span<const std::byte>(compressed),
+                                      std::span<PointType>(batch.points));
+          });
+        }
+        if (ok) {
+          record(m_statistics.front(), unit.n_points, unit.n_points, start);
+          forward(state, 0, std::move(batch));
+        }
+        continue;
+      }
+
+      state.changed.wait(lock);
+    }
+    state.changed.notify_all();
+  }
+
+  LASReader& m_reader;
+  size_t m_max_batches_in_flight;
+  std::optional<std::pair<uint64_t, uint64_t>> m_point_range;
+  std::vector<Stage> m_stages;
+  std::optional<Transform> m_output_transform;
+  std::optional<size_t> m_output_chunk_size;
+  bool m_keep_input_chunks = false;
+  std::vector<PipelineStageStatistics> m_statistics;
+  size_t m_peak_batches_in_flight = 0;
+};
+
+}  // namespace laspp
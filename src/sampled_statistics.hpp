@@ -0,0 +1,411 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "spatial_index.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/memory_budget.hpp"
+#include "utilities/thread_pool.hpp"
+
+namespace laspp {
+
+// An approximate value with the bounds of its 95% confidence interval. All three are equal once
+// the estimate is exact.
+struct Estimate {
+  double value;
+  double lower;
+  double upper;
+};
+
+// Approximate class distribution, Z percentiles and intensity histograms of a file (or of the
+// points inside a region) from a random sample of it, for quick looks at large files.
+//
+// The file is sampled in units: LAZ chunks, or blocks of UNCOMPRESSED_BLOCK_SIZE points of an
+// uncompressed file. The units are split into about sqrt(n) strata of consecutive units, which
+// in spatially sorted files are also spatially compact, and sample() visits one random unit of
+// every stratum before it revisits any. Each call decodes its units in parallel, either whole or
+// only their first points, which is cheaper since a LAZ chunk is decoded front to back. With a
+// region, units that the spatial index shows to lie outside it are never sampled.
+//
+// Estimates are ratio estimates over units, weighting partially decoded units by how many of
+// their points were decoded, and their bounds come from the variance between units (the
+// stratification is ignored, which only widens them). Sampling more units refines the
+// estimates. Once every unit has been visited, sample() returns to the units only partially
+// decoded for their remaining points, so that the estimates end up exact.
+class SampledStatistics {
+ public:
+  static constexpr size_t UNCOMPRESSED_BLOCK_SIZE = 50000;
+
+  SampledStatistics(LASReader& reader, uint64_t seed = 0,
+                    std::optional<Bound2D> region = std::nullopt)
+      : m_reader(reader), m_region(region) {
+    const std::vector<size_t> unit_sizes = reader.header().is_laz_compressed()
+                                               ? reader.points_per_chunk()
+                                               : uncompressed_block_sizes(reader.num_points());
+    std::vector<CellCoverage> coverage(unit_sizes.size(), CellCoverage::Partial);
+    if (region.has_value() && reader.header().is_laz_compressed()) {
+      coverage = reader.chunk_coverage(*region);
+    }
+    size_t first_point = 0;
+    for (size_t i = 0; i < unit_sizes.size(); i++) {
+      if (unit_sizes[i] > 0 && coverage[i] != CellCoverage::Outside) {
+        m_units.push_back({i, first_point, unit_sizes[i]});
+        m_n_points += unit_sizes[i];
+      }
+      first_point += unit_sizes[i];
+    }
+
+    // Shuffle within strata, then interleave the strata
+    const size_t n_strata =
+        std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(m_units.size()))));
+    std::mt19937_64 gen(seed);
+    std::vector<std::vector<size_t>> strata(n_strata);
+    for (size_t i = 0; i < m_units.size(); i++) {
+      strata[i * n_strata / m_units.size()].push_back(i);
+    }
+    for (std::vector<size_t>& stratum : strata) {
+      std::shuffle(stratum.begin(), stratum.end(), gen);
+    }
+    std::vector<size_t> stratum_order(n_strata);
+    std::iota(stratum_order.begin(), stratum_order.end(), size_t{0});
+    for (size_t round = 0; m_order.size() < m_units.size(); round++) {
+      std::shuffle(stratum_order.begin(), stratum_order.end(), gen);
+      for (size_t s : stratum_order) {
+        if (round < strata[s].size()) m_order.push_back(strata[s][round]);
+      }
+    }
+  }
+
+  // Decodes the next `n_units` units of the sampling order that still have points to decode, up
+  // to `max_points_per_unit` more points of each, in parallel. A unit visited again continues
+  // after the points it already gave (for a LAZ chunk, by decoding its start again). Returns the
+  // number of units sampled, which is less than `n_units` once every point has been decoded.
+  size_t sample(size_t n_units,
+                size_t max_points_per_unit = std::numeric_limits<size_t>::max()) {
+    LASPP_ASSERT_GT(max_points_per_unit, 0u);
+    std::vector<size_t> picked;  // indices into m_units
+    for (size_t n_visited = 0; picked.size() < n_units && n_visited < m_order.size();
+         n_visited++) {
+      const size_t unit_index = m_order[m_next];
+      m_next = (m_next + 1) % m_order.size();
+      if (m_units[unit_index].n_decoded < m_units[unit_index].n_points) {
+        picked.push_back(unit_index);
+      }
+    }
+    const bool is_laz = m_reader.header().is_laz_compressed();
+    const auto n_new_points = [&](const Unit& unit) {
+      return std::min(unit.n_points - unit.n_decoded, max_points_per_unit);
+    };
+
+    // Batches bound the compressed and decoded points held in memory at once
+    const size_t batch_size = 4 * utilities::get_num_threads();
+    bool revisited = false;
+    for (size_t batch_begin = 0; batch_begin < picked.size(); batch_begin += batch_size) {
+      const size_t batch_end = std::min(picked.size(), batch_begin + batch_size);
+      size_t n_batch_points = 0;
+      for (size_t i = batch_begin; i < batch_end; i++) {
+        const Unit& unit = m_units[picked[i]];
+        n_batch_points += n_new_points(unit) + (is_laz ? unit.n_decoded : 0);
+      }
+      utilities::MemoryReservation batch_reservation(utilities::get_memory_budget(),
+                                                     n_batch_points * sizeof(SamplePoint),
+                                                     "SampledStatistics::sample decoded points");
+      std::vector<std::vector<std::byte>> compressed(batch_end - batch_begin);
+      if (is_laz) {
+        for (size_t i = batch_begin; i < batch_end; i++) {
+          compressed[i - batch_begin] = m_reader.read_compressed_chunk(m_units[picked[i]].index);
+        }
+      }
+      std::vector<std::vector<SamplePoint>> decoded(batch_end - batch_begin);
+      utilities::parallel_for(batch_begin, batch_end, [&](size_t i) {
+        const Unit& unit = m_units[picked[i]];
+        std::vector<SamplePoint>& points = decoded[i - batch_begin];
+        if (is_laz) {
+          // A chunk is decoded front to back, so the points already sampled are decoded again
+          points.resize(unit.n_decoded + n_new_points(unit));
+          m_reader.decompress_chunk_prefix(unit.index, compressed[i - batch_begin],
+                                           std::span<SamplePoint>(points));
+          points.erase(points.begin(),
+                       points.begin() + static_cast<std::ptrdiff_t>(unit.n_decoded));
+        } else {
+          points.resize(n_new_points(unit));
+        }
+      });
+      if (!is_laz) {
+        // Uncompressed blocks are read in place; there is nothing to decode in parallel
+        for (size_t i = batch_begin; i < batch_end; i++) {
+          const Unit& unit = m_units[picked[i]];
+          std::vector<SamplePoint>& points = decoded[i - batch_begin];
+          std::vector<size_t> indices(points.size());
+          std::iota(indices.begin(), indices.end(), unit.first_point + unit.n_decoded);
+          m_reader.read_points_by_index(std::span<SamplePoint>(points),
+                                        std::span<const size_t>(indices));
+        }
+      }
+      for (size_t i = batch_begin; i < batch_end; i++) {
+        revisited = revisited || m_units[picked[i]].n_decoded > 0;
+        add_unit(m_units[picked[i]], decoded[i - batch_begin]);
+      }
+    }
+    if (revisited) {
+      // category_fractions() needs the points of each unit together
+      std::stable_sort(
+          m_points.begin(), m_points.end(),
+          [](const WeightedPoint& a, const WeightedPoint& b) { return a.unit < b.unit; });
+    }
+    return picked.size();
+  }
+
+  size_t num_units() const { return m_units.size(); }
+  // Units with at least some of their points decoded.
+  size_t num_units_sampled() const { return m_unit_weights.size(); }
+  // Points in the units that may be sampled; with a region, an upper bound on its point count.
+  uint64_t num_points() const { return m_n_points; }
+  uint64_t num_points_decoded() const { return m_n_points_decoded; }
+  // Decoded points that count towards the estimates (inside the region, if any).
+  size_t num_sample_points() const { return m_points.size(); }
+  bool is_exact() const { return m_n_points_decoded == m_n_points; }
+
+  // Fraction of the points of each classification (the full byte for point formats 6 and up,
+  // the low five bits below).
+  std::vector<Estimate> class_distribution() const {
+    return category_fractions(256, [](const WeightedPoint& point) -> size_t {
+      return point.classification;
+    });
+  }
+
+  Estimate class_fraction(uint8_t classification) const {
+    return class_distribution()[classification];
+  }
+
+  // Fraction of the points in each intensity bin [k * bin_width, (k + 1) * bin_width).
+  std::vector<Estimate> intensity_histogram(uint32_t bin_width) const {
+    LASPP_ASSERT_GT(bin_width, 0u);
+    return category_fractions(size_t{65535} / bin_width + 1,
+                              [&](const WeightedPoint& point) -> size_t {
+                                return point.intensity / bin_width;
+                              });
+  }
+
+  // The `p`-quantile (0 <= p <= 1) of the scaled Z coordinates: the lowest Z of at least a
+  // fraction `p` of the points. The bounds invert those of the fraction of points below the
+  // estimate (Woodruff's method).
+  Estimate z_percentile(double p) const {
+    LASPP_ASSERT(p >= 0.0 && p <= 1.0, "Percentile ", p, " is not in [0, 1]");
+    LASPP_ASSERT(!m_points.empty(), "No points sampled");
+    std::vector<size_t> order(m_points.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return m_points[a].z < m_points[b].z; });
+    std::vector<double> cumulative_weight(order.size());
+    double total_weight = 0.0;
+    for (size_t k = 0; k < order.size(); k++) {
+      total_weight += m_unit_weights[m_points[order[k]].unit];
+      cumulative_weight[k] = total_weight;
+    }
+    const auto quantile = [&](double q) {
+      const double target = std::clamp(q, 0.0, 1.0) * total_weight;
+      // Tolerate rounding in the running sum so that exact quantiles match a sorted array
+      const size_t k = static_cast<size_t>(
+          std::lower_bound(cumulative_weight.begin(), cumulative_weight.end(),
+                           target - 1e-9 * total_weight) -
+          cumulative_weight.begin());
+      return m_points[order[std::min(k, order.size() - 1)]].z;
+    };
+
+    const int32_t z = quantile(p);
+    const Estimate below = category_fractions(2, [&](const WeightedPoint& point) -> size_t {
+      return point.z <= z ? 1 : 0;
+    })[1];
+    const double half_width = std::max(below.value - below.lower, below.upper - below.value);
+    return {scaled_z(z), scaled_z(quantile(p - half_width)), scaled_z(quantile(p + half_width))};
+  }
+
+ private:
+  // Two-sided 95% normal quantile
+  static constexpr double Z_SCORE = 1.959964;
+
+  static constexpr uint32_t NOT_SAMPLED = std::numeric_limits<uint32_t>::max();
+
+  struct Unit {
+    size_t index;  // chunk index, or block index of an uncompressed file
+    size_t first_point;
+    size_t n_points;
+    size_t n_decoded = 0;               // the first points of the unit, sampled so far
+    uint32_t sample_id = NOT_SAMPLED;  // index into m_unit_weights once sampled
+  };
+
+  struct SamplePoint {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    uint16_t intensity;
+    uint8_t classification;
+
+    friend void copy_from(SamplePoint& dest, const LASPointFormat0& src) {
+      dest.x = src.x;
+      dest.y = src.y;
+      dest.z = src.z;
+      dest.intensity = src.intensity;
+      dest.classification = static_cast<uint8_t>(src.classification());
+    }
+    friend void copy_from(SamplePoint& dest, const LASPointFormat6& src) {
+      dest.x = src.x;
+      dest.y = src.y;
+      dest.z = src.z;
+      dest.intensity = src.intensity;
+      dest.classification = static_cast<uint8_t>(src.classification);
+    }
+  };
+
+  struct WeightedPoint {
+    int32_t z;
+    uint32_t unit;  // index into m_unit_weights
+    uint16_t intensity;
+    uint8_t classification;
+  };
+
+  LASReader& m_reader;
+  std::optional<Bound2D> m_region;
+  std::vector<Unit> m_units;
+  std::vector<size_t> m_order;  // sampling order, indices into m_units
+  size_t m_next = 0;            // position in m_order, which sample() cycles through
+  uint64_t m_n_points = 0;
+  uint64_t m_n_points_decoded = 0;
+  std::vector<WeightedPoint> m_points;
+  std::vector<double> m_unit_weights;    // points of the unit per point decoded
+  std::vector<size_t> m_unit_n_selected;  // decoded points of the unit counted in m_points
+  std::vector<utilities::MemoryReservation> m_points_reservations;  // budget held for m_points
+
+  static std::vector<size_t> uncompressed_block_sizes(size_t n_points) {
+    std::vector<size_t> sizes;
+    for (size_t first = 0; first < n_points; first += UNCOMPRESSED_BLOCK_SIZE) {
+      sizes.push_back(std::min(UNCOMPRESSED_BLOCK_SIZE, n_points - first));
+    }
+    return sizes;
+  }
+
+  void add_unit(Unit& unit, std::span<const SamplePoint> points) {
+    if (unit.sample_id == NOT_SAMPLED) {
+      unit.sample_id = static_cast<uint32_t>(m_unit_weights.size());
+      m_unit_weights.push_back(0.0);
+      m_unit_n_selected.push_back(0);
+    }
+    const Transform& transform = m_reader.header().transform();
+    const auto selected = [&](const SamplePoint& point) {
+      if (!m_region.has_value()) {
+        return true;
+      }
+      const double x =
+          int32_to_double(point.x, transform.scale_factors().x(), transform.offsets().x());
+      const double y =
+          int32_to_double(point.y, transform.scale_factors().y(), transform.offsets().y());
+      return m_region->contains(x, y);
+    };
+    const size_t n_selected =
+        static_cast<size_t>(std::count_if(points.begin(), points.end(), selected));
+    m_points_reservations.emplace_back(utilities::get_memory_budget(),
+                                       n_selected * sizeof(WeightedPoint),
+                                       "SampledStatistics sample points");
+    for (const SamplePoint& point : points) {
+      if (selected(point)) {
+        m_points.push_back({point.z, unit.sample_id, point.intensity, point.classification});
+      }
+    }
+    unit.n_decoded += points.size();
+    m_unit_weights[unit.sample_id] =
+        static_cast<double>(unit.n_points) / static_cast<double>(unit.n_decoded);
+    m_unit_n_selected[unit.sample_id] += n_selected;
+    m_n_points_decoded += points.size();
+  }
+
+  // Ratio estimates of the fraction of the selected points in each category, over units, with
+  // a linearised variance corrected for the fraction of points decoded. The points of each
+  // unit are contiguous in m_points, so per-unit counts are only kept for one unit at a time.
+  template <typename Category>
+  std::vector<Estimate> category_fractions(size_t n_categories, Category&& category_of) const {
+    std::vector<double> weighted_counts(n_categories, 0.0);
+    std::vector<double> weighted_squares(n_categories, 0.0);
+    std::vector<double> weighted_products(n_categories, 0.0);
+    double weighted_total = 0.0;
+    double weighted_total_squares = 0.0;
+    std::vector<size_t> unit_counts(n_categories, 0);
+    std::vector<size_t> touched;
+    for (size_t u = 0, begin = 0; u < m_unit_weights.size(); u++) {
+      const size_t end = begin + m_unit_n_selected[u];
+      for (size_t k = begin; k < end; k++) {
+        const size_t category = category_of(m_points[k]);
+        if (unit_counts[category]++ == 0) touched.push_back(category);
+      }
+      const double w = m_unit_weights[u];
+      const double m = static_cast<double>(m_unit_n_selected[u]);
+      for (size_t category : touched) {
+        const double count = static_cast<double>(unit_counts[category]);
+        weighted_counts[category] += w * count;
+        weighted_squares[category] += w * w * count * count;
+        weighted_products[category] += w * w * count * m;
+        unit_counts[category] = 0;
+      }
+      touched.clear();
+      weighted_total += w * m;
+      weighted_total_squares += w * w * m * m;
+      begin = end;
+    }
+
+    const size_t n = m_unit_weights.size();
+    const double sampled_fraction =
+        m_n_points == 0 ? 1.0
+                        : static_cast<double>(m_n_points_decoded) / static_cast<double>(m_n_points);
+    std::vector<Estimate> estimates(n_categories);
+    for (size_t category = 0; category < n_categories; category++) {
+      if (weighted_total == 0.0) {
+        estimates[category] = {0.0, 0.0, 1.0};
+        continue;
+      }
+      const double ratio = weighted_counts[category] / weighted_total;
+      if (is_exact()) {
+        estimates[category] = {ratio, ratio, ratio};
+        continue;
+      }
+      if (n < 2) {
+        estimates[category] = {ratio, 0.0, 1.0};
+        continue;
+      }
+      // sum over units of (w * (count - ratio * m))^2
+      const double sum_of_squares =
+          std::max(0.0, weighted_squares[category] - 2.0 * ratio * weighted_products[category] +
+                            ratio * ratio * weighted_total_squares);
+      const double variance = (1.0 - sampled_fraction) * static_cast<double>(n) /
+                              static_cast<double>(n - 1) * sum_of_squares /
+                              (weighted_total * weighted_total);
+      const double half_width = Z_SCORE * std::sqrt(variance);
+      estimates[category] = {ratio, std::max(0.0, ratio - half_width),
+                             std::min(1.0, ratio + half_width)};
+    }
+    return estimates;
+  }
+
+  double scaled_z(int32_t z) const {
+    const Transform& transform = m_reader.header().transform();
+    return int32_to_double(z, transform.scale_factors().z(), transform.offsets().z());
+  }
+};
+
+}  // namespace laspp
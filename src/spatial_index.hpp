@@ -6,11 +6,14 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -21,6 +24,7 @@
 #include "las_point.hpp"
 #include "utilities/assert.hpp"
 #include "utilities/macros.hpp"
+#include "utilities/memory_budget.hpp"
 #include "utilities/printing.hpp"
 
 namespace laspp {
@@ -100,9 +104,11 @@ struct LASPP_PACKED IntervalCellData {
 
 #pragma pack(pop)
 
+// Inclusive range of point indices. 64-bit so that indices of LAS 1.4 files with more than
+// 2^32 points are representable in memory; the LAX format itself stores 32-bit values.
 struct PointInterval {
-  uint32_t start;
-  uint32_t end;
+  uint64_t start;
+  uint64_t end;
 
   friend std::ostream& operator<<(std::ostream& os, const PointInterval& interval) {
     os << "[" << interval.start << ", " << interval.end << "]";
@@ -112,7 +118,7 @@ struct PointInterval {
 
 struct CellIntervals {
   int32_t cell_index;
-  uint32_t number_points;
+  uint64_t number_points;
   std::vector<PointInterval> intervals;
 
   friend std::ostream& operator<<(std::ostream& os, const CellIntervals& cell) {
@@ -127,6 +133,151 @@ struct CellIntervals {
   }
 };
 
+// How a quadtree cell relates to a query region.
+enum class CellCoverage { Outside, Partial, Inside };
+
+inline CellCoverage region_coverage(const Bound2D& region, const Bound2D& cell) {
+  if (cell.max_x() < region.min_x() || cell.min_x() > region.max_x() ||
+      cell.max_y() < region.min_y() || cell.min_y() > region.max_y()) {
+    return CellCoverage::Outside;
+  }
+  if (cell.min_x() >= region.min_x() && cell.max_x() <= region.max_x() &&
+      cell.min_y() >= region.min_y() && cell.max_y() <= region.max_y()) {
+    return CellCoverage::Inside;
+  }
+  return CellCoverage::Partial;
+}
+
+// Simple polygon given by its vertices; the closing edge is implicit. Containment uses the
+// even-odd rule.
+class Polygon2D {
+  std::vector<std::array<double, 2>> m_vertices;
+  Bound2D m_bounds;
+
+  // Whether segment a-b touches the closed box (Liang-Barsky clipping).
+  static bool segment_touches(const std::array<double, 2>& a, const std::array<double, 2>& b,
+                              const Bound2D& box) {
+    const double dx = b[0] - a[0];
+    const double dy = b[1] - a[1];
+    double t0 = 0.0;
+    double t1 = 1.0;
+    auto clip = [&](double p, double q) {
+      if (p == 0.0) return q >= 0.0;
+      const double r = q / p;
+      if (p < 0.0) {
+        if (r > t1) return false;
+        t0 = std::max(t0, r);
+      } else {
+        if (r < t0) return false;
+        t1 = std::min(t1, r);
+      }
+      return true;
+    };
+    return clip(-dx, a[0] - box.min_x()) && clip(dx, box.max_x() - a[0]) &&
+           clip(-dy, a[1] - box.min_y()) && clip(dy, box.max_y() - a[1]);
+  }
+
+ public:
+  explicit Polygon2D(std::vector<std::array<double, 2>> vertices)
+      : m_vertices(std::move(vertices)) {
+    LASPP_ASSERT_GE(m_vertices.size(), 3u, "A polygon needs at least three vertices");
+    for (const auto& vertex : m_vertices) {
+      m_bounds.update(vertex[0], vertex[1]);
+    }
+  }
+
+  const std::vector<std::array<double, 2>>& vertices() const { return m_vertices; }
+  const Bound2D& bounds() const { return m_bounds; }
+
+  bool contains(double x, double y) const {
+    bool inside = false;
+    for (size_t i = 0, j = m_vertices.size() - 1; i < m_vertices.size(); j = i++) {
+      const auto& a = m_vertices[i];
+      const auto& b = m_vertices[j];
+      if ((a[1] > y) != (b[1] > y) && x < (b[0] - a[0]) * (y - a[1]) / (b[1] - a[1]) + a[0]) {
+        inside = !inside;
+      }
+    }
+    return inside;
+  }
+
+  CellCoverage coverage(const Bound2D& cell) const {
+    if (region_coverage(m_bounds, cell) == CellCoverage::Outside) {
+      return CellCoverage::Outside;
+    }
+    for (size_t i = 0, j = m_vertices.size() - 1; i < m_vertices.size(); j = i++) {
+      if (segment_touches(m_vertices[j], m_vertices[i], cell)) {
+        return CellCoverage::Partial;
+      }
+    }
+    // No edge touches the cell, so it lies entirely on one side of the boundary
+    const double center_x = 0.5 * (cell.min_x() + cell.max_x());
+    const double center_y = 0.5 * (cell.min_y() + cell.max_y());
+    return contains(center_x, center_y) ? CellCoverage::Inside : CellCoverage::Outside;
+  }
+};
+
+inline CellCoverage region_coverage(const Polygon2D& region, const Bound2D& cell) {
+  return region.coverage(cell);
+}
+
+// Point counts on a regular grid over `bounds` (row-major, row 0 at min_y). Points on the
+// max_x/max_y edges belong to the last column/row; points outside `bounds` are not counted.
+class DensityGrid {
+  Bound2D m_bounds;
+  size_t m_n_cols;
+  size_t m_n_rows;
+  double m_cell_width;
+  double m_cell_height;
+  std::vector<uint64_t> m_counts;
+
+ public:
+  DensityGrid(const Bound2D& bounds, size_t n_cols, size_t n_rows)
+      : m_bounds(bounds),
+        m_n_cols(n_cols),
+        m_n_rows(n_rows),
+        m_cell_width((bounds.max_x() - bounds.min_x()) / static_cast<double>(n_cols)),
+        m_cell_height((bounds.max_y() - bounds.min_y()) / static_cast<double>(n_rows)),
+        m_counts(n_cols * n_rows, 0) {
+    LASPP_ASSERT(n_cols > 0 && n_rows > 0, "Density grid needs at least one cell");
+    LASPP_ASSERT(m_cell_width > 0 && m_cell_height > 0, "Density grid bounds are empty");
+  }
+
+  const Bound2D& bounds() const { return m_bounds; }
+  size_t n_cols() const { return m_n_cols; }
+  size_t n_rows() const { return m_n_rows; }
+  double cell_area() const { return m_cell_width * m_cell_height; }
+
+  // Flat index (row * n_cols + col) of the grid cell containing (x, y).
+  std::optional<size_t> cell_at(double x, double y) const {
+    if (!m_bounds.contains(x, y)) {
+      return std::nullopt;
+    }
+    const size_t col =
+        std::min(static_cast<size_t>((x - m_bounds.min_x()) / m_cell_width), m_n_cols - 1);
+    const size_t row =
+        std::min(static_cast<size_t>((y - m_bounds.min_y()) / m_cell_height), m_n_rows - 1);
+    return row * m_n_cols + col;
+  }
+
+  void add(size_t cell, uint64_t n_points) { m_counts.at(cell) += n_points; }
+
+  const std::vector<uint64_t>& counts() const { return m_counts; }
+  uint64_t count(size_t col, size_t row) const { return m_counts.at(row * m_n_cols + col); }
+  // Points per unit area.
+  double density(size_t col, size_t row) const {
+    return static_cast<double>(count(col, row)) / cell_area();
+  }
+};
+
+// Partial answer to a count query from the index alone: points of cells entirely inside the
+// region are counted from the cell headers, while cells straddling its boundary contribute
+// their intervals, whose points must be decoded and tested.
+struct IndexCountPlan {
+  uint64_t n_points_inside = 0;
+  std::vector<PointInterval> boundary_intervals;
+};
+
 class QuadtreeSpatialIndex {
   QuadtreeHeader m_quadtree_header;
   std::map<int32_t, CellIntervals> m_cells;
@@ -245,9 +396,11 @@ class QuadtreeSpatialIndex {
       // Read intervals
       uint64_t computed_points = 0;
       for (uint32_t j = 0; j < number_intervals; ++j) {
-        PointInterval interval;
-        LASPP_CHECK_READ(is, &interval.start, 4);
-        LASPP_CHECK_READ(is, &interval.end, 4);
+        uint32_t start;
+        uint32_t end;
+        LASPP_CHECK_READ(is, &start, 4);
+        LASPP_CHECK_READ(is, &end, 4);
+        PointInterval interval{start, end};
 
         if (interval.start > interval.end) {
           throw std::runtime_error(
@@ -255,11 +408,11 @@ class QuadtreeSpatialIndex {
               std::to_string(interval.start) + ") > end (" + std::to_string(interval.end) + ")");
         }
 
-        computed_points += static_cast<uint64_t>(interval.end - interval.start) + 1u;
+        computed_points += interval.end - interval.start + 1u;
         cell.intervals.push_back(interval);
       }
 
-      if (computed_points != static_cast<uint64_t>(number_points)) {
+      if (computed_points != number_points) {
         throw std::runtime_error("Point count mismatch in spatial index cell " +
                                  std::to_string(cell_index) +
                                  ": number_points=" + std::to_string(number_points) +
@@ -275,8 +428,9 @@ class QuadtreeSpatialIndex {
   }
 
   // Build spatial index from points
-  template <typename PointType = LASPointFormat0>
-  explicit QuadtreeSpatialIndex(const LASHeader& header, const std::vector<PointType>& points = {},
+  template <typename PointType = LASPointFormat0, typename Allocator = std::allocator<PointType>>
+  explicit QuadtreeSpatialIndex(const LASHeader& header,
+                                const std::vector<PointType, Allocator>& points = {},
                                 double tile_size = 50.0) {
     // Initialize header signatures
     memcpy(m_quadtree_header.spatial_signature, "LASS", 4);
@@ -325,8 +479,23 @@ class QuadtreeSpatialIndex {
     double scale_y = header.transform().scale_factors().y();
     double offset_y = header.transform().offsets().y();
 
+    // 32-bit point indices halve the grouping memory and suffice for all but the largest files
+    if (points.size() <= std::numeric_limits<uint32_t>::max()) {
+      build_cells<uint32_t>(points, scale_x, offset_x, scale_y, offset_y);
+    } else {
+      build_cells<uint64_t>(points, scale_x, offset_x, scale_y, offset_y);
+    }
+  }
+
+ private:
+  template <typename IndexType, typename PointType, typename Allocator>
+  void build_cells(const std::vector<PointType, Allocator>& points, double scale_x,
+                   double offset_x, double scale_y, double offset_y) {
     // Group points by quadtree cell
-    std::map<int32_t, std::vector<uint32_t>> cell_to_points;
+    utilities::MemoryReservation grouping_reservation(
+        utilities::get_memory_budget(), points.size() * sizeof(IndexType),
+        "QuadtreeSpatialIndex construction (per-cell point lists)");
+    std::map<int32_t, std::vector<IndexType>> cell_to_points;
     for (size_t i = 0; i < points.size(); ++i) {
       // Read x, y using memcpy to avoid alignment issues with packed structures
       int32_t x_int, y_int;
@@ -336,24 +505,24 @@ class QuadtreeSpatialIndex {
       double y = int32_to_double(y_int, scale_y, offset_y);
 
       int32_t cell_index = get_cell_index(x, y);
-      cell_to_points[cell_index].push_back(static_cast<uint32_t>(i));
+      cell_to_points[cell_index].push_back(static_cast<IndexType>(i));
     }
 
     // Build intervals for each cell
     // Intervals are consecutive point ranges within each cell
     for (const auto& [cell_index, point_indices] : cell_to_points) {
       std::vector<PointInterval> intervals;
-      uint32_t interval_start = static_cast<uint32_t>(point_indices[0]);
-      uint32_t interval_end = interval_start;
+      uint64_t interval_start = point_indices[0];
+      uint64_t interval_end = interval_start;
 
       for (size_t i = 1; i < point_indices.size(); ++i) {
         if (point_indices[i] == interval_end + 1) {
           // Consecutive point, extend interval
-          interval_end = static_cast<uint32_t>(point_indices[i]);
+          interval_end = point_indices[i];
         } else {
           // Gap found, save current interval and start new one
           intervals.push_back({interval_start, interval_end});
-          interval_start = static_cast<uint32_t>(point_indices[i]);
+          interval_start = point_indices[i];
           interval_end = interval_start;
         }
       }
@@ -364,7 +533,6 @@ class QuadtreeSpatialIndex {
     }
   }
 
- private:
   void set_bounds(float min_x, float min_y, float max_x, float max_y) {
     m_quadtree_header.min_x = min_x;
     m_quadtree_header.min_y = min_y;
@@ -374,6 +542,8 @@ class QuadtreeSpatialIndex {
 
   void set_levels(uint32_t levels) { m_quadtree_header.levels = levels; }
 
+ public:
+  // Adds a cell covering the given point intervals; the point count is derived from them.
   void add_cell(int32_t cell_index, std::vector<PointInterval>&& intervals) {
     CellIntervals cell;
     cell.cell_index = cell_index;
@@ -387,8 +557,24 @@ class QuadtreeSpatialIndex {
     m_cells.emplace(cell_index, std::move(cell));
   }
 
- public:
+  // Whether every point index and count fits the 32-bit fields of the LAX format.
+  bool is_lax_representable() const {
+    for (const auto& [cell_index, cell] : m_cells) {
+      if (cell.number_points > std::numeric_limits<uint32_t>::max()) {
+        return false;
+      }
+      for (const auto& interval : cell.intervals) {
+        if (interval.end > std::numeric_limits<uint32_t>::max()) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
   void write(std::ostream& os) const {
+    LASPP_ASSERT(is_lax_representable(),
+                 "Spatial index covers points beyond the 32-bit range of the LAX format");
     // Write "LASX" signature
     os.write("LASX", 4);
 
@@ -412,13 +598,15 @@ class QuadtreeSpatialIndex {
       IntervalCellData cell_data;
       cell_data.cell_index = cell_index;
       cell_data.number_intervals = static_cast<uint32_t>(cell.intervals.size());
-      cell_data.number_points = cell.number_points;
+      cell_data.number_points = static_cast<uint32_t>(cell.number_points);
       os.write(reinterpret_cast<const char*>(&cell_data), sizeof(IntervalCellData));
 
       // Write intervals
       for (const auto& interval : cell.intervals) {
-        os.write(reinterpret_cast<const char*>(&interval.start), 4);
-        os.write(reinterpret_cast<const char*>(&interval.end), 4);
+        const uint32_t start = static_cast<uint32_t>(interval.start);
+        const uint32_t end = static_cast<uint32_t>(interval.end);
+        os.write(reinterpret_cast<const char*>(&start), 4);
+        os.write(reinterpret_cast<const char*>(&end), 4);
       }
     }
   }
@@ -613,6 +801,91 @@ class QuadtreeSpatialIndex {
                    current_min_y + cell_size_y);
   }
 
+  // Bounds that every point of the cell lies within: its quadtree bounds grown by `margin`,
+  // and extended to `data_bounds` on sides lying on the quadtree boundary, since the float
+  // quadtree bounds need not enclose every point and outlying points land in edge cells.
+  Bound2D get_cell_extent(int32_t cell_index, const Bound2D& data_bounds = {},
+                          double margin = 0.0) const {
+    const Bound2D bounds = get_cell_bounds(cell_index);
+    uint32_t col = 0;
+    uint32_t row = 0;
+    uint32_t cell_level = 0;
+    if (m_quadtree_header.levels != 0 && cell_index != 0) {
+      cell_level = get_cell_level_from_index(cell_index);
+      const uint32_t cell_path =
+          static_cast<uint32_t>(cell_index) - calculate_level_offset(cell_level);
+      for (uint32_t level = 0; level < cell_level; ++level) {
+        const uint32_t bits = (cell_path >> (2 * (cell_level - 1 - level))) & 3;
+        col = (col << 1) | (bits & 1);
+        row = (row << 1) | (bits >> 1);
+      }
+    }
+    const uint32_t last = (1u << cell_level) - 1;
+
+    double min_x = bounds.min_x() - margin;
+    double min_y = bounds.min_y() - margin;
+    double max_x = bounds.max_x() + margin;
+    double max_y = bounds.max_y() + margin;
+    if (col == 0) min_x = std::min(min_x, data_bounds.min_x());
+    if (row == 0) min_y = std::min(min_y, data_bounds.min_y());
+    if (col == last) max_x = std::max(max_x, data_bounds.max_x());
+    if (row == last) max_y = std::max(max_y, data_bounds.max_y());
+    return Bound2D(min_x, min_y, max_x, max_y);
+  }
+
+  // Total number of points referenced by the index.
+  uint64_t num_indexed_points() const {
+    uint64_t total = 0;
+    for (const auto& [cell_index, cell] : m_cells) {
+      total += cell.number_points;
+    }
+    return total;
+  }
+
+  // Resolves a point count over `region` (a Bound2D or Polygon2D) as far as the index allows.
+  // See get_cell_extent for `data_bounds` and `margin`.
+  template <typename Region>
+  IndexCountPlan plan_count(const Region& region, const Bound2D& data_bounds = {},
+                            double margin = 0.0) const {
+    IndexCountPlan plan;
+    for (const auto& [cell_index, cell] : m_cells) {
+      switch (region_coverage(region, get_cell_extent(cell_index, data_bounds, margin))) {
+        case CellCoverage::Inside:
+          plan.n_points_inside += cell.number_points;
+          break;
+        case CellCoverage::Partial:
+          plan.boundary_intervals.insert(plan.boundary_intervals.end(), cell.intervals.begin(),
+                                         cell.intervals.end());
+          break;
+        case CellCoverage::Outside:
+          break;
+      }
+    }
+    return plan;
+  }
+
+  // Adds the points of every cell that falls within a single grid cell to `grid` and returns
+  // the intervals of the cells spanning several grid cells, which must be decoded.
+  std::vector<PointInterval> plan_density_grid(DensityGrid& grid, const Bound2D& data_bounds = {},
+                                               double margin = 0.0) const {
+    std::vector<PointInterval> boundary_intervals;
+    for (const auto& [cell_index, cell] : m_cells) {
+      const Bound2D extent = get_cell_extent(cell_index, data_bounds, margin);
+      if (region_coverage(grid.bounds(), extent) == CellCoverage::Outside) {
+        continue;
+      }
+      const std::optional<size_t> first = grid.cell_at(extent.min_x(), extent.min_y());
+      const std::optional<size_t> last = grid.cell_at(extent.max_x(), extent.max_y());
+      if (first.has_value() && first == last) {
+        grid.add(*first, cell.number_points);
+      } else {
+        boundary_intervals.insert(boundary_intervals.end(), cell.intervals.begin(),
+                                  cell.intervals.end());
+      }
+    }
+    return boundary_intervals;
+  }
+
   friend std::ostream& operator<<(std::ostream& os, const QuadtreeSpatialIndex& index) {
     os << "Quadtree Header:" << std::endl;
     os << index.m_quadtree_header << std::endl;
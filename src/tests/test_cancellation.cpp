@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_stream_reader.hpp"
+#include "las_writer.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/cancellation.hpp"
+#include "utilities/thread_pool.hpp"
+
+using namespace laspp;
+using utilities::CancellationScope;
+using utilities::CancellationToken;
+using utilities::OperationCancelled;
+
+namespace {
+
+std::vector<LASPointFormat1> read_all(LASReader& reader) {
+  std::vector<LASPointFormat1> points(reader.num_points());
+  reader.read_chunks(std::span<LASPointFormat1>(points), {0, reader.num_chunks()});
+  return points;
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  setenv("LASPP_NUM_THREADS", "4", 1);
+
+  // Tokens and deadlines
+  {
+    CancellationToken token;
+    LASPP_ASSERT(!token.is_cancelled());
+    const CancellationToken copy = token;
+    copy.cancel();
+    LASPP_ASSERT(token.is_cancelled());
+    LASPP_ASSERT(CancellationToken::with_timeout(std::chrono::seconds(0)).is_cancelled());
+    LASPP_ASSERT(!CancellationToken::with_timeout(std::chrono::hours(1)).is_cancelled());
+
+    LASPP_ASSERT(!utilities::current_cancellation_token().has_value());
+    {
+      CancellationScope outer(CancellationToken{});
+      utilities::check_cancellation();
+      {
+        CancellationScope inner(token);
+        LASPP_ASSERT_THROWS(utilities::check_cancellation(), OperationCancelled);
+      }
+      utilities::check_cancellation();
+    }
+    LASPP_ASSERT(!utilities::current_cancellation_token().has_value());
+  }
+
+  // Parallel loops stop claiming chunks once cancelled, on the caller and on the workers
+  {
+    CancellationToken token;
+    CancellationScope scope(token);
+    std::atomic<size_t> n_visited{0};
+    LASPP_ASSERT_THROWS(utilities::parallel_for(size_t{0}, size_t{10000},
+                                                [&](size_t i) {
+                                                  if (i == 100) token.cancel();
+                                                  n_visited++;
+                                                }),
+                        OperationCancelled);
+    LASPP_ASSERT_LT(n_visited.load(), 10000u);
+    // Nested loops inherit the token
+    CancellationToken outer_token;
+    CancellationScope outer_scope(outer_token);
+    std::atomic<size_t> n_inner{0};
+    LASPP_ASSERT_THROWS(utilities::parallel_for(size_t{0}, size_t{8},
+                                                [&](size_t) {
+                                                  outer_token.cancel();
+                                                  utilities::parallel_for(
+                                                      size_t{0}, size_t{8},
+                                                      [&](size_t) { n_inner++; });
+                                                }),
+                        OperationCancelled);
+    LASPP_ASSERT_EQ(n_inner.load(), 0u);
+  }
+
+  std::mt19937_64 gen(92);
+  std::vector<LASPointFormat1> points(60000);
+  for (LASPointFormat1& point : points) {
+    point = LASPointFormat1::RandomData(gen);
+  }
+  std::stringstream laz_stream;
+  {
+    LASWriter writer(laz_stream, 1 | 128);
+    const std::span<const LASPointFormat1> all(points);
+    // One large chunk, checked within the chunk, then smaller ones
+    writer.write_points(all.subspan(0, 20000));
+    writer.write_points(all.subspan(20000), 5000);
+  }
+  laz_stream.seekg(0);
+  LASReader reader(laz_stream);
+
+  // Reads and copies throw once the deadline has passed, and work again without it
+  {
+    {
+      CancellationScope scope(CancellationToken::with_timeout(std::chrono::seconds(0)));
+      LASPP_ASSERT_THROWS(read_all(reader), OperationCancelled);
+      std::vector<LASPointFormat1> chunk(20000);
+      LASPP_ASSERT_THROWS(reader.read_chunk(std::span<LASPointFormat1>(chunk), 0),
+                          OperationCancelled);
+      std::stringstream copy_stream;
+      LASWriter writer(copy_stream, 1);
+      LASPP_ASSERT_THROWS(writer.copy_from_reader(reader), OperationCancelled);
+    }
+    LASPP_ASSERT(read_all(reader) == points);
+
+    // The stream reader gives up at once rather than reading on for more of a pointwise chunk
+    {
+      std::stringstream fixed_chunks;
+      {
+        LASWriter writer(fixed_chunks, 1 | 128);
+        writer.write_points(std::span<const LASPointFormat1>(points), 20000);
+      }
+      std::istringstream input(fixed_chunks.str());
+      LASStreamReader stream_reader(input);
+      CancellationScope scope(CancellationToken::with_timeout(std::chrono::seconds(0)));
+      LASPP_ASSERT_THROWS(
+          stream_reader.read_points<LASPointFormat1>([](std::span<LASPointFormat1>) {}),
+          OperationCancelled);
+      LASPP_ASSERT(!input.eof());
+    }
+
+    CancellationScope scope(CancellationToken::with_timeout(std::chrono::hours(1)));
+    LASPP_ASSERT(read_all(reader) == points);
+  }
+
+  // A cancelled write leaves a valid file holding the points of the writes completed before it,
+  // whether it stops before compressing, between chunks or not at all
+  for (int64_t timeout_us : {0, 200, 2000, 20000}) {
+    std::stringstream cancelled_stream;
+    const std::span<const LASPointFormat1> all(points);
+    try {
+      LASWriter writer(cancelled_stream, 1 | 128);
+      writer.write_points(all.subspan(0, 20000), 5000);
+      CancellationScope scope(
+          CancellationToken::with_timeout(std::chrono::microseconds(timeout_us)));
+      for (size_t first = 20000; first < points.size(); first += 10000) {
+        writer.write_points(all.subspan(first, 10000), 1000);
+      }
+    } catch (const OperationCancelled&) {
+    }
+    cancelled_stream.seekg(0);
+    LASReader cancelled_reader(cancelled_stream);
+    const size_t n_points = cancelled_reader.num_points();
+    LASPP_ASSERT_GE(n_points, 20000u, timeout_us);
+    LASPP_ASSERT_EQ((n_points - 20000) % 10000, 0u, timeout_us);
+    const std::vector<LASPointFormat1> written = read_all(cancelled_reader);
+    LASPP_ASSERT(std::equal(written.begin(), written.end(), points.begin()), timeout_us);
+  }
+
+  return 0;
+}
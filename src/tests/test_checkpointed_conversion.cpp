@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "checkpointed_conversion.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "test_files.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/file_sync.hpp"
+
+using namespace laspp;
+using namespace laspp::tests;
+
+namespace {
+
+const std::filesystem::path TEMP_DIR = std::filesystem::temp_directory_path();
+
+struct SimulatedCrash : std::runtime_error {
+  SimulatedCrash() : std::runtime_error("simulated crash") {}
+};
+
+void write_input(const std::filesystem::path& path, uint8_t point_format,
+                 const std::vector<LASPointFormat1>& points) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file << write_file(point_format, points);
+  LASPP_ASSERT(file.good());
+}
+
+std::string read_bytes(const std::filesystem::path& path) {
+  std::string bytes(std::filesystem::file_size(path), '\0');
+  std::ifstream file(path, std::ios::binary);
+  file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  LASPP_ASSERT(file.good());
+  return bytes;
+}
+
+// Converts `input` with a crash after `crash_after` checkpoints, then resumes; the result must
+// match the uninterrupted conversion byte for byte.
+void check_resume(const std::filesystem::path& input, const std::string& expected,
+                  CheckpointedConversionOptions options, size_t crash_after,
+                  bool add_garbage) {
+  const std::filesystem::path output = TEMP_DIR / "laspp_test_checkpoint_resumed.laz";
+  const std::filesystem::path checkpoint = TEMP_DIR / "laspp_test_checkpoint_resumed.ckpt";
+  std::filesystem::remove(checkpoint);
+
+  size_t n_checkpoints = 0;
+  options.on_checkpoint = [&](size_t) {
+    if (++n_checkpoints == crash_after) {
+      throw SimulatedCrash();
+    }
+  };
+  LASPP_ASSERT_THROWS(convert_with_checkpoints(input, output, checkpoint, options),
+                      SimulatedCrash);
+  LASPP_ASSERT(std::filesystem::exists(checkpoint));
+  const ConversionCheckpoint saved = ConversionCheckpoint::load(checkpoint);
+  LASPP_ASSERT_EQ(saved.input_chunks_done, crash_after * options.chunks_per_checkpoint);
+  if (add_garbage) {
+    // Points written after the checkpoint but never recorded
+    std::ofstream file(output, std::ios::binary | std::ios::app);
+    file << std::string(12345, 'x');
+  }
+
+  options.on_checkpoint = nullptr;
+  const size_t skipped = convert_with_checkpoints(input, output, checkpoint, options);
+  LASPP_ASSERT_EQ(skipped, saved.input_chunks_done);
+  LASPP_ASSERT(!std::filesystem::exists(checkpoint));
+  LASPP_ASSERT(read_bytes(output) == expected);
+  std::filesystem::remove(output);
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  setenv("LASPP_NUM_THREADS", "2", 1);
+  std::mt19937_64 gen(98);
+  std::vector<LASPointFormat1> points(23500);
+  for (LASPointFormat1& point : points) {
+    point = LASPointFormat1::RandomData(gen);
+  }
+
+  for (uint8_t input_format : {uint8_t{1 | 128}, uint8_t{1}}) {
+    const std::filesystem::path input = TEMP_DIR / "laspp_test_checkpoint_input.las";
+    write_input(input, input_format, points);
+    CheckpointedConversionOptions options;
+    options.chunks_per_checkpoint = 3;
+    options.uncompressed_chunk_points = 2000;
+
+    // Uninterrupted, checkpointing as it goes
+    const std::filesystem::path output = TEMP_DIR / "laspp_test_checkpoint_output.laz";
+    const std::filesystem::path checkpoint = TEMP_DIR / "laspp_test_checkpoint_output.ckpt";
+    std::filesystem::remove(checkpoint);
+    std::vector<size_t> progress;
+    options.on_checkpoint = [&](size_t chunks_done) { progress.push_back(chunks_done); };
+    LASPP_ASSERT_EQ(convert_with_checkpoints(input, output, checkpoint, options), 0u);
+    options.on_checkpoint = nullptr;
+    LASPP_ASSERT(!std::filesystem::exists(checkpoint));
+    LASPP_ASSERT(read_all(read_bytes(output)) == points);
+    {
+      LASReader reader(output);
+      LASReader input_reader(input);
+      LASPP_ASSERT(reader.header().is_laz_compressed());
+      LASPP_ASSERT_EQ(reader.wkt(), input_reader.wkt());
+      LASPP_ASSERT(reader.header().num_points_by_return() ==
+                   input_reader.header().num_points_by_return());
+      LASPP_ASSERT_EQ(reader.header().bounds().max_x(), input_reader.header().bounds().max_x());
+      // 1000-point LAZ chunks are kept; LAS input is chunked by uncompressed_chunk_points
+      const size_t n_chunks = (input_format & 128) ? 24 : 12;
+      LASPP_ASSERT_EQ(reader.num_chunks(), n_chunks);
+      LASPP_ASSERT_EQ(progress.size(), n_chunks / 3);
+      LASPP_ASSERT_EQ(progress.back(), n_chunks);
+    }
+    const std::string expected = read_bytes(output);
+    std::filesystem::remove(output);
+
+    check_resume(input, expected, options, 1, false);
+    check_resume(input, expected, options, 2, true);
+    // After the final checkpoint only the EVLRs, chunk table and header remain
+    check_resume(input, expected, options, progress.size(), true);
+
+    // A checkpoint is only accepted for the input it was written for
+    {
+      CheckpointedConversionOptions crashing = options;
+      crashing.on_checkpoint = [](size_t) { throw SimulatedCrash(); };
+      LASPP_ASSERT_THROWS(convert_with_checkpoints(input, output, checkpoint, crashing),
+                          SimulatedCrash);
+      const std::filesystem::path other = TEMP_DIR / "laspp_test_checkpoint_other.las";
+      write_input(other, input_format,
+                  std::vector<LASPointFormat1>(points.begin(), points.begin() + 5000));
+      LASPP_ASSERT_THROWS(convert_with_checkpoints(other, output, checkpoint, options),
+                          std::runtime_error);
+      std::filesystem::remove(other);
+      std::filesystem::remove(checkpoint);
+      std::filesystem::remove(output);
+    }
+    std::filesystem::remove(input);
+  }
+
+  // Syncing reports files that cannot be synced
+  LASPP_ASSERT_THROWS(utilities::sync_file(TEMP_DIR / "laspp_test_checkpoint_missing"),
+                      std::runtime_error);
+
+  // The writer checkpoint on its own: a LASWriter resumed over a stream continues the file
+  {
+    std::stringstream expected_stream;
+    {
+      LASWriter writer(expected_stream, 1 | 128);
+      writer.write_points(std::span<const LASPointFormat1>(points), 5000);
+    }
+    std::stringstream stream;
+    LASWriterCheckpoint checkpoint;
+    {
+      auto crash = [&]() {
+        LASWriter writer(stream, 1 | 128);
+        writer.write_points(std::span<const LASPointFormat1>(points).subspan(0, 10000), 5000);
+        checkpoint = writer.checkpoint();
+        throw SimulatedCrash();
+      };
+      LASPP_ASSERT_THROWS(crash(), SimulatedCrash);
+    }
+    LASPP_ASSERT_EQ(checkpoint.points_per_chunk.size(), 2u);
+    LASPP_ASSERT_EQ(checkpoint.header.num_points(), 10000u);
+    {
+      LASWriter writer(stream, checkpoint);
+      writer.write_points(std::span<const LASPointFormat1>(points).subspan(10000), 5000);
+    }
+    LASPP_ASSERT(stream.str() == expected_stream.str());
+  }
+
+  return 0;
+}
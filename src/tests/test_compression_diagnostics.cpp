@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "chunk_diagnostics.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+
+namespace {
+
+// Points ordered along x, so every chunk covers a narrow strip of the file
+template <typename PointType>
+std::vector<PointType> strip_points(std::mt19937_64& gen, size_t n) {
+  std::uniform_int_distribution<int32_t> coordinate(0, 100000);
+  std::vector<PointType> points(n);
+  for (size_t i = 0; i < n; i++) {
+    points[i] = PointType::RandomData(gen);
+    points[i].x = static_cast<int32_t>(i * 10);
+    points[i].y = coordinate(gen);
+    points[i].z = coordinate(gen);
+  }
+  return points;
+}
+
+template <typename PointType>
+void check_diagnostics(uint8_t point_format, const std::vector<PointType>& points,
+                       const std::vector<std::string>& expected_items,
+                       const std::vector<std::string>& expected_layers) {
+  std::stringstream stream;
+  {
+    LASWriter writer(stream, point_format);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {1000.0, 2000.0, 0.0});
+    writer.write_points(std::span<const PointType>(points), 5000);
+  }
+  LASReader reader(stream);
+  const CompressionDiagnostics diagnostics = diagnose_compression(reader);
+
+  LASPP_ASSERT(diagnostics.item_names == expected_items);
+  LASPP_ASSERT(diagnostics.layer_names == expected_layers);
+  LASPP_ASSERT_EQ(diagnostics.chunks.size(), reader.num_chunks());
+  LASPP_ASSERT_EQ(diagnostics.num_points(), points.size());
+  const std::vector<size_t> sizes = reader.compressed_chunk_sizes();
+  LASPP_ASSERT_EQ(diagnostics.compressed_bytes(),
+                  std::accumulate(sizes.begin(), sizes.end(), uint64_t{0}));
+
+  const Transform& transform = reader.header().transform();
+  for (const ChunkDiagnostics& chunk : diagnostics.chunks) {
+    // Every byte of the chunk is accounted for
+    LASPP_ASSERT_EQ(chunk.layer_bytes.size(), expected_layers.size());
+    LASPP_ASSERT_EQ(std::accumulate(chunk.layer_bytes.begin(), chunk.layer_bytes.end(),
+                                    uint64_t{0}) +
+                        chunk.overhead_bytes,
+                    chunk.compressed_bytes, chunk.chunk);
+    LASPP_ASSERT_EQ(chunk.item_decode_time.size(), expected_items.size());
+
+    int32_t min_x = points[chunk.first_point].x;
+    int32_t max_y = points[chunk.first_point].y;
+    for (size_t i = chunk.first_point; i < chunk.first_point + chunk.n_points; i++) {
+      min_x = std::min(min_x, points[i].x);
+      max_y = std::max(max_y, points[i].y);
+    }
+    LASPP_ASSERT_EQ(chunk.extent.min_x(),
+                    transform.transform_point(min_x, 0, 0).x(), chunk.chunk);
+    LASPP_ASSERT_EQ(chunk.extent.max_y(),
+                    transform.transform_point(0, max_y, 0).y(), chunk.chunk);
+  }
+
+  // Strips of 5000 of the points: each chunk covers about a fifth of the area
+  const double fraction = diagnostics.mean_chunk_area_fraction();
+  LASPP_ASSERT_GT(fraction, 0.15);
+  LASPP_ASSERT_LT(fraction, 0.25);
+
+  std::ostringstream report;
+  report << diagnostics;
+  for (const std::string& layer : expected_layers) {
+    LASPP_ASSERT(report.str().find(layer) != std::string::npos, layer);
+  }
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  setenv("LASPP_NUM_THREADS", "2", 1);
+  std::mt19937_64 gen(99);
+  const std::vector<LASPointFormat1> points = strip_points<LASPointFormat1>(gen, 23000);
+
+  check_diagnostics(7 | 128, strip_points<LASPointFormat7>(gen, 23000), {"Point 14", "RGB 14"},
+                    {"channel_returns_xy", "z", "classification", "flags", "intensity",
+                     "scan_angle", "user_data", "point_source", "gps_time", "rgb"});
+  check_diagnostics(1 | 128, points, {"Point 10", "GPSTime 11"}, {"pointwise"});
+
+  // Uncompressed files have no chunks to diagnose
+  {
+    std::stringstream stream;
+    {
+      LASWriter writer(stream, 1);
+      writer.write_points(std::span<const LASPointFormat1>(points).subspan(0, 100));
+    }
+    LASReader reader(stream);
+    LASPP_ASSERT_THROWS(diagnose_compression(reader), std::runtime_error);
+  }
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+
+// Small in-memory files shared by the tests of the whole-file operations.
+namespace laspp::tests {
+
+// Random points with X, Y and Z in [0, 100000], i.e. [0, 1000] metres from the offsets of the
+// transform write_file uses.
+template <typename T>
+std::vector<T> random_points(std::mt19937_64& gen, size_t n) {
+  std::uniform_int_distribution<int32_t> coordinate(0, 100000);
+  std::vector<T> points(n);
+  for (T& point : points) {
+    point = T::RandomData(gen);
+    point.x = coordinate(gen);
+    point.y = coordinate(gen);
+    point.z = coordinate(gen);
+  }
+  return points;
+}
+
+// Writes `points` with a WKT and the transform ({0.01, 0.01, 0.01}, {1000, 2000, 0}), in
+// chunks of `chunk_size` points if the point format is LAZ.
+template <typename T>
+std::string write_file(uint8_t point_format, const std::vector<T>& points,
+                       size_t chunk_size = 1000) {
+  std::stringstream stream;
+  {
+    LASWriter writer(stream, point_format);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {1000.0, 2000.0, 0.0});
+    writer.write_wkt("GEOGCS[\"WGS 84\"]");
+    writer.write_points(std::span<const T>(points), chunk_size);
+  }
+  return stream.str();
+}
+
+template <typename T = LASPointFormat1>
+std::vector<T> read_all(LASReader& reader) {
+  std::vector<T> points(reader.num_points());
+  reader.read_chunks(std::span<T>(points), {0, reader.num_chunks()});
+  return points;
+}
+
+template <typename T = LASPointFormat1>
+std::vector<T> read_all(const std::string& file) {
+  std::istringstream stream(file);
+  LASReader reader(stream);
+  return read_all<T>(reader);
+}
+
+}  // namespace laspp::tests
@@ -0,0 +1,189 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "gps_time_sort.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "test_files.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/memory_budget.hpp"
+
+using namespace laspp;
+using namespace laspp::tests;
+
+namespace {
+
+double time_of(const LASPointFormat1& point) { return point.gps_time.f64; }
+double time_of(const LASPointFormat7& point) { return point.gps_time; }
+
+void set_time(LASPointFormat1& point, double time) { point.gps_time.f64 = time; }
+void set_time(LASPointFormat7& point, double time) { point.gps_time = time; }
+
+// Three overlapping flight lines, one after the other, each in acquisition order. Times are
+// whole numbers so that the lines share some of them.
+template <typename PointType>
+std::vector<PointType> flight_lines(std::mt19937_64& gen, const std::vector<size_t>& sizes) {
+  std::vector<PointType> points;
+  for (size_t line = 0; line < sizes.size(); line++) {
+    double time = 1000.0 + 50.0 * static_cast<double>(line);
+    for (size_t i = 0; i < sizes[line]; i++) {
+      PointType point = PointType::RandomData(gen);
+      point.point_source_id = static_cast<uint16_t>(line + 1);
+      time += static_cast<double>(gen() % 2);
+      set_time(point, time);
+      points.push_back(point);
+    }
+  }
+  return points;
+}
+
+template <typename PointType>
+GPSTimeSortStatistics check_sort(uint8_t point_format, const std::vector<PointType>& points,
+                                 const GPSTimeSortOptions& options) {
+  const std::string file = write_file(point_format, points);
+  std::istringstream in(file);
+  LASReader reader(in);
+  std::stringstream out;
+  GPSTimeSortStatistics statistics;
+  {
+    LASWriter writer(out, point_format);
+    statistics = rewrite_in_gps_time_order(reader, writer, options);
+  }
+  LASReader sorted_reader(out);
+  LASPP_ASSERT_EQ(sorted_reader.wkt(), reader.wkt());
+  LASPP_ASSERT_EQ(sorted_reader.num_points(), points.size());
+  if (point_format & 128) {
+    LASPP_ASSERT_EQ(sorted_reader.points_per_chunk().front(), options.output_chunk_points);
+  }
+  LASPP_ASSERT(sorted_reader.header().num_points_by_return() ==
+               reader.header().num_points_by_return());
+
+  // Equal times keep their file order
+  std::vector<PointType> expected = points;
+  std::stable_sort(expected.begin(), expected.end(), [](const PointType& a, const PointType& b) {
+    return time_of(a) < time_of(b);
+  });
+  LASPP_ASSERT(read_all<PointType>(sorted_reader) == expected);
+  return statistics;
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  setenv("LASPP_NUM_THREADS", "2", 1);
+  std::mt19937_64 gen(100);
+  const std::filesystem::path temporary_directory =
+      std::filesystem::temp_directory_path() / "laspp_test_gps_time_sort";
+  std::filesystem::remove_all(temporary_directory);
+  std::filesystem::create_directories(temporary_directory);
+  GPSTimeSortOptions options;
+  options.output_chunk_points = 2000;
+  options.sort_run_points = 3000;
+  options.temporary_directory = temporary_directory;
+
+  // Flight lines are found as runs and merged from the input
+  {
+    const std::vector<size_t> sizes = {4500, 7000, 3100};
+    const std::vector<LASPointFormat1> points = flight_lines<LASPointFormat1>(gen, sizes);
+    std::istringstream in(write_file(1 | 128, points));
+    LASReader reader(in);
+    const std::vector<GPSTimeRun> runs = find_gps_time_runs(reader, 2500);
+    LASPP_ASSERT_EQ(runs.size(), 3u);
+    uint64_t first_point = 0;
+    for (size_t line = 0; line < runs.size(); line++) {
+      LASPP_ASSERT_EQ(runs[line].first_point, first_point, runs[line]);
+      LASPP_ASSERT_EQ(runs[line].num_points(), sizes[line], runs[line]);
+      LASPP_ASSERT_EQ(runs[line].point_source_id, line + 1);
+      LASPP_ASSERT_EQ(runs[line].first_time, time_of(points[first_point]));
+      LASPP_ASSERT_EQ(runs[line].last_time, time_of(points[runs[line].end_point - 1]));
+      first_point = runs[line].end_point;
+    }
+
+    for (uint8_t point_format : {uint8_t{1 | 128}, uint8_t{1}}) {
+      const GPSTimeSortStatistics statistics = check_sort(point_format, points, options);
+      LASPP_ASSERT_EQ(statistics.n_input_runs, 3u);
+      LASPP_ASSERT(!statistics.external_sort);
+      LASPP_ASSERT_EQ(statistics.n_merged_runs, 3u);
+    }
+    const std::vector<LASPointFormat7> points7 = flight_lines<LASPointFormat7>(gen, sizes);
+    LASPP_ASSERT(!check_sort(7 | 128, points7, options).external_sort);
+
+    // Without the memory for a 1000-point buffer per run, the lines are sorted externally
+    GPSTimeSortOptions small = options;
+    small.output_chunk_points = 500;
+    small.sort_run_points = 1000;
+    std::istringstream small_in(write_file(1 | 128, points));
+    LASReader small_reader(small_in);
+    std::stringstream out;
+    GPSTimeSortStatistics statistics;
+    {
+      LASWriter writer(out, 1 | 128);
+      utilities::get_memory_budget().set_limit(3 * 1000 * sizeof(LASPointFormat1) - 1);
+      statistics = rewrite_in_gps_time_order(small_reader, writer, small);
+      utilities::get_memory_budget().set_limit(std::nullopt);
+    }
+    LASPP_ASSERT(statistics.external_sort);
+    LASPP_ASSERT_EQ(statistics.n_merged_runs, 15u);
+    LASReader sorted_reader(out);
+    LASPP_ASSERT_EQ(sorted_reader.num_points(), points.size());
+  }
+
+  // A time break within a flight line starts a new run
+  {
+    std::vector<LASPointFormat1> points = flight_lines<LASPointFormat1>(gen, {5000});
+    set_time(points[2500], 0.0);
+    std::istringstream in(write_file(1 | 128, points));
+    LASReader reader(in);
+    const std::vector<GPSTimeRun> runs = find_gps_time_runs(reader);
+    LASPP_ASSERT_EQ(runs.size(), 2u);
+    LASPP_ASSERT_EQ(runs[1].first_point, 2500u);
+  }
+
+  // Unordered points have too many runs and are sorted externally
+  {
+    std::vector<LASPointFormat1> points = flight_lines<LASPointFormat1>(gen, {4000, 6000, 2500});
+    std::shuffle(points.begin(), points.end(), gen);
+    for (uint8_t point_format : {uint8_t{1 | 128}, uint8_t{1}}) {
+      const GPSTimeSortStatistics statistics = check_sort(point_format, points, options);
+      LASPP_ASSERT_GT(statistics.n_input_runs, options.max_merge_runs);
+      LASPP_ASSERT(statistics.external_sort);
+      LASPP_ASSERT_EQ(statistics.n_merged_runs, 5u);  // runs of three 1000-point chunks
+      LASPP_ASSERT_EQ(statistics.n_merge_passes, 1u);
+      LASPP_ASSERT(std::filesystem::is_empty(temporary_directory));
+    }
+
+    // More runs than the fan-in are merged in passes: 5 runs into 3, then 2, then the output
+    GPSTimeSortOptions narrow = options;
+    narrow.merge_fan_in = 2;
+    for (uint8_t point_format : {uint8_t{1 | 128}, uint8_t{1}}) {
+      const GPSTimeSortStatistics statistics = check_sort(point_format, points, narrow);
+      LASPP_ASSERT_EQ(statistics.n_merged_runs, 5u);
+      LASPP_ASSERT_EQ(statistics.n_merge_passes, 3u);
+      LASPP_ASSERT(std::filesystem::is_empty(temporary_directory));
+    }
+  }
+
+  // Point formats without GPS time cannot be sorted by it
+  {
+    std::vector<LASPointFormat0> points(100);
+    for (LASPointFormat0& point : points) point = LASPointFormat0::RandomData(gen);
+    std::istringstream in(write_file(0 | 128, points));
+    LASReader reader(in);
+    LASPP_ASSERT_THROWS(find_gps_time_runs(reader), std::runtime_error);
+  }
+
+  std::filesystem::remove_all(temporary_directory);
+  return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <sstream>
+#include <vector>
+
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/memory_budget.hpp"
+
+using namespace laspp;
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  // Byte size parsing
+  {
+    LASPP_ASSERT_EQ(utilities::parse_byte_size("1234").value(), 1234u);
+    LASPP_ASSERT_EQ(utilities::parse_byte_size("512K").value(), 512u << 10);
+    LASPP_ASSERT_EQ(utilities::parse_byte_size("256m").value(), 256u << 20);
+    LASPP_ASSERT_EQ(utilities::parse_byte_size("4G").value(), size_t{4} << 30);
+    LASPP_ASSERT(!utilities::parse_byte_size("").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size("0").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size("12X").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size("12KB").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size("-1").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size("+4G").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size(" 4G").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size("4G ").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size("4 ").has_value());
+    LASPP_ASSERT(!utilities::parse_byte_size("99999999999999999999999").has_value());
+  }
+
+  // Reservations are accounted and released
+  {
+    utilities::MemoryBudget budget(1000);
+    LASPP_ASSERT_EQ(budget.available(), 1000u);
+    LASPP_ASSERT(budget.try_reserve(600));
+    LASPP_ASSERT(!budget.try_reserve(500));
+    LASPP_ASSERT_EQ(budget.reserved(), 600u);
+    budget.release(600);
+
+    {
+      utilities::MemoryReservation a(budget, 700, "test");
+      LASPP_ASSERT_EQ(budget.available(), 300u);
+      LASPP_ASSERT(!utilities::MemoryReservation::try_reserve(budget, 400).has_value());
+      auto b = utilities::MemoryReservation::try_reserve(budget, 300);
+      LASPP_ASSERT(b.has_value());
+      LASPP_ASSERT_EQ(budget.available(), 0u);
+      utilities::MemoryReservation c(std::move(*b));
+      LASPP_ASSERT_EQ(budget.reserved(), 1000u);
+      c.reset();
+      LASPP_ASSERT_EQ(budget.reserved(), 700u);
+
+      bool threw = false;
+      try {
+        utilities::MemoryReservation d(budget, 400, "oversized request");
+      } catch (const utilities::MemoryBudgetExceeded& e) {
+        threw = std::string(e.what()).find("oversized request") != std::string::npos;
+      }
+      LASPP_ASSERT(threw);
+      LASPP_ASSERT_EQ(budget.reserved(), 700u);
+    }
+    LASPP_ASSERT_EQ(budget.reserved(), 0u);
+
+    utilities::MemoryBudget unlimited;
+    LASPP_ASSERT(!unlimited.limit().has_value());
+    LASPP_ASSERT(unlimited.try_reserve(size_t{1} << 60));
+  }
+
+  // Conversion under a tight global budget adapts instead of failing
+  std::stringstream input_stream;
+  {
+    LASWriter writer(input_stream, 1 | 128);
+    std::vector<LASPointFormat1> points(10000);
+    for (size_t i = 0; i < points.size(); i++) {
+      points[i] = LASPointFormat1{};
+      points[i].x = static_cast<int32_t>(i);
+      points[i].gps_time.f64 = static_cast<double>(i);
+    }
+    writer.write_points(std::span<const LASPointFormat1>(points), 100);
+  }
+
+  utilities::MemoryBudget& budget = utilities::get_memory_budget();
+  const std::optional<size_t> original_limit = budget.limit();
+  {
+    budget.set_limit(size_t{64} << 10);
+    input_stream.seekg(0);
+    LASReader reader(input_stream);
+    std::stringstream output_stream;
+    {
+      LASWriter writer(output_stream, 1 | 128);
+      writer.copy_from_reader(reader, false);
+    }
+    LASPP_ASSERT_EQ(budget.reserved(), 0u);
+    budget.set_limit(original_limit);
+
+    output_stream.seekg(0);
+    LASReader output_reader(output_stream);
+    LASPP_ASSERT_EQ(output_reader.num_points(), 10000u);
+    std::vector<LASPointFormat1> points(10000);
+    output_reader.read_chunks(std::span<LASPointFormat1>(points),
+                              {0, output_reader.num_chunks()});
+    for (size_t i = 0; i < points.size(); i++) {
+      LASPP_ASSERT_EQ(points[i].x, static_cast<int32_t>(i));
+    }
+  }
+
+  // A budget too small for even a single chunk fails with a clear error
+  {
+    budget.set_limit(size_t{1} << 10);
+    input_stream.seekg(0);
+    LASReader reader(input_stream);
+    std::stringstream output_stream;
+    bool threw = false;
+    try {
+      LASWriter writer(output_stream, 1 | 128);
+      writer.copy_from_reader(reader, false);
+    } catch (const utilities::MemoryBudgetExceeded&) {
+      threw = true;
+    }
+    budget.set_limit(original_limit);
+    LASPP_ASSERT(threw);
+    LASPP_ASSERT_EQ(budget.reserved(), 0u);
+  }
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "las_metadata_editor.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_stream_reader.hpp"
+#include "las_writer.hpp"
+#include "test_files.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+using namespace laspp::tests;
+
+namespace {
+
+std::string write_padded_file(uint8_t point_format, const std::vector<LASPointFormat1>& points,
+                              size_t padding) {
+  std::stringstream stream;
+  {
+    LASWriter writer(stream, point_format);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {0.0, 0.0, 0.0});
+    writer.write_wkt("GEOGCS[\"WGS 84\"]");
+    writer.reserve_vlr_padding(padding);
+    writer.write_points(std::span<const LASPointFormat1>(points), 1000);
+  }
+  return stream.str();
+}
+
+LASVLR custom_vlr(uint16_t record_id, size_t length) {
+  LASVLR vlr;
+  vlr.reserved = 0;
+  string_to_arr("LAS++ test", vlr.user_id);
+  vlr.record_id = record_id;
+  vlr.record_length_after_header = static_cast<uint16_t>(length);
+  string_to_arr("Test record", vlr.description);
+  return vlr;
+}
+
+// Everything from the point data onwards, which no edit may touch
+std::string point_data(const std::string& file) {
+  std::istringstream stream(file);
+  LASReader reader(stream);
+  return file.substr(reader.header().offset_to_point_data());
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  std::mt19937_64 gen(96);
+  std::vector<LASPointFormat1> points(5000);
+  for (LASPointFormat1& point : points) {
+    point = LASPointFormat1::RandomData(gen);
+  }
+
+  for (uint8_t point_format : {uint8_t{1}, uint8_t{1 | 128}}) {
+    const std::string original = write_padded_file(point_format, points, 4096);
+    std::istringstream original_stream(original);
+    LASReader original_reader(original_stream);
+    const size_t offset_to_point_data = original_reader.header().offset_to_point_data();
+    LASPP_ASSERT(read_all(original) == points);
+
+    // Grow the WKT and add a VLR in place
+    std::stringstream stream(original);
+    const std::string wkt = "PROJCS[\"NAD83 / UTM zone 10N\",GEOGCS[\"NAD83\"]]";
+    {
+      LASMetadataEditor editor(stream);
+      LASPP_ASSERT_EQ(editor.capacity(), offset_to_point_data - editor.header().size());
+      LASPP_ASSERT_GE(editor.free_bytes(), 4096u);
+      editor.set_wkt(wkt);
+      const std::vector<std::byte> data(300, std::byte{7});
+      editor.set_vlr(custom_vlr(1, data.size()), data);
+      editor.save();
+    }
+    std::string edited = stream.str();
+    LASPP_ASSERT_EQ(edited.size(), original.size());
+    LASPP_ASSERT(point_data(edited) == point_data(original));
+    {
+      std::istringstream edited_stream(edited);
+      LASReader reader(edited_stream);
+      LASPP_ASSERT_EQ(reader.header().offset_to_point_data(), offset_to_point_data);
+      LASPP_ASSERT_EQ(reader.wkt(), wkt);
+      LASPP_ASSERT(reader.header().global_encoding() & GlobalEncoding::WKT);
+      LASPP_ASSERT_EQ(reader.vlr_headers().size(), original_reader.vlr_headers().size() + 1);
+      LASPP_ASSERT(read_all(edited) == points);
+
+      std::istringstream pipe_stream(edited);
+      LASStreamReader stream_reader(pipe_stream);
+      LASPP_ASSERT_EQ(stream_reader.wkt(), wkt);
+      size_t n_points = 0;
+      stream_reader.read_points<LASPointFormat1>(
+          [&](std::span<LASPointFormat1> batch) { n_points += batch.size(); });
+      LASPP_ASSERT_EQ(n_points, points.size());
+    }
+
+    // Replace, remove, and run out of space
+    {
+      LASMetadataEditor editor(stream);
+      LASPP_ASSERT_EQ(editor.vlrs().size(), original_reader.vlr_headers().size() + 1);
+      const std::vector<std::byte> data(1000, std::byte{9});
+      editor.set_vlr(custom_vlr(1, data.size()), data);
+      LASPP_ASSERT(editor.remove_vlr("LASF_Projection", 2112));
+      LASPP_ASSERT(!editor.remove_vlr("LASF_Projection", 2112));
+      const std::vector<std::byte> too_big(editor.free_bytes() + 1, std::byte{0});
+      LASPP_ASSERT_THROWS(editor.set_vlr(custom_vlr(2, too_big.size()), too_big),
+                          std::runtime_error);
+      editor.save();
+    }
+    edited = stream.str();
+    LASPP_ASSERT(point_data(edited) == point_data(original));
+    {
+      std::istringstream edited_stream(edited);
+      LASReader reader(edited_stream);
+      LASPP_ASSERT(!reader.wkt().has_value());
+      LASPP_ASSERT_EQ(reader.read_vlr_data(reader.vlr_headers().back()).size(), 1000u);
+      LASPP_ASSERT(read_all(edited) == points);
+    }
+  }
+
+  // Without padding only edits that do not grow the VLRs fit
+  {
+    const std::string original = write_padded_file(1, points, 0);
+    std::stringstream stream(original);
+    LASMetadataEditor editor(stream);
+    LASPP_ASSERT_EQ(editor.free_bytes(), 0u);
+    LASPP_ASSERT_THROWS(editor.set_wkt("GEOGCS[\"WGS 84 with a longer name\"]"),
+                        std::runtime_error);
+    editor.set_wkt("GEOGCS[\"NAD 83\"]");
+    editor.save();
+    std::istringstream edited_stream(stream.str());
+    LASReader reader(edited_stream);
+    LASPP_ASSERT_EQ(reader.wkt(), "GEOGCS[\"NAD 83\"]");
+    LASPP_ASSERT(point_data(stream.str()) == point_data(original));
+  }
+
+  // Padding that would overflow the 32-bit offset to the point data is rejected
+  {
+    std::stringstream stream;
+    LASWriter writer(stream, 1);
+    LASPP_ASSERT_THROWS(writer.reserve_vlr_padding(std::numeric_limits<uint32_t>::max()),
+                        std::runtime_error);
+  }
+
+  // Editing a file on disk
+  {
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "laspp_test_metadata_editor.laz";
+    {
+      std::ofstream file(path, std::ios::binary);
+      const std::string original = write_padded_file(1 | 128, points, 512);
+      file.write(original.data(), static_cast<std::streamsize>(original.size()));
+    }
+    {
+      LASMetadataEditor editor(path);
+      editor.set_wkt("GEOGCS[\"ETRS89\"]");
+      editor.save();
+    }
+    {
+      LASReader reader(path);
+      LASPP_ASSERT_EQ(reader.wkt(), "GEOGCS[\"ETRS89\"]");
+      std::vector<LASPointFormat1> read(reader.num_points());
+      reader.read_chunks(std::span<LASPointFormat1>(read), {0, reader.num_chunks()});
+      LASPP_ASSERT(read == points);
+    }
+    std::filesystem::remove(path);
+  }
+
+  return 0;
+}
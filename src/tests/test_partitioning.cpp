@@ -0,0 +1,192 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "partitioning.hpp"
+#include "test_files.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+using namespace laspp::tests;
+
+namespace {
+
+// A LAZ file of uneven chunk sizes, so that balancing by bytes matters
+std::string write_uneven_chunks(const std::vector<LASPointFormat1>& points) {
+  std::stringstream stream;
+  {
+    LASWriter writer(stream, 1 | 128);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {1000.0, 2000.0, 0.0});
+    writer.write_wkt("GEOGCS[\"WGS 84\"]");
+    size_t first = 0;
+    for (size_t i = 0; first < points.size(); i++) {
+      const size_t n = std::min<size_t>(500 + (i % 4) * 700, points.size() - first);
+      writer.write_points(std::span<const LASPointFormat1>(points).subspan(first, n));
+      first += n;
+    }
+  }
+  return stream.str();
+}
+
+// Each partition is converted on its own thread, standing in for a worker process, from its
+// own reader of the input; the partial outputs are then merged.
+std::string convert_and_merge(const std::string& file, size_t n_partitions) {
+  std::istringstream plan_stream(file);
+  LASReader plan_reader(plan_stream);
+  const std::vector<PartitionRange> partitions = plan_partitions(plan_reader, n_partitions);
+
+  std::vector<std::string> parts(partitions.size());
+  std::vector<std::thread> workers;
+  for (size_t p = 0; p < partitions.size(); p++) {
+    workers.emplace_back([&, p]() {
+      std::istringstream stream(file);
+      LASReader reader(stream);
+      std::stringstream out;
+      {
+        LASWriter writer(out, reader.header().point_format() | 128);
+        convert_partition(reader, partitions[p], writer);
+      }
+      parts[p] = out.str();
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  std::vector<std::unique_ptr<std::istringstream>> part_streams;
+  std::vector<std::unique_ptr<LASReader>> part_readers;
+  std::vector<LASReader*> part_pointers;
+  for (size_t p = 0; p < parts.size(); p++) {
+    part_streams.push_back(std::make_unique<std::istringstream>(parts[p]));
+    part_readers.push_back(std::make_unique<LASReader>(*part_streams.back()));
+    LASPP_ASSERT_EQ(part_readers.back()->num_points(), partitions[p].num_points());
+    part_pointers.push_back(part_readers.back().get());
+  }
+  std::stringstream merged;
+  {
+    LASWriter writer(merged, part_readers.front()->header().point_format());
+    writer.merge_from_readers(part_pointers);
+  }
+  return merged.str();
+}
+
+void check_same_header(const LASHeader& merged, const LASHeader& original) {
+  LASPP_ASSERT_EQ(merged.num_points(), original.num_points());
+  LASPP_ASSERT(merged.num_points_by_return() == original.num_points_by_return());
+  LASPP_ASSERT_EQ(merged.bounds().min_x(), original.bounds().min_x());
+  LASPP_ASSERT_EQ(merged.bounds().min_y(), original.bounds().min_y());
+  LASPP_ASSERT_EQ(merged.bounds().min_z(), original.bounds().min_z());
+  LASPP_ASSERT_EQ(merged.bounds().max_x(), original.bounds().max_x());
+  LASPP_ASSERT_EQ(merged.bounds().max_y(), original.bounds().max_y());
+  LASPP_ASSERT_EQ(merged.bounds().max_z(), original.bounds().max_z());
+  LASPP_ASSERT_EQ(merged.transform().offsets(), original.transform().offsets());
+  LASPP_ASSERT_EQ(merged.transform().scale_factors(), original.transform().scale_factors());
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  setenv("LASPP_NUM_THREADS", "2", 1);
+  std::mt19937_64 gen(97);
+  const std::vector<LASPointFormat1> points = random_points<LASPointFormat1>(gen, 30000);
+
+  // The plan covers every chunk once, in order, with balanced compressed bytes
+  const std::string laz_file = write_uneven_chunks(points);
+  std::istringstream laz_stream(laz_file);
+  LASReader laz_reader(laz_stream);
+  const size_t n_chunks = laz_reader.num_chunks();
+  LASPP_ASSERT_GT(n_chunks, 10u);
+  {
+    const std::vector<PartitionRange> partitions = plan_partitions(laz_reader, 4);
+    LASPP_ASSERT_EQ(partitions.size(), 4u);
+    uint64_t total_bytes = 0;
+    uint64_t max_chunk_bytes = 0;
+    for (size_t size : laz_reader.compressed_chunk_sizes()) {
+      total_bytes += size;
+      max_chunk_bytes = std::max<uint64_t>(max_chunk_bytes, size);
+    }
+    size_t next_chunk = 0;
+    uint64_t next_point = 0;
+    for (const PartitionRange& partition : partitions) {
+      LASPP_ASSERT_EQ(partition.first_chunk, next_chunk);
+      LASPP_ASSERT_EQ(partition.first_point, next_point);
+      LASPP_ASSERT_LT(partition.first_chunk, partition.end_chunk);
+      LASPP_ASSERT_LE(partition.bytes, total_bytes / 4 + max_chunk_bytes, partition);
+      next_chunk = partition.end_chunk;
+      next_point = partition.end_point;
+    }
+    LASPP_ASSERT_EQ(next_chunk, n_chunks);
+    LASPP_ASSERT_EQ(next_point, points.size());
+
+    // More partitions than chunks gives one chunk each
+    LASPP_ASSERT_EQ(plan_partitions(laz_reader, n_chunks + 5).size(), n_chunks);
+    LASPP_ASSERT_EQ(plan_partitions(laz_reader, 1).front().end_chunk, n_chunks);
+  }
+
+  // Converting the partitions separately and merging gives back the whole file, with the same
+  // chunks and header statistics
+  for (size_t n_partitions : {size_t{1}, size_t{3}, size_t{4}, size_t{7}}) {
+    const std::string merged = convert_and_merge(laz_file, n_partitions);
+    LASPP_ASSERT(read_all(merged) == points, n_partitions);
+    std::istringstream merged_stream(merged);
+    LASReader merged_reader(merged_stream);
+    check_same_header(merged_reader.header(), laz_reader.header());
+    LASPP_ASSERT(merged_reader.points_per_chunk() == laz_reader.points_per_chunk());
+    LASPP_ASSERT(merged_reader.compressed_chunk_sizes() == laz_reader.compressed_chunk_sizes());
+    LASPP_ASSERT_EQ(merged_reader.wkt(), laz_reader.wkt());
+  }
+
+  // LAS input is split by points and compressed by each worker
+  {
+    const std::string las_file = write_file(1, points);
+    std::istringstream las_stream(las_file);
+    LASReader las_reader(las_stream);
+    const std::vector<PartitionRange> partitions = plan_partitions(las_reader, 3);
+    LASPP_ASSERT_EQ(partitions.size(), 3u);
+    LASPP_ASSERT_EQ(partitions[1].first_point, 10000u);
+    LASPP_ASSERT_EQ(partitions[1].bytes, 10000u * sizeof(LASPointFormat1));
+
+    const std::string merged = convert_and_merge(las_file, 3);
+    LASPP_ASSERT(read_all(merged) == points);
+    std::istringstream merged_stream(merged);
+    LASReader merged_reader(merged_stream);
+    check_same_header(merged_reader.header(), las_reader.header());
+    LASPP_ASSERT_EQ(merged_reader.num_chunks(), 3u);
+  }
+
+  // Parts with different transforms cannot be concatenated
+  {
+    std::stringstream other;
+    {
+      LASWriter writer(other, 1 | 128);
+      writer.header().transform() = Transform({0.001, 0.001, 0.001}, {0.0, 0.0, 0.0});
+      writer.write_points(std::span<const LASPointFormat1>(points).subspan(0, 100));
+    }
+    std::istringstream other_stream(other.str());
+    LASReader other_reader(other_stream);
+    std::vector<LASReader*> parts = {&laz_reader, &other_reader};
+    // The writer is left without points, so it must unwind with the error
+    auto merge = [&]() {
+      std::stringstream out;
+      LASWriter writer(out, 1 | 128);
+      writer.merge_from_readers(parts);
+    };
+    LASPP_ASSERT_THROWS(merge(), std::runtime_error);
+  }
+
+  return 0;
+}
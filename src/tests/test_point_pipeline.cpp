@@ -0,0 +1,281 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "point_pipeline.hpp"
+#include "test_files.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/cancellation.hpp"
+
+using namespace laspp;
+using namespace laspp::tests;
+
+namespace {
+
+// Random points with classifications 1 to 6
+std::vector<LASPointFormat1> classified_points(std::mt19937_64& gen, size_t n) {
+  std::uniform_int_distribution<uint8_t> classification(1, 6);
+  std::vector<LASPointFormat1> points = random_points<LASPointFormat1>(gen, n);
+  for (LASPointFormat1& point : points) {
+    point.classification_byte.classification =
+        static_cast<LASClassification>(classification(gen));
+  }
+  return points;
+}
+
+std::string run_pipeline(PointPipeline<LASPointFormat1>& pipeline, uint8_t point_format) {
+  std::stringstream out;
+  {
+    LASWriter writer(out, point_format);
+    pipeline.run(writer);
+  }
+  return out.str();
+}
+
+const Bound2D REGION(1200.0, 2100.0, 1800.0, 2900.0);
+
+// The crop / keep-classes / reclassify / translate / thin pipeline applied point by point
+std::vector<LASPointFormat1> expected_output(const std::vector<LASPointFormat1>& input,
+                                             const Transform& transform) {
+  std::vector<LASPointFormat1> expected;
+  size_t n_survivors = 0;
+  for (LASPointFormat1 point : input) {
+    const Vector3D position = transform.transform_point(point.x, point.y, point.z);
+    const uint8_t classification = static_cast<uint8_t>(point.classification_byte.classification);
+    if (!REGION.contains(position.x(), position.y()) ||
+        (classification != 2 && classification != 3 && classification != 6)) {
+      continue;
+    }
+    if (classification == 3) {
+      point.classification_byte.classification = LASClassification::MediumVegetation;
+    }
+    point.x += 50;
+    point.y -= 100;
+    point.z += 1;
+    if (n_survivors++ % 3 == 0) {
+      expected.push_back(point);
+    }
+  }
+  return expected;
+}
+
+void add_standard_stages(PointPipeline<LASPointFormat1>& pipeline) {
+  pipeline.crop(REGION)
+      .keep_classes({2, 3, 6})
+      .reclassify(3, 4)
+      .translate(0.5, -1.0, 0.01)
+      .thin(3);
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  setenv("LASPP_NUM_THREADS", "4", 1);
+  std::mt19937_64 gen(94);
+  const std::vector<LASPointFormat1> points = classified_points(gen, 20000);
+  const Transform transform({0.01, 0.01, 0.01}, {1000.0, 2000.0, 0.0});
+  const std::vector<LASPointFormat1> expected = expected_output(points, transform);
+  LASPP_ASSERT_GT(expected.size(), 100u);
+
+  // Multi-stage pipeline over LAZ chunks, matching the stages applied point by point
+  {
+    const std::string file = write_file(1 | 128, points);
+    std::istringstream stream(file);
+    LASReader reader(stream);
+    PointPipeline<LASPointFormat1> pipeline(reader);
+    add_standard_stages(pipeline);
+    const std::string output = run_pipeline(pipeline, 1 | 128);
+    LASPP_ASSERT(read_all(output) == expected);
+
+    std::istringstream output_stream(output);
+    LASReader output_reader(output_stream);
+    LASPP_ASSERT_EQ(output_reader.wkt(), reader.wkt());
+    LASPP_ASSERT_EQ(output_reader.header().transform().offsets(),
+                    reader.header().transform().offsets());
+    LASPP_ASSERT_EQ(output_reader.num_points(), expected.size());
+    // Survivors of the 1000-point input chunks are gathered into full 1000-point output chunks
+    const std::vector<size_t> points_per_chunk = output_reader.points_per_chunk();
+    LASPP_ASSERT_EQ(points_per_chunk.size(), (expected.size() + 999) / 1000);
+    for (size_t c = 0; c + 1 < points_per_chunk.size(); c++) {
+      LASPP_ASSERT_EQ(points_per_chunk[c], 1000u, c);
+    }
+
+    const std::vector<PipelineStageStatistics>& stats = pipeline.statistics();
+    LASPP_ASSERT_EQ(stats.size(), 7u);
+    LASPP_ASSERT_EQ(stats.front().name, "read");
+    LASPP_ASSERT_EQ(stats[1].name, "crop");
+    LASPP_ASSERT_EQ(stats.back().name, "write");
+    LASPP_ASSERT_EQ(stats.front().points_in, points.size());
+    for (size_t s = 0; s < stats.size(); s++) {
+      LASPP_ASSERT_EQ(stats[s].batches, 20u, stats[s].name);
+      LASPP_ASSERT_LE(stats[s].points_out, stats[s].points_in);
+      if (s > 0) {
+        LASPP_ASSERT_EQ(stats[s].points_in, stats[s - 1].points_out);
+      }
+    }
+    LASPP_ASSERT_EQ(stats.back().points_out, expected.size());
+    LASPP_ASSERT_LE(pipeline.peak_batches_in_flight(), pipeline.max_batches_in_flight());
+  }
+
+  // Uncompressed input into LAZ output, with a pipeline of no stages copying everything
+  {
+    const std::vector<LASPointFormat1> many_points = classified_points(gen, 120000);
+    const std::string file = write_file(1, many_points);
+    std::istringstream stream(file);
+    LASReader reader(stream);
+    PointPipeline<LASPointFormat1> copy(reader);
+    LASPP_ASSERT(read_all(run_pipeline(copy, 1 | 128)) == many_points);
+    LASPP_ASSERT_EQ(copy.statistics().front().batches, 3u);
+
+    PointPipeline<LASPointFormat1> pipeline(reader);
+    add_standard_stages(pipeline);
+    LASPP_ASSERT(read_all(run_pipeline(pipeline, 1)) == expected_output(many_points, transform));
+
+    PointPipeline<LASPointFormat1> rechunked(reader);
+    add_standard_stages(rechunked);
+    rechunked.output_chunk_size(256);
+    const std::string output = run_pipeline(rechunked, 1 | 128);
+    const std::vector<LASPointFormat1> expected_many = expected_output(many_points, transform);
+    LASPP_ASSERT(read_all(output) == expected_many);
+    std::istringstream output_stream(output);
+    LASReader output_reader(output_stream);
+    const std::vector<size_t> points_per_chunk = output_reader.points_per_chunk();
+    LASPP_ASSERT_EQ(points_per_chunk.size(), (expected_many.size() + 255) / 256);
+    LASPP_ASSERT_EQ(points_per_chunk.back(),
+                    expected_many.size() - 256 * (points_per_chunk.size() - 1));
+  }
+
+  // Backpressure: with a slow stage the source never runs more than the limit ahead of the sink,
+  // and a stage limited to one batch at a time never runs concurrently
+  {
+    const std::string file = write_file(1 | 128, points);
+    std::istringstream stream(file);
+    LASReader reader(stream);
+    PointPipeline<LASPointFormat1> pipeline(reader, 2);
+    std::atomic<size_t> n_active{0};
+    std::atomic<size_t> max_active{0};
+    pipeline.add_stage(
+        "serial",
+        [&](PointBatch<LASPointFormat1>&) {
+          const size_t active = ++n_active;
+          size_t previous = max_active.load();
+          while (previous < active && !max_active.compare_exchange_weak(previous, active)) {
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          n_active--;
+        },
+        1);
+    add_standard_stages(pipeline);
+    LASPP_ASSERT(read_all(run_pipeline(pipeline, 1 | 128)) == expected);
+    LASPP_ASSERT_EQ(max_active.load(), 1u);
+    LASPP_ASSERT_LE(pipeline.peak_batches_in_flight(), 2u);
+  }
+
+  // Affine transform with requantisation: a rotation about Z plus a shift into a finer output
+  // transform, checked against transforming each point in doubles
+  {
+    const std::string file = write_file(1 | 128, points);
+    std::istringstream stream(file);
+    LASReader reader(stream);
+    const double angle = 0.3;
+    const AffineTransform affine({{{std::cos(angle), -std::sin(angle), 0.0, 250.5},
+                                   {std::sin(angle), std::cos(angle), 0.0, -75.25},
+                                   {0.0, 0.0, 1.0, 10.0}}});
+    const Transform output_transform({0.001, 0.001, 0.005}, {1500.0, 2500.0, 0.0});
+    PointPipeline<LASPointFormat1> pipeline(reader);
+    pipeline.affine_transform(affine, output_transform).crop(Bound2D(0.0, 0.0, 1e6, 1e6));
+    const std::vector<LASPointFormat1> output = read_all(run_pipeline(pipeline, 1 | 128));
+    LASPP_ASSERT_EQ(output.size(), points.size());
+
+    double min_x = std::numeric_limits<double>::max();
+    double max_x = std::numeric_limits<double>::lowest();
+    for (size_t i = 0; i < points.size(); i++) {
+      const Vector3D moved =
+          affine.apply(transform.transform_point(points[i].x, points[i].y, points[i].z));
+      const Vector3D position = output_transform.transform_point(output[i].x, output[i].y,
+                                                                 output[i].z);
+      for (size_t c = 0; c < 3; c++) {
+        LASPP_ASSERT_LE(std::abs(position[c] - moved[c]),
+                        0.5 * output_transform.scale_factors()[c] + 1e-9, i);
+      }
+      LASPP_ASSERT_EQ(output[i].intensity, points[i].intensity);
+      min_x = std::min(min_x, position.x());
+      max_x = std::max(max_x, position.x());
+    }
+
+    std::istringstream output_stream(run_pipeline(pipeline, 1));
+    LASReader output_reader(output_stream);
+    LASPP_ASSERT_EQ(output_reader.header().transform().scale_factors(),
+                    output_transform.scale_factors());
+    LASPP_ASSERT_EQ(output_reader.header().transform().offsets(), output_transform.offsets());
+    LASPP_ASSERT_LE(std::abs(output_reader.header().bounds().min_x() - min_x), 1e-6);
+    LASPP_ASSERT_LE(std::abs(output_reader.header().bounds().max_x() - max_x), 1e-6);
+
+    // The identity keeps every coordinate exactly; the default output transform maps offsets
+    PointPipeline<LASPointFormat1> identity(reader);
+    identity.affine_transform(AffineTransform());
+    LASPP_ASSERT(read_all(run_pipeline(identity, 1 | 128)) == points);
+    PointPipeline<LASPointFormat1> shifted(reader);
+    shifted.affine_transform(AffineTransform({{{1, 0, 0, 5}, {0, 1, 0, 6}, {0, 0, 1, 7}}}));
+    LASPP_ASSERT(read_all(run_pipeline(shifted, 1 | 128)) == points);
+
+    // Points pushed outside the range of the output transform are an error
+    PointPipeline<LASPointFormat1> overflow(reader);
+    overflow.affine_transform(AffineTransform({{{1e6, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}}),
+                              reader.header().transform());
+    std::stringstream out;
+    LASWriter writer(out, 1);
+    LASPP_ASSERT_THROWS(overflow.run(writer), std::runtime_error);
+  }
+
+  // A failing stage stops the pipeline and its exception reaches the caller
+  {
+    const std::string file = write_file(1 | 128, points);
+    std::istringstream stream(file);
+    LASReader reader(stream);
+    PointPipeline<LASPointFormat1> pipeline(reader);
+    pipeline.add_stage("fail", [](PointBatch<LASPointFormat1>& batch) {
+      if (batch.sequence == 7) {
+        throw std::runtime_error("stage failed");
+      }
+    });
+    std::stringstream out;
+    LASWriter writer(out, 1 | 128);
+    bool threw = false;
+    try {
+      pipeline.run(writer);
+    } catch (const std::runtime_error& e) {
+      threw = std::string(e.what()) == "stage failed";
+    }
+    LASPP_ASSERT(threw);
+    LASPP_ASSERT_LT(pipeline.statistics().back().batches, 20u);
+
+    // Cancellation likewise
+    utilities::CancellationToken token;
+    token.cancel();
+    utilities::CancellationScope scope(token);
+    std::stringstream cancelled_out;
+    LASWriter cancelled_writer(cancelled_out, 1);
+    PointPipeline<LASPointFormat1> cancelled(reader);
+    LASPP_ASSERT_THROWS(cancelled.run(cancelled_writer), utilities::OperationCancelled);
+  }
+
+  return 0;
+}
@@ -6,7 +6,9 @@
 
 #include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <random>
 
 #include "example_custom_las_point.hpp"
 #include "las_header.hpp"
@@ -577,6 +579,196 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     }
   }
 
+  // Stream path reuses pooled chunk buffers instead of allocating one per chunk
+  {
+    std::stringstream stream;
+    {
+      LASWriter writer(stream, 1 | 128);
+      std::vector<LASPointFormat1> points(1000);
+      for (size_t i = 0; i < points.size(); i++) {
+        points[i] = LASPointFormat1{};
+        points[i].x = static_cast<int32_t>(i);
+        points[i].gps_time.f64 = static_cast<double>(i);
+      }
+      writer.write_points(std::span<const LASPointFormat1>(points), 10);
+    }
+
+    LASReader reader(stream);
+    LASPP_ASSERT(!reader.is_using_memory_mapping(), "Reader should be using stream I/O");
+    LASPP_ASSERT_EQ(reader.num_chunks(), 100);
+    std::vector<LASPointFormat1> points(1000);
+    for (int pass = 0; pass < 3; pass++) {
+      reader.read_chunks(std::span<LASPointFormat1>(points), {0, reader.num_chunks()});
+      std::vector<size_t> odd_chunks;
+      for (size_t i = 1; i < reader.num_chunks(); i += 2) odd_chunks.push_back(i);
+      reader.read_chunks_list(std::span<LASPointFormat1>(points), odd_chunks);
+    }
+    reader.read_chunks(std::span<LASPointFormat1>(points), {0, reader.num_chunks()});
+    for (size_t i = 0; i < points.size(); i++) {
+      LASPP_ASSERT_EQ(points[i].x, static_cast<int32_t>(i));
+    }
+
+    utilities::BufferPool::Stats stats = reader.read_buffer_stats();
+    LASPP_ASSERT_GE(stats.n_acquired, 3u * 150u + 100u);
+    // At most one buffer per concurrently decoding thread (plus EVLR/VLR reads) is allocated.
+    LASPP_ASSERT_LE(stats.n_allocations, utilities::get_num_threads() + 2);
+    LASPP_ASSERT_LT(stats.bytes_allocated_per_acquire(), 1000.0);
+  }
+
+  // The chunk table is only read once the point data is accessed
+  {
+    std::stringstream stream;
+    {
+      LASWriter writer(stream, 1 | 128);
+      std::vector<LASPointFormat1> points(100);
+      writer.write_points(std::span<const LASPointFormat1>(points), 10);
+    }
+    std::string data = stream.str();
+    const size_t offset_to_point_data = LASReader(stream).header().offset_to_point_data();
+    const int64_t bad_chunk_table_offset = int64_t{1} << 40;
+    std::memcpy(data.data() + offset_to_point_data, &bad_chunk_table_offset, sizeof(int64_t));
+
+    std::stringstream corrupted(data);
+    LASReader reader(corrupted);
+    LASPP_ASSERT_EQ(reader.num_points(), 100u);
+    LASPP_ASSERT_THROWS(reader.num_chunks(), std::runtime_error);
+  }
+
+  // Random access by point index, with and without intra-chunk checkpoints
+  {
+    TempFile laz_file("test_read_by_index_laz");
+    TempFile las_file("test_read_by_index_las");
+    std::mt19937_64 gen(80);
+    std::vector<LASPointFormat7> points(5000);
+    for (LASPointFormat7& point : points) {
+      point = LASPointFormat7::RandomData(gen);
+    }
+    for (const auto& [file, format] : {std::pair{&laz_file, 7 | 128}, std::pair{&las_file, 7}}) {
+      std::fstream ofs(file->path(),
+                       std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+      LASWriter writer(ofs, static_cast<uint8_t>(format));
+      writer.write_points(std::span<const LASPointFormat7>(points), 1000);
+    }
+
+    std::vector<size_t> indices(300);
+    for (size_t& index : indices) {
+      index = gen() % points.size();
+    }
+    indices.insert(indices.end(), {0, 999, 1000, 4999, 4999, indices[10]});
+
+    auto check = [&](LASReader& reader) {
+      std::vector<LASPointFormat7> output(indices.size());
+      auto result = reader.read_points_by_index(std::span<LASPointFormat7>(output),
+                                                std::span<const size_t>(indices));
+      LASPP_ASSERT_EQ(result.size(), indices.size());
+      for (size_t i = 0; i < indices.size(); i++) {
+        LASPP_ASSERT(output[i] == points[indices[i]], "Point ", indices[i], " differs");
+      }
+    };
+
+    for (const TempFile* file : {&laz_file, &las_file}) {
+      LASReader mapped_reader(file->path());
+      LASPP_ASSERT(mapped_reader.is_using_memory_mapping());
+      check(mapped_reader);
+      mapped_reader.enable_point_checkpoints(128);
+      LASPP_ASSERT_EQ(mapped_reader.has_point_checkpoints(), file == &laz_file);
+      check(mapped_reader);
+
+      std::ifstream ifs(file->path(), std::ios::binary);
+      LASReader stream_reader(ifs);
+      LASPP_ASSERT(!stream_reader.is_using_memory_mapping());
+      check(stream_reader);
+      stream_reader.enable_point_checkpoints(300);
+      check(stream_reader);
+    }
+
+    // Checkpoints are built per chunk as reads need them, and at most `max_snapshots` are kept
+    // once a read is done (7 per chunk of 1000 points at an interval of 128)
+    {
+      std::ifstream ifs(laz_file.path(), std::ios::binary);
+      LASReader reader(ifs);
+      reader.enable_point_checkpoints(128, 10);
+      LASPP_ASSERT_EQ(reader.num_cached_point_checkpoints(), 0u);
+      for (size_t chunk = 0; chunk < 5; chunk++) {
+        const std::vector<size_t> chunk_indices = {chunk * 1000 + 900, chunk * 1000 + 300};
+        std::vector<LASPointFormat7> output(chunk_indices.size());
+        reader.read_points_by_index(std::span<LASPointFormat7>(output),
+                                    std::span<const size_t>(chunk_indices));
+        for (size_t i = 0; i < chunk_indices.size(); i++) {
+          LASPP_ASSERT(output[i] == points[chunk_indices[i]], "Point ", chunk_indices[i]);
+        }
+        LASPP_ASSERT_EQ(reader.num_cached_point_checkpoints(), 7u);
+      }
+      check(reader);
+      LASPP_ASSERT_EQ(reader.num_cached_point_checkpoints(), 35u);
+      check(reader);
+    }
+
+    LASReader reader(laz_file.path());
+    std::vector<LASPointFormat7> output(1);
+    const std::vector<size_t> out_of_range{points.size()};
+    LASPP_ASSERT_THROWS(reader.read_points_by_index(std::span<LASPointFormat7>(output),
+                                                    std::span<const size_t>(out_of_range)),
+                        std::runtime_error);
+  }
+
+  // Zero-copy views over uncompressed memory-mapped point records
+  {
+    TempFile las_file("test_mapped_points");
+    TempFile laz_file("test_mapped_points_laz");
+    std::mt19937_64 gen(83);
+    std::vector<LASPointFormat3> points(1000);
+    for (LASPointFormat3& point : points) {
+      point = LASPointFormat3::RandomData(gen);
+    }
+    for (const auto& [file, format] : {std::pair{&las_file, 3}, std::pair{&laz_file, 3 | 128}}) {
+      std::fstream ofs(file->path(),
+                       std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+      LASWriter writer(ofs, static_cast<uint8_t>(format));
+      writer.write_points(std::span<const LASPointFormat3>(points));
+    }
+
+    LASReader reader(las_file.path());
+    LASPP_ASSERT(reader.is_using_memory_mapping());
+    std::optional<std::span<const LASPointFormat3>> records =
+        reader.mapped_points<LASPointFormat3>();
+    LASPP_ASSERT(records.has_value());
+    LASPP_ASSERT_EQ(records->size(), points.size());
+    LASPP_ASSERT(std::equal(records->begin(), records->end(), points.begin()));
+    LASPP_ASSERT(!reader.mapped_points<LASPointFormat1>().has_value());
+
+    std::optional<StridedPointView<GPSTime>> times = reader.mapped_point_view<GPSTime>();
+    std::optional<StridedPointView<ColorData>> colors = reader.mapped_point_view<ColorData>();
+    LASPP_ASSERT(times.has_value() && colors.has_value());
+    LASPP_ASSERT_EQ(times->size(), points.size());
+    LASPP_ASSERT_EQ(times->stride(), sizeof(LASPointFormat3));
+    size_t i = 0;
+    for (const GPSTime& time : *times) {
+      LASPP_ASSERT_EQ(time.gps_time.f64, points[i].gps_time.f64);
+      LASPP_ASSERT((*colors)[i] == static_cast<const ColorData&>(points[i]));
+      i++;
+    }
+    LASPP_ASSERT_EQ(i, points.size());
+    LASPP_ASSERT(reader.mapped_point_view<LASPointFormat0>().has_value());
+    LASPP_ASSERT(!reader.mapped_point_view<LASPointFormat6>().has_value());
+
+    // Compressed or stream-backed files have no mapped records
+    LASReader laz_reader(laz_file.path());
+    LASPP_ASSERT(!laz_reader.mapped_points<LASPointFormat3>().has_value());
+    LASPP_ASSERT(!laz_reader.mapped_point_view<GPSTime>().has_value());
+    std::ifstream ifs(las_file.path(), std::ios::binary);
+    LASReader stream_reader(ifs);
+    LASPP_ASSERT(!stream_reader.mapped_points<LASPointFormat3>().has_value());
+
+    // Reading the exact record type copies the records unchanged on either path
+    std::vector<LASPointFormat3> copied(points.size());
+    stream_reader.read_chunks(std::span<LASPointFormat3>(copied), {0, 1});
+    LASPP_ASSERT(copied == points);
+    std::vector<LASPointFormat3> mapped_copy(points.size());
+    reader.read_chunks(std::span<LASPointFormat3>(mapped_copy), {0, 1});
+    LASPP_ASSERT(mapped_copy == points);
+  }
+
   // Test LASPP_DISABLE_MMAP environment variable
   {
     TempFile temp_file("test_disable_mmap");
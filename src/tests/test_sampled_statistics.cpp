@@ -0,0 +1,229 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "sampled_statistics.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/memory_budget.hpp"
+
+using namespace laspp;
+
+namespace {
+
+struct ExactStatistics {
+  std::vector<double> class_fractions = std::vector<double>(256, 0.0);
+  std::vector<double> intensity_fractions;
+  std::vector<int32_t> sorted_z;
+
+  double z_percentile(double p, const Transform& transform) const {
+    const double target = std::ceil(p * static_cast<double>(sorted_z.size()));
+    const size_t k = target < 1.0 ? 0 : static_cast<size_t>(target) - 1;
+    return int32_to_double(sorted_z[k], transform.scale_factors().z(), transform.offsets().z());
+  }
+};
+
+template <typename T>
+ExactStatistics exact_statistics(const std::vector<T>& points, uint32_t bin_width) {
+  ExactStatistics exact;
+  exact.intensity_fractions.assign(65535 / bin_width + 1, 0.0);
+  const double n = static_cast<double>(points.size());
+  for (const T& point : points) {
+    exact.class_fractions[static_cast<uint8_t>(point.classification)] += 1.0 / n;
+    exact.intensity_fractions[point.intensity / bin_width] += 1.0 / n;
+    exact.sorted_z.push_back(point.z);
+  }
+  std::sort(exact.sorted_z.begin(), exact.sorted_z.end());
+  return exact;
+}
+
+bool covers(const Estimate& estimate, double value) {
+  return estimate.lower <= value + 1e-12 && value - 1e-12 <= estimate.upper;
+}
+
+void check_exact(const SampledStatistics& statistics, const ExactStatistics& exact,
+                 const Transform& transform, uint32_t bin_width) {
+  LASPP_ASSERT(statistics.is_exact());
+  const std::vector<Estimate> classes = statistics.class_distribution();
+  for (size_t c = 0; c < 256; c++) {
+    LASPP_ASSERT(std::abs(classes[c].value - exact.class_fractions[c]) < 1e-9);
+    LASPP_ASSERT_EQ(classes[c].lower, classes[c].upper);
+  }
+  const std::vector<Estimate> histogram = statistics.intensity_histogram(bin_width);
+  LASPP_ASSERT_EQ(histogram.size(), exact.intensity_fractions.size());
+  for (size_t b = 0; b < histogram.size(); b++) {
+    LASPP_ASSERT(std::abs(histogram[b].value - exact.intensity_fractions[b]) < 1e-9);
+  }
+  for (double p : {0.0, 0.1, 0.5, 0.99, 1.0}) {
+    const Estimate z = statistics.z_percentile(p);
+    LASPP_ASSERT_EQ(z.value, exact.z_percentile(p, transform));
+    LASPP_ASSERT_EQ(z.lower, z.value);
+    LASPP_ASSERT_EQ(z.upper, z.value);
+  }
+}
+
+// Ground (2) and vegetation (5) dominate, buildings (6) are clustered in a few stretches of the
+// file, and Z rises along it, so that chunks differ from one another.
+std::vector<LASPointFormat6> make_points(std::mt19937_64& gen, size_t n) {
+  std::uniform_int_distribution<int32_t> coordinate(0, 100000);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::normal_distribution<double> noise(0.0, 500.0);
+  std::vector<LASPointFormat6> points(n);
+  for (size_t i = 0; i < n; i++) {
+    LASPointFormat6& point = points[i];
+    point = LASPointFormat6::RandomData(gen);
+    point.x = coordinate(gen);
+    point.y = coordinate(gen);
+    point.z = static_cast<int32_t>(static_cast<double>(i) / 10.0 + noise(gen));
+    const bool building_stretch = (i / 2000) % 5 == 1;
+    const double u = uniform(gen);
+    point.classification = building_stretch && u < 0.5 ? LASClassification::Building
+                           : u < 0.75                 ? LASClassification::Ground
+                                                      : LASClassification::MediumVegetation;
+    point.intensity = static_cast<uint16_t>(uniform(gen) * uniform(gen) * 65535.0);
+  }
+  return points;
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  constexpr uint32_t BIN_WIDTH = 4096;
+  std::mt19937_64 gen(90);
+  const std::vector<LASPointFormat6> points = make_points(gen, 40000);
+  const ExactStatistics exact = exact_statistics(points, BIN_WIDTH);
+
+  std::stringstream laz_stream;
+  {
+    LASWriter writer(laz_stream, 6 | 128);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {0.0, 0.0, 0.0});
+    writer.write_points(std::span<const LASPointFormat6>(points), 500);
+  }
+  laz_stream.seekg(0);
+  LASReader reader(laz_stream);
+  const Transform& transform = reader.header().transform();
+
+  // A quarter of the chunks gives estimates whose bounds cover the exact values, and refining
+  // to every chunk makes them exact
+  {
+    SampledStatistics statistics(reader, 1);
+    LASPP_ASSERT_EQ(statistics.num_units(), 80u);
+    LASPP_ASSERT_EQ(statistics.sample(20), 20u);
+    LASPP_ASSERT_EQ(statistics.num_points_decoded(), 10000u);
+    LASPP_ASSERT(!statistics.is_exact());
+
+    const std::vector<Estimate> classes = statistics.class_distribution();
+    for (uint8_t c : {uint8_t{2}, uint8_t{4}, uint8_t{6}}) {
+      LASPP_ASSERT(covers(classes[c], exact.class_fractions[c]), "Class ", int{c}, ": ",
+                   classes[c].lower, " - ", classes[c].upper, " vs ", exact.class_fractions[c]);
+      LASPP_ASSERT_LT(classes[c].upper - classes[c].lower, 0.2);
+    }
+    LASPP_ASSERT_EQ(statistics.class_fraction(6).value, classes[6].value);
+    const std::vector<Estimate> histogram = statistics.intensity_histogram(BIN_WIDTH);
+    for (size_t b = 0; b < 4; b++) {
+      LASPP_ASSERT(covers(histogram[b], exact.intensity_fractions[b]));
+    }
+    for (double p : {0.1, 0.5, 0.9}) {
+      const Estimate z = statistics.z_percentile(p);
+      LASPP_ASSERT(covers(z, exact.z_percentile(p, transform)), "Z percentile ", p, ": ",
+                   z.lower, " - ", z.upper, " vs ", exact.z_percentile(p, transform));
+      LASPP_ASSERT_LT(z.lower, z.upper);
+    }
+
+    const double first_width = classes[6].upper - classes[6].lower;
+    statistics.sample(40);
+    const Estimate refined = statistics.class_fraction(6);
+    LASPP_ASSERT_LT(refined.upper - refined.lower, first_width);
+
+    LASPP_ASSERT_EQ(statistics.sample(1000), 20u);
+    LASPP_ASSERT_EQ(statistics.sample(1), 0u);
+    check_exact(statistics, exact, transform, BIN_WIDTH);
+  }
+
+  // The first points of every chunk
+  {
+    SampledStatistics statistics(reader, 2);
+    statistics.sample(statistics.num_units(), 50);
+    LASPP_ASSERT_EQ(statistics.num_points_decoded(), 4000u);
+    LASPP_ASSERT(!statistics.is_exact());
+    const std::vector<Estimate> classes = statistics.class_distribution();
+    for (uint8_t c : {uint8_t{2}, uint8_t{4}, uint8_t{6}}) {
+      LASPP_ASSERT(covers(classes[c], exact.class_fractions[c]));
+    }
+    const Estimate median = statistics.z_percentile(0.5);
+    LASPP_ASSERT_LT(std::abs(median.value - exact.z_percentile(0.5, transform)), 2.0);
+
+    // The retained points are counted against the memory budget
+    LASPP_ASSERT_GE(utilities::get_memory_budget().reserved(),
+                    statistics.num_sample_points() * (sizeof(int32_t) + sizeof(uint32_t)));
+
+    // Sampling on returns to the chunks for the rest of their points until the estimates are
+    // exact: 500 points per chunk are 50 and then three rounds of 150
+    size_t n_rounds = 0;
+    while (statistics.sample(statistics.num_units(), 150) > 0) n_rounds++;
+    LASPP_ASSERT_EQ(n_rounds, 3u);
+    LASPP_ASSERT_EQ(statistics.num_units_sampled(), statistics.num_units());
+    check_exact(statistics, exact, transform, BIN_WIDTH);
+
+    // Only decompress_chunk_prefix decodes part of a chunk
+    const std::vector<std::byte> compressed = reader.read_compressed_chunk(3);
+    std::vector<LASPointFormat6> prefix(50);
+    LASPP_ASSERT_THROWS(reader.decompress_chunk(3, compressed, std::span<LASPointFormat6>(prefix)),
+                        std::runtime_error);
+    reader.decompress_chunk_prefix(3, compressed, std::span<LASPointFormat6>(prefix));
+    LASPP_ASSERT(std::equal(prefix.begin(), prefix.end(), points.begin() + 1500));
+  }
+
+  // Points inside a region, from an indexed file
+  {
+    std::stringstream indexed_stream;
+    {
+      LASWriter writer(indexed_stream, 6 | 128);
+      writer.copy_from_reader(reader, true);
+    }
+    indexed_stream.seekg(0);
+    LASReader indexed_reader(indexed_stream);
+    const Bound2D box(100.0, 200.0, 600.0, 450.0);
+    std::vector<LASPointFormat6> inside;
+    for (const LASPointFormat6& point : points) {
+      if (box.contains(point.x * 0.01, point.y * 0.01)) inside.push_back(point);
+    }
+    SampledStatistics statistics(indexed_reader, 3, box);
+    statistics.sample(statistics.num_units());
+    LASPP_ASSERT_EQ(statistics.num_sample_points(), inside.size());
+    check_exact(statistics, exact_statistics(inside, BIN_WIDTH), transform, BIN_WIDTH);
+  }
+
+  // Uncompressed files are sampled in blocks
+  {
+    std::vector<LASPointFormat6> many_points = make_points(gen, 120000);
+    std::stringstream las_stream;
+    {
+      LASWriter writer(las_stream, 6);
+      writer.header().transform() = Transform({0.01, 0.01, 0.01}, {0.0, 0.0, 0.0});
+      writer.write_points(std::span<const LASPointFormat6>(many_points));
+    }
+    las_stream.seekg(0);
+    LASReader las_reader(las_stream);
+    SampledStatistics statistics(las_reader, 4);
+    LASPP_ASSERT_EQ(statistics.num_units(), 3u);
+    statistics.sample(1);
+    LASPP_ASSERT(!statistics.is_exact());
+    statistics.sample(2, 100000);
+    check_exact(statistics, exact_statistics(many_points, BIN_WIDTH), transform, BIN_WIDTH);
+  }
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "spatial_index.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+
+namespace {
+
+std::vector<LASPointFormat1> read_all(LASReader& reader) {
+  std::vector<LASPointFormat1> points(reader.num_points());
+  reader.read_chunks(std::span<LASPointFormat1>(points), {0, reader.num_chunks()});
+  return points;
+}
+
+template <typename Region>
+uint64_t brute_force_count(const LASReader& reader, const std::vector<LASPointFormat1>& points,
+                           const Region& region) {
+  const Transform& transform = reader.header().transform();
+  uint64_t count = 0;
+  for (const LASPointFormat1& point : points) {
+    const double x =
+        int32_to_double(point.x, transform.scale_factors().x(), transform.offsets().x());
+    const double y =
+        int32_to_double(point.y, transform.scale_factors().y(), transform.offsets().y());
+    count += region.contains(x, y) ? 1u : 0u;
+  }
+  return count;
+}
+
+void check_queries(LASReader& reader) {
+  const std::vector<LASPointFormat1> points = read_all(reader);
+
+  const std::vector<Bound2D> boxes = {Bound2D(0.0, 0.0, 1000.0, 1000.0),
+                                      Bound2D(100.0, 200.0, 600.0, 450.0),
+                                      Bound2D(333.3, 10.0, 334.0, 990.0),
+                                      Bound2D(2000.0, 2000.0, 3000.0, 3000.0)};
+  for (const Bound2D& box : boxes) {
+    LASPP_ASSERT_EQ(reader.count_points(box), brute_force_count(reader, points, box));
+  }
+  LASPP_ASSERT_EQ(reader.count_points(boxes[0]), points.size());
+
+  const Polygon2D polygon({{50.0, 50.0}, {900.0, 120.0}, {500.0, 500.0}, {800.0, 950.0},
+                           {80.0, 700.0}});
+  LASPP_ASSERT_EQ(reader.count_points(polygon), brute_force_count(reader, points, polygon));
+
+  const DensityGrid grid = reader.density_grid(Bound2D(0.0, 0.0, 1000.0, 1000.0), 4, 5);
+  DensityGrid expected(grid.bounds(), 4, 5);
+  const Transform& transform = reader.header().transform();
+  for (const LASPointFormat1& point : points) {
+    const double x =
+        int32_to_double(point.x, transform.scale_factors().x(), transform.offsets().x());
+    const double y =
+        int32_to_double(point.y, transform.scale_factors().y(), transform.offsets().y());
+    if (auto cell = expected.cell_at(x, y)) expected.add(*cell, 1);
+  }
+  LASPP_ASSERT_EQ(grid.counts(), expected.counts());
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  // Polygon containment and cell coverage
+  {
+    const Polygon2D triangle({{0.0, 0.0}, {10.0, 0.0}, {0.0, 10.0}});
+    LASPP_ASSERT(triangle.contains(2.0, 2.0));
+    LASPP_ASSERT(!triangle.contains(6.0, 6.0));
+    LASPP_ASSERT(!triangle.contains(-1.0, 1.0));
+    LASPP_ASSERT(triangle.coverage(Bound2D(1.0, 1.0, 2.0, 2.0)) == CellCoverage::Inside);
+    LASPP_ASSERT(triangle.coverage(Bound2D(4.0, 4.0, 6.0, 6.0)) == CellCoverage::Partial);
+    LASPP_ASSERT(triangle.coverage(Bound2D(7.0, 7.0, 9.0, 9.0)) == CellCoverage::Outside);
+    LASPP_ASSERT(triangle.coverage(Bound2D(20.0, 0.0, 30.0, 5.0)) == CellCoverage::Outside);
+    // Polygon entirely inside the cell
+    LASPP_ASSERT(triangle.coverage(Bound2D(-5.0, -5.0, 20.0, 20.0)) == CellCoverage::Partial);
+
+    const Bound2D box(0.0, 0.0, 10.0, 10.0);
+    LASPP_ASSERT(region_coverage(box, Bound2D(1.0, 1.0, 10.0, 2.0)) == CellCoverage::Inside);
+    LASPP_ASSERT(region_coverage(box, Bound2D(9.0, 9.0, 11.0, 11.0)) == CellCoverage::Partial);
+    LASPP_ASSERT(region_coverage(box, Bound2D(10.5, 0.0, 11.0, 1.0)) == CellCoverage::Outside);
+  }
+
+  // Density grid cell assignment
+  {
+    DensityGrid grid(Bound2D(0.0, 0.0, 10.0, 20.0), 2, 4);
+    LASPP_ASSERT_EQ(grid.cell_at(0.0, 0.0).value(), 0u);
+    LASPP_ASSERT_EQ(grid.cell_at(5.0, 0.0).value(), 1u);
+    LASPP_ASSERT_EQ(grid.cell_at(10.0, 20.0).value(), 7u);
+    LASPP_ASSERT(!grid.cell_at(10.5, 1.0).has_value());
+    grid.add(3, 50);
+    LASPP_ASSERT_EQ(grid.count(1, 1), 50u);
+    LASPP_ASSERT_EQ(grid.density(1, 1), 2.0);
+  }
+
+  // Counts and grids match a brute-force scan, with and without a spatial index
+  std::mt19937_64 gen(86);
+  std::uniform_int_distribution<int32_t> coordinate(0, 100000);
+  std::stringstream input_stream;
+  {
+    LASWriter writer(input_stream, 1 | 128);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {0.0, 0.0, 0.0});
+    std::vector<LASPointFormat1> points(20000);
+    for (LASPointFormat1& point : points) {
+      point = LASPointFormat1::RandomData(gen);
+      point.x = coordinate(gen);
+      point.y = coordinate(gen);
+    }
+    writer.write_points(std::span<const LASPointFormat1>(points), 1000);
+  }
+  input_stream.seekg(0);
+  LASReader input_reader(input_stream);
+  LASPP_ASSERT(!input_reader.has_lastools_spatial_index());
+  check_queries(input_reader);
+
+  for (uint8_t point_format : {uint8_t{1}, uint8_t{1 | 128}}) {
+    std::stringstream indexed_stream;
+    {
+      input_stream.seekg(0);
+      LASReader reader(input_stream);
+      LASWriter writer(indexed_stream, point_format);
+      writer.copy_from_reader(reader, true);
+    }
+    indexed_stream.seekg(0);
+    LASReader reader(indexed_stream);
+    LASPP_ASSERT(reader.has_lastools_spatial_index());
+    check_queries(reader);
+
+    // Most of a large window is answered from the index alone
+    const QuadtreeSpatialIndex& index = reader.lastools_spatial_index();
+    LASPP_ASSERT_EQ(index.num_indexed_points(), reader.num_points());
+    const Bound2D window(100.0, 100.0, 900.0, 900.0);
+    const IndexCountPlan plan = index.plan_count(window);
+    uint64_t n_boundary_points = 0;
+    for (const PointInterval& interval : plan.boundary_intervals) {
+      n_boundary_points += interval.end - interval.start + 1;
+    }
+    LASPP_ASSERT_GT(plan.n_points_inside, 4 * n_boundary_points);
+
+    if (point_format & 128) {
+      reader.enable_point_checkpoints(100);
+      check_queries(reader);
+    }
+  }
+
+  return 0;
+}
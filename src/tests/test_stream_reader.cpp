@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_stream_reader.hpp"
+#include "las_writer.hpp"
+#include "test_files.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+using namespace laspp::tests;
+
+namespace {
+
+// Hands out the data a few bytes at a time and cannot seek, like a pipe.
+class PipeBuffer : public std::streambuf {
+  std::string m_data;
+  size_t m_position = 0;
+  size_t m_step;
+
+ public:
+  PipeBuffer(std::string data, size_t step) : m_data(std::move(data)), m_step(step) {}
+
+ protected:
+  int_type underflow() override {
+    if (m_position >= m_data.size()) {
+      return traits_type::eof();
+    }
+    const size_t n = std::min(m_step, m_data.size() - m_position);
+    char* begin = m_data.data() + m_position;
+    setg(begin, begin, begin + n);
+    m_position += n;
+    return traits_type::to_int_type(*begin);
+  }
+};
+
+// A user point type filled through copy_from
+struct PositionAndTime {
+  int32_t x;
+  int32_t y;
+  int32_t z;
+  double gps_time;
+
+  bool operator==(const PositionAndTime&) const = default;
+
+  friend void copy_from(PositionAndTime& dest, const LASPointFormat0& src) {
+    dest.x = src.x;
+    dest.y = src.y;
+    dest.z = src.z;
+  }
+  friend void copy_from(PositionAndTime& dest, const GPSTime& src) {
+    dest.gps_time = src.gps_time.f64;
+  }
+};
+
+template <typename T>
+void check_stream_read(const std::string& file, size_t step) {
+  std::istringstream file_stream(file);
+  LASReader reader(file_stream);
+  const std::vector<T> expected = read_all<T>(reader);
+
+  PipeBuffer pipe(file, step);
+  std::istream pipe_stream(&pipe);
+  LASStreamReader stream_reader(pipe_stream);
+  LASPP_ASSERT_EQ(stream_reader.num_points(), reader.num_points());
+  LASPP_ASSERT_EQ(stream_reader.header().point_format(), reader.header().point_format());
+  LASPP_ASSERT_EQ(stream_reader.vlrs().size(), reader.vlr_headers().size());
+  for (size_t i = 0; i < stream_reader.vlrs().size(); i++) {
+    LASPP_ASSERT(stream_reader.vlrs()[i].data == reader.read_vlr_data(reader.vlr_headers()[i]));
+  }
+  LASPP_ASSERT_EQ(stream_reader.wkt(), reader.wkt());
+
+  std::vector<T> points;
+  stream_reader.read_points<T>(
+      [&](std::span<T> batch) { points.insert(points.end(), batch.begin(), batch.end()); });
+  LASPP_ASSERT(points == expected);
+  LASPP_ASSERT_EQ(stream_reader.points_read(), reader.num_points());
+
+  LASPP_ASSERT_EQ(stream_reader.evlrs().size(), reader.evlr_headers().size());
+  for (size_t i = 0; i < stream_reader.evlrs().size(); i++) {
+    LASPP_ASSERT(stream_reader.evlrs()[i].data ==
+                 reader.read_evlr_data(reader.evlr_headers()[i]));
+  }
+}
+
+// With `indexed`, the file is rewritten with a spatial index
+template <typename T>
+std::string write_input(uint8_t point_format, const std::vector<T>& points, bool indexed) {
+  std::stringstream stream;
+  {
+    LASWriter writer(stream, point_format);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {0.0, 0.0, 0.0});
+    writer.write_wkt("GEOGCS[\"WGS 84\"]");
+    const std::span<const T> all(points);
+    if (point_format & 128) {
+      // Constant chunks, then a chunk of a different size
+      writer.write_points(all.subspan(0, 7000), 1000);
+      writer.write_points(all.subspan(7000));
+    } else {
+      writer.write_points(all);
+    }
+  }
+  if (!indexed) {
+    return stream.str();
+  }
+  stream.seekg(0);
+  LASReader reader(stream);
+  std::stringstream indexed_stream;
+  {
+    LASWriter writer(indexed_stream, point_format);
+    writer.copy_from_reader(reader, true);
+  }
+  return indexed_stream.str();
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  std::mt19937_64 gen(89);
+
+  // Pointwise LAZ: chunks delimited by decoding
+  {
+    const std::vector<LASPointFormat1> points = random_points<LASPointFormat1>(gen, 7500);
+    const std::string file = write_input<LASPointFormat1>(1 | 128, points, false);
+    check_stream_read<LASPointFormat1>(file, 1000);
+    check_stream_read<LASPointFormat1>(file, 65536);
+    check_stream_read<PositionAndTime>(file, 4096);
+    // Chunks of one point
+    std::stringstream small_stream;
+    {
+      LASWriter writer(small_stream, 1 | 128);
+      writer.write_points(std::span<const LASPointFormat1>(points).subspan(0, 5), 1);
+    }
+    check_stream_read<LASPointFormat1>(small_stream.str(), 7);
+  }
+
+  // Layered LAZ: chunks delimited by their headers, with a spatial index EVLR after the points
+  {
+    const std::vector<LASPointFormat7> points = random_points<LASPointFormat7>(gen, 7500);
+    check_stream_read<LASPointFormat7>(write_input<LASPointFormat7>(7 | 128, points, false), 999);
+    check_stream_read<LASPointFormat6>(write_input<LASPointFormat7>(7 | 128, points, true),
+                                       1 << 16);
+  }
+
+  // Uncompressed
+  {
+    const std::vector<LASPointFormat3> points = random_points<LASPointFormat3>(gen, 70000);
+    check_stream_read<LASPointFormat3>(write_input<LASPointFormat3>(3, points, false), 4096);
+    check_stream_read<PositionAndTime>(write_input<LASPointFormat3>(3, points, true), 100000);
+  }
+
+  // A truncated stream fails rather than returning made-up points
+  {
+    const std::vector<LASPointFormat1> points = random_points<LASPointFormat1>(gen, 7500);
+    std::string file = write_input<LASPointFormat1>(1 | 128, points, false);
+    std::istringstream file_stream(file);
+    LASReader reader(file_stream);
+    file.resize(reader.header().offset_to_point_data() + 2000);
+    PipeBuffer pipe(file, 512);
+    std::istream pipe_stream(&pipe);
+    LASStreamReader stream_reader(pipe_stream);
+    LASPP_ASSERT_THROWS(
+        stream_reader.read_points<LASPointFormat1>([](std::span<LASPointFormat1>) {}),
+        std::exception);
+  }
+
+  return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "spatial_index.hpp"
+#include "test_files.hpp"
+#include "tiled_processing.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+using namespace laspp::tests;
+
+namespace {
+
+constexpr double RADIUS = 20.0;
+constexpr uint8_t MIN_NEIGHBOURS = 3;
+
+uint8_t count_neighbours(const LASPointFormat1& point, std::span<const LASPointFormat1> others) {
+  size_t n = 0;
+  for (const LASPointFormat1& other : others) {
+    const double dx = (other.x - point.x) * 0.01;
+    const double dy = (other.y - point.y) * 0.01;
+    if (&other != &point && dx * dx + dy * dy <= RADIUS * RADIUS) n++;
+  }
+  return static_cast<uint8_t>(std::min<size_t>(n, 255));
+}
+
+void sort_by_time(std::vector<LASPointFormat1>& points) {
+  std::sort(points.begin(), points.end(), [](const LASPointFormat1& a, const LASPointFormat1& b) {
+    return a.gps_time.f64 < b.gps_time.f64;
+  });
+}
+
+// Noise filter: keeps points with at least MIN_NEIGHBOURS neighbours within RADIUS and stores
+// the neighbour count in user_data.
+std::vector<LASPointFormat1> filter_tiled(TiledProcessor& processor, uint8_t output_format) {
+  std::stringstream output_stream;
+  std::atomic<size_t> n_core{0};
+  {
+    LASWriter writer(output_stream, output_format);
+    processor.run<LASPointFormat1>(writer, [&](Tile<LASPointFormat1>& tile) {
+      n_core += tile.n_core;
+      std::vector<uint8_t> counts(tile.n_core);
+      for (size_t i = 0; i < tile.n_core; i++) {
+        counts[i] = count_neighbours(tile.points[i], tile.points);
+      }
+      for (size_t i = 0; i < tile.n_core; i++) {
+        tile.points[i].user_data = counts[i];
+        tile.keep[i] = counts[i] >= MIN_NEIGHBOURS;
+      }
+    });
+  }
+  output_stream.seekg(0);
+  LASReader output_reader(output_stream);
+  std::vector<LASPointFormat1> output = read_all(output_reader);
+  sort_by_time(output);
+  return output;
+}
+
+// Writes `points` in spatial order, in chunks of 500, with a spatial index
+std::string write_indexed(const LASHeader& header, std::vector<LASPointFormat1> points,
+                          uint8_t point_format) {
+  {
+    const QuadtreeSpatialIndex provisional_index(header, points);
+    std::vector<std::pair<int32_t, size_t>> cells(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+      cells[i] = {provisional_index.get_cell_index(points[i].x * 0.01, points[i].y * 0.01), i};
+    }
+    std::sort(cells.begin(), cells.end());
+    std::vector<LASPointFormat1> sorted(points.size());
+    for (size_t i = 0; i < cells.size(); i++) sorted[i] = points[cells[i].second];
+    points = std::move(sorted);
+  }
+  std::stringstream stream;
+  {
+    LASWriter writer(stream, point_format);
+    writer.header().transform() = header.transform();
+    writer.write_points(std::span<const LASPointFormat1>(points), 500);
+    writer.write_lastools_spatial_index(QuadtreeSpatialIndex(header, points));
+  }
+  return stream.str();
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  std::mt19937_64 gen(93);
+  std::uniform_int_distribution<int32_t> coordinate(0, 100000);
+  std::vector<LASPointFormat1> points(6000);
+  for (LASPointFormat1& point : points) {
+    point = LASPointFormat1::RandomData(gen);
+    point.x = coordinate(gen);
+    point.y = coordinate(gen);
+  }
+  std::stringstream input_stream;
+  {
+    LASWriter writer(input_stream, 1 | 128);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {0.0, 0.0, 0.0});
+    writer.write_points(std::span<const LASPointFormat1>(points), 500);
+  }
+  input_stream.seekg(0);
+  LASReader reader(input_stream);
+
+  std::vector<LASPointFormat1> expected;
+  for (const LASPointFormat1& point : points) {
+    LASPointFormat1 filtered = point;
+    filtered.user_data = count_neighbours(point, points);
+    if (filtered.user_data >= MIN_NEIGHBOURS) expected.push_back(filtered);
+  }
+  sort_by_time(expected);
+  LASPP_ASSERT_GT(expected.size(), points.size() / 2);
+  LASPP_ASSERT_LT(expected.size(), points.size());
+
+  // Indexed LAZ: each chunk is decoded once with a large enough cache
+  std::istringstream indexed_stream(write_indexed(reader.header(), points, 1 | 128));
+  LASReader indexed_reader(indexed_stream);
+  LASPP_ASSERT(indexed_reader.has_lastools_spatial_index());
+  LASPP_ASSERT_EQ(indexed_reader.num_chunks(), 12u);
+  {
+    TiledProcessor processor(indexed_reader, 250.0, RADIUS);
+    LASPP_ASSERT_EQ(processor.num_tiles(), 16u);
+    LASPP_ASSERT(filter_tiled(processor, 1 | 128) == expected);
+    LASPP_ASSERT_LE(processor.num_chunk_decodes(), indexed_reader.num_chunks());
+  }
+
+  // A cache too small to hold a batch still gives the same result
+  {
+    TiledProcessor processor(indexed_reader, 250.0, RADIUS, 1);
+    LASPP_ASSERT(filter_tiled(processor, 1) == expected);
+    LASPP_ASSERT_GE(processor.num_chunk_decodes(), indexed_reader.num_chunks());
+  }
+
+  // An index over points in file order spreads every tile over most chunks; batches then load
+  // their chunks in groups that fit the cache instead of decoding the whole file at once
+  {
+    std::stringstream unsorted_stream;
+    {
+      LASWriter writer(unsorted_stream, 1 | 128);
+      writer.header().transform() = reader.header().transform();
+      writer.write_points(std::span<const LASPointFormat1>(points), 500);
+      writer.write_lastools_spatial_index(QuadtreeSpatialIndex(reader.header(), points));
+    }
+    unsorted_stream.seekg(0);
+    LASReader unsorted_reader(unsorted_stream);
+    LASPP_ASSERT(unsorted_reader.spatial_index_is_complete());
+    const size_t cache_bytes = 1200 * sizeof(LASPointFormat1);
+    TiledProcessor processor(unsorted_reader, 250.0, RADIUS, cache_bytes);
+    LASPP_ASSERT(filter_tiled(processor, 1 | 128) == expected);
+    LASPP_ASSERT_LE(processor.peak_cache_bytes(), cache_bytes);
+    LASPP_ASSERT_GT(processor.num_chunk_decodes(), unsorted_reader.num_chunks());
+  }
+
+  // Uncompressed input, and input without a spatial index
+  {
+    std::istringstream las_stream(write_indexed(reader.header(), points, 1));
+    LASReader las_reader(las_stream);
+    TiledProcessor las_processor(las_reader, 300.0, RADIUS);
+    LASPP_ASSERT(filter_tiled(las_processor, 1 | 128) == expected);
+
+    TiledProcessor unindexed_processor(reader, 400.0, RADIUS);
+    LASPP_ASSERT(filter_tiled(unindexed_processor, 1 | 128) == expected);
+    LASPP_ASSERT_EQ(unindexed_processor.num_chunk_decodes(), 0u);
+  }
+
+  // Without a spatial index the file is scanned once, in blocks bounded by the cache size, whole
+  // LAZ chunks at a time (two of 500 points here), rather than loaded whole
+  {
+    const size_t cache_bytes = 1200 * sizeof(LASPointFormat1);
+    TiledProcessor laz_processor(reader, 250.0, RADIUS, cache_bytes);
+    LASPP_ASSERT(filter_tiled(laz_processor, 1) == expected);
+    LASPP_ASSERT_EQ(laz_processor.peak_cache_bytes(), 1000 * sizeof(LASPointFormat1));
+
+    std::stringstream las_stream;
+    {
+      LASWriter writer(las_stream, 1);
+      writer.header().transform() = reader.header().transform();
+      writer.write_points(std::span<const LASPointFormat1>(points));
+    }
+    las_stream.seekg(0);
+    LASReader las_reader(las_stream);
+    LASPP_ASSERT(!las_reader.has_lastools_spatial_index());
+    TiledProcessor las_processor(las_reader, 250.0, RADIUS, cache_bytes);
+    LASPP_ASSERT(filter_tiled(las_processor, 1) == expected);
+    LASPP_ASSERT_EQ(las_processor.peak_cache_bytes(), cache_bytes);
+  }
+
+  return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "spatial_index.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+
+namespace {
+
+std::vector<LASPointFormat7> read_all(LASReader& reader) {
+  std::vector<LASPointFormat7> points(reader.num_points());
+  reader.read_chunks(std::span<LASPointFormat7>(points), {0, reader.num_chunks()});
+  return points;
+}
+
+template <typename Region>
+std::vector<LASPointFormat7> brute_force_clip(const LASHeader& header,
+                                              const std::vector<LASPointFormat7>& points,
+                                              const Region& region) {
+  const Transform& transform = header.transform();
+  std::vector<LASPointFormat7> inside;
+  for (const LASPointFormat7& point : points) {
+    const double x =
+        int32_to_double(point.x, transform.scale_factors().x(), transform.offsets().x());
+    const double y =
+        int32_to_double(point.y, transform.scale_factors().y(), transform.offsets().y());
+    if (region.contains(x, y)) inside.push_back(point);
+  }
+  return inside;
+}
+
+template <typename Region>
+void check_clip(LASReader& reader, const Region& region, uint8_t output_format,
+                std::span<const ChunkSummary> summaries = {}) {
+  const std::vector<LASPointFormat7> expected =
+      brute_force_clip(reader.header(), read_all(reader), region);
+
+  std::stringstream clipped_stream;
+  {
+    LASWriter writer(clipped_stream, output_format);
+    writer.clip_from_reader(reader, region, summaries);
+  }
+  clipped_stream.seekg(0);
+  LASReader clipped_reader(clipped_stream);
+  LASPP_ASSERT(!clipped_reader.has_lastools_spatial_index());
+  LASPP_ASSERT_EQ(clipped_reader.num_points(), expected.size());
+  if (expected.empty()) {
+    return;
+  }
+  LASPP_ASSERT(read_all(clipped_reader) == expected);
+
+  std::stringstream expected_stream;
+  {
+    LASWriter writer(expected_stream, output_format);
+    writer.header().transform() = reader.header().transform();
+    writer.write_points(std::span<const LASPointFormat7>(expected));
+  }
+  expected_stream.seekg(0);
+  LASReader expected_reader(expected_stream);
+  LASPP_ASSERT_EQ(clipped_reader.header().num_points_by_return(),
+                  expected_reader.header().num_points_by_return());
+  const Bound3D& bounds = clipped_reader.header().bounds();
+  const Bound3D& expected_bounds = expected_reader.header().bounds();
+  LASPP_ASSERT_EQ(bounds.min_x(), expected_bounds.min_x());
+  LASPP_ASSERT_EQ(bounds.max_y(), expected_bounds.max_y());
+  LASPP_ASSERT_EQ(bounds.max_z(), expected_bounds.max_z());
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  // Random points over [0, 1000]^2, written in spatial order with small chunks and indexed,
+  // so that most chunks lie within a few index cells.
+  std::mt19937_64 gen(87);
+  std::uniform_int_distribution<int32_t> coordinate(0, 100000);
+  std::vector<LASPointFormat7> points(20000);
+  for (LASPointFormat7& point : points) {
+    point = LASPointFormat7::RandomData(gen);
+    point.x = coordinate(gen);
+    point.y = coordinate(gen);
+  }
+  std::stringstream unsorted_stream;
+  {
+    LASWriter writer(unsorted_stream, 7 | 128);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {0.0, 0.0, 0.0});
+    writer.write_points(std::span<const LASPointFormat7>(points));
+  }
+  unsorted_stream.seekg(0);
+  LASReader unsorted_reader(unsorted_stream);
+  const LASHeader& unsorted_header = unsorted_reader.header();
+  {
+    const QuadtreeSpatialIndex provisional_index(unsorted_header, points);
+    std::vector<std::pair<int32_t, size_t>> cells(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+      cells[i] = {provisional_index.get_cell_index(points[i].x * 0.01, points[i].y * 0.01), i};
+    }
+    std::sort(cells.begin(), cells.end());
+    std::vector<LASPointFormat7> sorted(points.size());
+    for (size_t i = 0; i < cells.size(); i++) sorted[i] = points[cells[i].second];
+    points = std::move(sorted);
+  }
+
+  std::stringstream input_stream;
+  {
+    LASWriter writer(input_stream, 7 | 128);
+    writer.header().transform() = unsorted_header.transform();
+    writer.write_points(std::span<const LASPointFormat7>(points), 250);
+    writer.write_lastools_spatial_index(QuadtreeSpatialIndex(unsorted_header, points));
+  }
+  input_stream.seekg(0);
+  LASReader reader(input_stream);
+  LASPP_ASSERT(reader.has_lastools_spatial_index());
+
+  const Bound2D box(150.0, 220.0, 700.0, 810.0);
+  const Polygon2D polygon({{50.0, 50.0}, {900.0, 120.0}, {500.0, 500.0}, {800.0, 950.0},
+                           {80.0, 700.0}});
+
+  // Chunks are classified from the index
+  {
+    const std::vector<CellCoverage> coverage = reader.chunk_coverage(box);
+    const auto n_inside = std::count(coverage.begin(), coverage.end(), CellCoverage::Inside);
+    const auto n_outside = std::count(coverage.begin(), coverage.end(), CellCoverage::Outside);
+    LASPP_ASSERT_GT(n_inside, 0);
+    LASPP_ASSERT_GT(n_outside, 0);
+    LASPP_ASSERT_LT(n_inside + n_outside, static_cast<std::ptrdiff_t>(coverage.size()));
+  }
+
+  check_clip(reader, box, 7 | 128);
+  check_clip(reader, polygon, 7 | 128);
+  check_clip(reader, box, 7);
+  check_clip(reader, Bound2D(5000.0, 5000.0, 6000.0, 6000.0), 7 | 128);
+
+  const std::vector<ChunkSummary> summaries = reader.chunk_summaries();
+  LASPP_ASSERT_EQ(summaries.size(), reader.num_chunks());
+  check_clip(reader, polygon, 7 | 128, summaries);
+
+  // Chunks inside the region are copied without re-encoding
+  {
+    std::stringstream clipped_stream;
+    {
+      LASWriter writer(clipped_stream, 7 | 128);
+      writer.clip_from_reader(reader, box, summaries);
+    }
+    clipped_stream.seekg(0);
+    LASReader clipped_reader(clipped_stream);
+    const std::vector<CellCoverage> coverage = reader.chunk_coverage(box);
+    size_t output_chunk = 0;
+    size_t n_copied = 0;
+    for (size_t i = 0; i < coverage.size(); i++) {
+      if (coverage[i] == CellCoverage::Inside) {
+        while (clipped_reader.read_compressed_chunk(output_chunk) !=
+               reader.read_compressed_chunk(i)) {
+          output_chunk++;
+        }
+        n_copied++;
+      }
+    }
+    LASPP_ASSERT_GT(n_copied, 0u);
+  }
+
+  // Without a spatial index, chunk summaries classify spatially ordered chunks by their bounds
+  {
+    std::stringstream unindexed_stream;
+    {
+      LASWriter writer(unindexed_stream, 7 | 128);
+      writer.header().transform() = unsorted_header.transform();
+      writer.write_points(std::span<const LASPointFormat7>(points), 250);
+    }
+    unindexed_stream.seekg(0);
+    LASReader unindexed_reader(unindexed_stream);
+    const std::vector<ChunkSummary> unindexed_summaries = unindexed_reader.chunk_summaries();
+    const std::vector<CellCoverage> coverage =
+        unindexed_reader.chunk_coverage(box, unindexed_summaries);
+    LASPP_ASSERT_GT(std::count(coverage.begin(), coverage.end(), CellCoverage::Inside), 0);
+    LASPP_ASSERT_GT(std::count(coverage.begin(), coverage.end(), CellCoverage::Outside), 0);
+    check_clip(unindexed_reader, box, 7 | 128, unindexed_summaries);
+    check_clip(unindexed_reader, polygon, 7, unindexed_summaries);
+  }
+
+  // Without a spatial index every chunk is filtered
+  {
+    check_clip(unsorted_reader, box, 7 | 128);
+    const std::vector<CellCoverage> coverage = unsorted_reader.chunk_coverage(box);
+    LASPP_ASSERT(std::all_of(coverage.begin(), coverage.end(),
+                             [](CellCoverage c) { return c == CellCoverage::Partial; }));
+  }
+
+  return 0;
+}
@@ -3,7 +3,11 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <cstdint>
+#include <random>
+#include <span>
 #include <sstream>
+#include <vector>
 
 #include "las_header.hpp"
 #include "las_point.hpp"
@@ -11,6 +15,7 @@
 #include "las_writer.hpp"
 #include "spatial_index.hpp"
 #include "utilities/assert.hpp"
+#include "utilities/thread_pool.hpp"
 #include "vlr.hpp"
 
 using namespace laspp;
@@ -370,6 +375,42 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     }
   }
 
+  // Test copy_from_reader keeps the chunking of a LAZ source, even uneven, and chunks an
+  // uncompressed source
+  {
+    std::mt19937_64 gen(82);
+    std::vector<LASPointFormat1> points(120000);
+    for (LASPointFormat1& point : points) {
+      point = LASPointFormat1::RandomData(gen);
+    }
+    const std::span<const LASPointFormat1> all(points);
+    for (uint8_t input_format : {uint8_t{1 | 128}, uint8_t{1}}) {
+      std::stringstream input_stream;
+      {
+        LASWriter writer(input_stream, input_format);
+        writer.write_points(all.subspan(0, 5500), 1000);
+        writer.write_points(all.subspan(5500), 7000);
+      }
+      input_stream.seekg(0);
+      LASReader reader(input_stream);
+
+      std::stringstream output_stream;
+      {
+        LASWriter writer(output_stream, 1 | 128);
+        writer.copy_from_reader(reader, false);
+      }
+      output_stream.seekg(0);
+      LASReader output_reader(output_stream);
+      const std::vector<size_t> expected = input_format & 128
+                                               ? reader.points_per_chunk()
+                                               : std::vector<size_t>{50000, 50000, 20000};
+      LASPP_ASSERT(output_reader.points_per_chunk() == expected);
+      std::vector<LASPointFormat1> output_points(points.size());
+      output_reader.read_chunks<LASPointFormat1>(output_points, {0, output_reader.num_chunks()});
+      LASPP_ASSERT(output_points == points);
+    }
+  }
+
   // Test copy_from_reader skips existing spatial index stored as a VLR.
   // LAS 1.2-era files can carry the LAStools index as a VLR (record_id 30)
   // rather than an EVLR.  When add_spatial_index=true the old VLR must be
@@ -444,5 +485,40 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     LASPP_ASSERT_EQ(out_evlr_count, 1u);
   }
 
+  // Copy a LAZ file spanning several batches (decoding and writing overlap across batches)
+  {
+    const size_t n_chunks = 20 * utilities::get_num_threads() * 2 + 7;
+    std::stringstream input_stream;
+    {
+      LASWriter writer(input_stream, 1 | 128);
+      std::vector<LASPointFormat1> points(n_chunks * 50 - 13);
+      for (size_t i = 0; i < points.size(); i++) {
+        points[i] = LASPointFormat1{};
+        points[i].x = static_cast<int32_t>(i);
+        points[i].gps_time.f64 = static_cast<double>(i);
+      }
+      writer.write_points(std::span<const LASPointFormat1>(points), 50);
+    }
+
+    input_stream.seekg(0);
+    LASReader reader(input_stream);
+    LASPP_ASSERT_EQ(reader.num_chunks(), n_chunks);
+    std::stringstream output_stream;
+    {
+      LASWriter writer(output_stream, 1 | 128);
+      writer.copy_from_reader(reader, false);
+    }
+
+    output_stream.seekg(0);
+    LASReader output_reader(output_stream);
+    LASPP_ASSERT_EQ(output_reader.num_points(), n_chunks * 50 - 13);
+    std::vector<LASPointFormat1> output_points(output_reader.num_points());
+    output_reader.read_chunks<LASPointFormat1>(output_points, {0, output_reader.num_chunks()});
+    for (size_t i = 0; i < output_points.size(); i++) {
+      LASPP_ASSERT_EQ(output_points[i].x, static_cast<int32_t>(i));
+      LASPP_ASSERT_EQ(output_points[i].gps_time.f64, static_cast<double>(i));
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_point.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "utilities/assert.hpp"
+
+using namespace laspp;
+
+namespace {
+
+std::vector<LASPointFormat1> read_all(LASReader& reader) {
+  std::vector<LASPointFormat1> points(reader.num_points());
+  reader.read_chunks(std::span<LASPointFormat1>(points), {0, reader.num_chunks()});
+  return points;
+}
+
+void check_same_file_contents(LASReader& reader, LASReader& rechunked_reader) {
+  LASPP_ASSERT(read_all(rechunked_reader) == read_all(reader));
+  LASPP_ASSERT_EQ(rechunked_reader.num_points(), reader.num_points());
+  LASPP_ASSERT_EQ(rechunked_reader.header().num_points_by_return(),
+                  reader.header().num_points_by_return());
+  LASPP_ASSERT_EQ(rechunked_reader.header().bounds().min_x(), reader.header().bounds().min_x());
+  LASPP_ASSERT_EQ(rechunked_reader.header().bounds().max_z(), reader.header().bounds().max_z());
+  LASPP_ASSERT_EQ(rechunked_reader.header().transform().scale_factors(),
+                  reader.header().transform().scale_factors());
+  LASPP_ASSERT_EQ(rechunked_reader.vlr_headers().size(), reader.vlr_headers().size());
+  LASPP_ASSERT_EQ(rechunked_reader.evlr_headers().size(), reader.evlr_headers().size());
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  // One large chunk, a run of small chunks and another large chunk, as written by callers that
+  // pass no chunk size
+  std::mt19937_64 gen(88);
+  std::uniform_int_distribution<int32_t> coordinate(0, 100000);
+  std::vector<LASPointFormat1> points(45000);
+  for (LASPointFormat1& point : points) {
+    point = LASPointFormat1::RandomData(gen);
+    point.x = coordinate(gen);
+    point.y = coordinate(gen);
+  }
+  std::stringstream input_stream;
+  {
+    LASWriter writer(input_stream, 1 | 128);
+    writer.header().transform() = Transform({0.01, 0.01, 0.01}, {0.0, 0.0, 0.0});
+    writer.write_wkt("GEOGCS[\"WGS 84\"]");
+    const std::span<const LASPointFormat1> all(points);
+    writer.write_points(all.subspan(0, 20000));
+    writer.write_points(all.subspan(20000, 3000), 1000);
+    writer.write_points(all.subspan(23000));
+  }
+  input_stream.seekg(0);
+  LASReader reader(input_stream);
+  LASPP_ASSERT_EQ(reader.num_chunks(), 5u);
+
+  // Split by point count; small chunks are copied compressed
+  {
+    std::stringstream rechunked_stream;
+    {
+      LASWriter writer(rechunked_stream, 1 | 128);
+      writer.rechunk_from_reader(reader, 4000);
+    }
+    rechunked_stream.seekg(0);
+    LASReader rechunked_reader(rechunked_stream);
+    check_same_file_contents(reader, rechunked_reader);
+    LASPP_ASSERT(rechunked_reader.wkt().has_value());
+    // 20000 -> 5 x 4000, 3 x 1000 unchanged, 22000 -> 5 x 4000 + 2000
+    const std::vector<size_t> ppc = rechunked_reader.points_per_chunk();
+    LASPP_ASSERT_EQ(ppc.size(), 14u);
+    LASPP_ASSERT(std::all_of(ppc.begin(), ppc.end(), [](size_t n) { return n <= 4000; }));
+    LASPP_ASSERT_EQ(ppc.back(), 2000u);
+    for (size_t i = 0; i < 3; i++) {
+      LASPP_ASSERT(rechunked_reader.read_compressed_chunk(5 + i) ==
+                   reader.read_compressed_chunk(1 + i));
+    }
+  }
+
+  // Split by compressed size
+  {
+    const std::vector<size_t> sizes = reader.compressed_chunk_sizes();
+    const size_t max_bytes = sizes[1] * 3;
+    std::stringstream rechunked_stream;
+    {
+      LASWriter writer(rechunked_stream, 1 | 128);
+      writer.rechunk_from_reader(reader, 1000000, max_bytes);
+    }
+    rechunked_stream.seekg(0);
+    LASReader rechunked_reader(rechunked_stream);
+    check_same_file_contents(reader, rechunked_reader);
+    const std::vector<size_t> rechunked_sizes = rechunked_reader.compressed_chunk_sizes();
+    LASPP_ASSERT_GT(rechunked_sizes.size(), 10u);
+    // The byte limit is met by estimate; allow for the pieces compressing a little worse
+    for (size_t size : rechunked_sizes) {
+      LASPP_ASSERT_LE(size, max_bytes + max_bytes / 10);
+    }
+  }
+
+  // A spatial index stays valid since the point order is unchanged
+  {
+    std::stringstream indexed_stream;
+    {
+      LASWriter writer(indexed_stream, 1 | 128);
+      writer.copy_from_reader(reader, true);
+    }
+    indexed_stream.seekg(0);
+    LASReader indexed_reader(indexed_stream);
+    std::stringstream rechunked_stream;
+    {
+      LASWriter writer(rechunked_stream, 1 | 128);
+      writer.rechunk_from_reader(indexed_reader, 3000);
+    }
+    rechunked_stream.seekg(0);
+    LASReader rechunked_reader(rechunked_stream);
+    check_same_file_contents(indexed_reader, rechunked_reader);
+    LASPP_ASSERT(rechunked_reader.has_lastools_spatial_index());
+    const Bound2D box(100.0, 200.0, 600.0, 450.0);
+    LASPP_ASSERT_EQ(rechunked_reader.count_points(box), indexed_reader.count_points(box));
+  }
+
+  // Files already within the limits are copied compressed chunk for chunk
+  {
+    std::stringstream rechunked_stream;
+    {
+      LASWriter writer(rechunked_stream, 1 | 128);
+      writer.rechunk_from_reader(reader, 50000);
+    }
+    rechunked_stream.seekg(0);
+    LASReader rechunked_reader(rechunked_stream);
+    LASPP_ASSERT_EQ(rechunked_reader.num_chunks(), reader.num_chunks());
+    for (size_t i = 0; i < reader.num_chunks(); i++) {
+      LASPP_ASSERT(rechunked_reader.read_compressed_chunk(i) == reader.read_compressed_chunk(i));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,453 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "las_header.hpp"
+#include "las_reader.hpp"
+#include "las_writer.hpp"
+#include "spatial_index.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/cancellation.hpp"
+#include "utilities/default_init_allocator.hpp"
+#include "utilities/memory_budget.hpp"
+#include "utilities/thread_pool.hpp"
+
+namespace laspp {
+
+// One processing tile as handed to a kernel: the points whose X/Y fall in the tile (the core),
+// followed by the points of neighbouring tiles within the halo distance of it.
+template <typename PointType>
+struct Tile {
+  size_t col;
+  size_t row;
+  Bound2D core;    // half-open, except on the far sides of the last column and row
+  Bound2D extent;  // core grown by the halo
+  std::vector<PointType> points;
+  size_t n_core = 0;
+  // One entry per core point; a kernel clears entries to leave points out of the output.
+  std::vector<bool> keep;
+
+  std::span<PointType> core_points() { return std::span<PointType>(points).subspan(0, n_core); }
+  std::span<const PointType> halo_points() const {
+    return std::span<const PointType>(points).subspan(n_core);
+  }
+};
+
+// Decoded LAZ chunks, evicted least recently used first beyond a byte capacity.
+template <typename PointType>
+class DecodedChunkCache {
+  struct Entry {
+    utilities::UninitializedVector<PointType> points;
+    uint64_t last_use;
+  };
+  std::unordered_map<size_t, Entry> m_entries;
+  size_t m_capacity_bytes;
+  size_t m_bytes = 0;
+  uint64_t m_clock = 0;
+  size_t m_n_decodes = 0;
+
+ public:
+  explicit DecodedChunkCache(size_t capacity_bytes) : m_capacity_bytes(capacity_bytes) {}
+
+  // Makes every chunk in `chunk_indices` available to get(), decoding the missing ones in
+  // parallel, then evicts other chunks until the cache is within capacity again.
+  void load(LASReader& reader, std::span<const size_t> chunk_indices) {
+    m_clock++;
+    std::vector<size_t> missing;
+    for (size_t chunk_index : chunk_indices) {
+      auto it = m_entries.find(chunk_index);
+      if (it != m_entries.end()) {
+        it->second.last_use = m_clock;
+      } else {
+        missing.push_back(chunk_index);
+      }
+    }
+
+    const std::vector<size_t> points_per_chunk = reader.points_per_chunk();
+    std::vector<std::vector<std::byte>> compressed(missing.size());
+    for (size_t i = 0; i < missing.size(); i++) {
+      compressed[i] = reader.read_compressed_chunk(missing[i]);
+    }
+    std::vector<utilities::UninitializedVector<PointType>> decoded(missing.size());
+    utilities::parallel_for(size_t{0}, missing.size(), [&](size_t i) {
+      decoded[i].resize(points_per_chunk[missing[i]]);
+      reader.decompress_chunk(missing[i], compressed[i], std::span<PointType>(decoded[i]));
+    });
+    for (size_t i = 0; i < missing.size(); i++) {
+      m_bytes += decoded[i].size() * sizeof(PointType);
+      m_entries.emplace(missing[i], Entry{std::move(decoded[i]), m_clock});
+    }
+    m_n_decodes += missing.size();
+
+    while (m_bytes > m_capacity_bytes) {
+      auto oldest = m_entries.end();
+      for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->second.last_use < m_clock &&
+            (oldest == m_entries.end() || it->second.last_use < oldest->second.last_use)) {
+          oldest = it;
+        }
+      }
+      if (oldest == m_entries.end()) {
+        break;  // everything left is in use
+      }
+      m_bytes -= oldest->second.points.size() * sizeof(PointType);
+      m_entries.erase(oldest);
+    }
+  }
+
+  // A chunk made available by the last load(). Safe to call concurrently.
+  std::span<const PointType> get(size_t chunk_index) const {
+    auto it = m_entries.find(chunk_index);
+    LASPP_ASSERT(it != m_entries.end(), "Chunk ", chunk_index, " is not loaded");
+    return std::span<const PointType>(it->second.points);
+  }
+
+  size_t num_decodes() const { return m_n_decodes; }
+  size_t size_bytes() const { return m_bytes; }
+};
+
+// Runs a neighbourhood kernel (noise filtering, normal estimation, ground filtering, ...) over
+// a file tile by tile. The data bounds are split into square tiles of `tile_size`; each tile
+// gets its core points plus a halo of the points within `halo` of it, so that the kernel sees
+// every neighbour of its core points, and only the core points are written.
+//
+// Tile points are gathered from the spatial index cells overlapping the tile and its halo, so a
+// tile decodes only the chunks holding its cells. Decoded LAZ chunks are shared between
+// neighbouring tiles through a DecodedChunkCache of `cache_bytes`: a batch takes on tiles only
+// while the chunks they need fit in it, and the chunks of a batch are loaded in groups that
+// do, so a file whose index cells are scattered over many chunks is decoded in several passes
+// rather than held whole. Without a spatial index covering every point, the file is instead
+// scanned once, in blocks of at most `cache_bytes` (and at least one chunk), bucketing every
+// point into the tiles whose core or halo holds it; the buckets are reserved against the
+// memory budget. Tiles are processed in row-major batches, with their kernels running in
+// parallel.
+class TiledProcessor {
+  LASReader& m_reader;
+  double m_tile_size;
+  double m_halo;
+  size_t m_cache_bytes;
+  Bound2D m_bounds;
+  size_t m_n_cols;
+  size_t m_n_rows;
+  size_t m_n_chunk_decodes = 0;
+  size_t m_peak_cache_bytes = 0;
+
+ public:
+  // Points are written in chunks of this many
+  static constexpr size_t OUTPUT_CHUNK_SIZE = 50000;
+
+  TiledProcessor(LASReader& reader, double tile_size, double halo,
+                 size_t cache_bytes = size_t{256} << 20)
+      : m_reader(reader), m_tile_size(tile_size), m_halo(halo), m_cache_bytes(cache_bytes) {
+    LASPP_ASSERT_GT(tile_size, 0.0);
+    LASPP_ASSERT_GE(halo, 0.0);
+    const Bound3D& bounds = reader.header().bounds();
+    m_bounds = Bound2D(bounds.min_x(), bounds.min_y(), bounds.max_x(), bounds.max_y());
+    m_n_cols = tile_count(bounds.max_x() - bounds.min_x());
+    m_n_rows = tile_count(bounds.max_y() - bounds.min_y());
+  }
+
+  size_t n_cols() const { return m_n_cols; }
+  size_t n_rows() const { return m_n_rows; }
+  size_t num_tiles() const { return m_n_cols * m_n_rows; }
+  // LAZ chunks decoded by the last run(), counting chunks decoded again after eviction.
+  size_t num_chunk_decodes() const { return m_n_chunk_decodes; }
+  // Most decoded point bytes held at once by the last run(), in the chunk cache or in the block
+  // being scanned.
+  size_t peak_cache_bytes() const { return m_peak_cache_bytes; }
+
+  Bound2D tile_core(size_t col, size_t row) const {
+    const double min_x = m_bounds.min_x() + static_cast<double>(col) * m_tile_size;
+    const double min_y = m_bounds.min_y() + static_cast<double>(row) * m_tile_size;
+    return Bound2D(min_x, min_y, min_x + m_tile_size, min_y + m_tile_size);
+  }
+
+  // Calls kernel(Tile<PointType>&) for every tile with points and writes the core points the
+  // kernel keeps, in tile order. Header metadata, VLRs and EVLRs are copied from the reader,
+  // except for its spatial index, which no longer matches the point order.
+  template <typename PointType, typename Kernel>
+  void run(LASWriter& writer, Kernel&& kernel) {
+    writer.copy_metadata_from(m_reader, true);
+
+    const bool is_laz = m_reader.header().is_laz_compressed();
+    const bool indexed = m_reader.spatial_index_is_complete();
+    const std::vector<size_t> points_per_chunk = m_reader.points_per_chunk();
+    std::vector<uint64_t> chunk_first_point(points_per_chunk.size() + 1, 0);
+    std::partial_sum(points_per_chunk.begin(), points_per_chunk.end(),
+                     chunk_first_point.begin() + 1);
+    const auto chunk_containing = [&](uint64_t point) {
+      return static_cast<size_t>(std::upper_bound(chunk_first_point.begin(),
+                                                  chunk_first_point.end(), point) -
+                                 chunk_first_point.begin()) -
+             1;
+    };
+
+    DecodedChunkCache<PointType> cache(m_cache_bytes);
+    m_peak_cache_bytes = 0;
+    const auto chunk_bytes = [&](size_t c) { return points_per_chunk[c] * sizeof(PointType); };
+
+    std::vector<std::vector<PointType>> core_buckets;
+    std::vector<std::vector<PointType>> halo_buckets;
+    utilities::MemoryReservation bucket_reservation;
+    if (!indexed) {
+      bucket_points<PointType>(core_buckets, halo_buckets, bucket_reservation);
+    }
+
+    utilities::UninitializedVector<PointType> output;
+    const size_t max_batch_tiles = 2 * utilities::get_num_threads();
+    for (size_t batch_begin = 0; batch_begin < num_tiles();) {
+      utilities::check_cancellation();
+      std::vector<Tile<PointType>> tiles;
+      std::vector<std::vector<PointInterval>> intervals;
+      std::vector<size_t> chunks;  // sorted chunks holding candidates of the batch's tiles
+      while (batch_begin + tiles.size() < num_tiles() && tiles.size() < max_batch_tiles) {
+        Tile<PointType> tile;
+        tile.col = (batch_begin + tiles.size()) % m_n_cols;
+        tile.row = (batch_begin + tiles.size()) / m_n_cols;
+        tile.core = tile_core(tile.col, tile.row);
+        tile.extent = tile_extent(tile.core);
+        std::vector<PointInterval> tile_intervals;
+        if (indexed) {
+          tile_intervals = m_reader.candidate_intervals(tile.extent);
+        }
+        if (indexed && is_laz) {
+          std::vector<size_t> tile_chunks;
+          for (const PointInterval& interval : tile_intervals) {
+            for (size_t c = chunk_containing(interval.start); c <= chunk_containing(interval.end);
+                 c++) {
+              tile_chunks.push_back(c);
+            }
+          }
+          std::sort(tile_chunks.begin(), tile_chunks.end());
+          tile_chunks.erase(std::unique(tile_chunks.begin(), tile_chunks.end()),
+                            tile_chunks.end());
+          std::vector<size_t> batch_chunks;
+          std::set_union(chunks.begin(), chunks.end(), tile_chunks.begin(), tile_chunks.end(),
+                         std::back_inserter(batch_chunks));
+          size_t batch_bytes = 0;
+          for (size_t c : batch_chunks) batch_bytes += chunk_bytes(c);
+          // Only a batch's first tile may need more chunks than the cache holds
+          if (!tiles.empty() && batch_bytes > m_cache_bytes) {
+            break;
+          }
+          chunks = std::move(batch_chunks);
+        }
+        tiles.push_back(std::move(tile));
+        intervals.push_back(std::move(tile_intervals));
+      }
+      const size_t batch_end = batch_begin + tiles.size();
+
+      std::vector<std::vector<PointType>> core(tiles.size());
+      std::vector<std::vector<PointType>> halo(tiles.size());
+      const auto add = [&](size_t t, const PointType& point) {
+        const auto [x, y] = scaled_xy(point);
+        if (tile_of(x, y) == batch_begin + t) {
+          core[t].push_back(point);
+        } else if (tiles[t].extent.contains(x, y)) {
+          halo[t].push_back(point);
+        }
+      };
+      if (!indexed) {
+        for (size_t t = 0; t < tiles.size(); t++) {
+          core[t] = std::move(core_buckets[batch_begin + t]);
+          halo[t] = std::move(halo_buckets[batch_begin + t]);
+        }
+      } else if (is_laz) {
+        // Load the chunks in groups that fit the cache, taking from each the candidates of
+        // every tile that fall in it
+        for (size_t g = 0; g < chunks.size();) {
+          size_t g_end = g;
+          size_t group_bytes = 0;
+          while (g_end < chunks.size() &&
+                 (g_end == g || group_bytes + chunk_bytes(chunks[g_end]) <= m_cache_bytes)) {
+            group_bytes += chunk_bytes(chunks[g_end++]);
+          }
+          cache.load(m_reader, std::span<const size_t>(chunks).subspan(g, g_end - g));
+          m_peak_cache_bytes = std::max(m_peak_cache_bytes, cache.size_bytes());
+          const uint64_t group_first = chunk_first_point[chunks[g]];
+          const uint64_t group_last = chunk_first_point[chunks[g_end - 1] + 1] - 1;
+          utilities::parallel_for(size_t{0}, tiles.size(), [&](size_t t) {
+            for (const PointInterval& interval : intervals[t]) {
+              const uint64_t end = std::min<uint64_t>(interval.end, group_last);
+              for (uint64_t point = std::max<uint64_t>(interval.start, group_first);
+                   point <= end;) {
+                const size_t c = chunk_containing(point);
+                const std::span<const PointType> chunk = cache.get(c);
+                const uint64_t last = std::min<uint64_t>(end, chunk_first_point[c + 1] - 1);
+                for (uint64_t p = point; p <= last; p++) {
+                  add(t, chunk[p - chunk_first_point[c]]);
+                }
+                point = last + 1;
+              }
+            }
+          });
+          g = g_end;
+        }
+      } else {
+        // Uncompressed points are directly addressable: read each tile's candidates
+        for (size_t t = 0; t < tiles.size(); t++) {
+          std::vector<size_t> indices;
+          for (const PointInterval& interval : intervals[t]) {
+            for (uint64_t point = interval.start; point <= interval.end; point++) {
+              indices.push_back(point);
+            }
+          }
+          std::vector<PointType> candidates(indices.size());
+          m_reader.read_points_by_index(std::span<PointType>(candidates),
+                                        std::span<const size_t>(indices));
+          for (const PointType& point : candidates) add(t, point);
+        }
+      }
+
+      utilities::parallel_for(size_t{0}, tiles.size(), [&](size_t t) {
+        Tile<PointType>& tile = tiles[t];
+        tile.n_core = core[t].size();
+        tile.keep.assign(core[t].size(), true);
+        tile.points = std::move(core[t]);
+        tile.points.insert(tile.points.end(), halo[t].begin(), halo[t].end());
+        halo[t] = {};
+        if (tile.n_core > 0) {
+          kernel(tile);
+        }
+      });
+
+      for (Tile<PointType>& tile : tiles) {
+        for (size_t i = 0; i < tile.n_core; i++) {
+          if (tile.keep[i]) output.push_back(tile.points[i]);
+        }
+      }
+      const size_t n_full = output.size() / OUTPUT_CHUNK_SIZE * OUTPUT_CHUNK_SIZE;
+      if (n_full > 0) {
+        writer.write_points(std::span<const PointType>(output.data(), n_full),
+                            OUTPUT_CHUNK_SIZE);
+        output.erase(output.begin(), output.begin() + static_cast<std::ptrdiff_t>(n_full));
+      }
+      batch_begin = batch_end;
+    }
+    if (!output.empty()) {
+      writer.write_points(std::span<const PointType>(output), OUTPUT_CHUNK_SIZE);
+    }
+    m_n_chunk_decodes = cache.num_decodes();
+    writer.copy_evlrs_from(m_reader, true);
+  }
+
+ private:
+  Bound2D tile_extent(const Bound2D& core) const {
+    return Bound2D(core.min_x() - m_halo, core.min_y() - m_halo, core.max_x() + m_halo,
+                   core.max_y() + m_halo);
+  }
+
+  // Scans the file once, appending each point, in file order, to the core bucket of its tile
+  // and to the halo buckets of the other tiles whose extent holds it. `reservation` takes the
+  // buckets' memory, estimated from the share of a tile's extent that is halo.
+  template <typename PointType>
+  void bucket_points(std::vector<std::vector<PointType>>& core_buckets,
+                     std::vector<std::vector<PointType>>& halo_buckets,
+                     utilities::MemoryReservation& reservation) {
+    const double extent_ratio = std::pow((m_tile_size + 2 * m_halo) / m_tile_size, 2);
+    reservation = utilities::MemoryReservation(
+        utilities::get_memory_budget(),
+        static_cast<size_t>(static_cast<double>(m_reader.num_points() * sizeof(PointType)) *
+                            extent_ratio),
+        "TiledProcessor tile buckets");
+    core_buckets.assign(num_tiles(), {});
+    halo_buckets.assign(num_tiles(), {});
+    // Tiles whose halo may hold a point are at most this many columns or rows from its own
+    const size_t reach = static_cast<size_t>(std::ceil(m_halo / m_tile_size));
+    scan_points<PointType>([&](std::span<const PointType> block) {
+      for (const PointType& point : block) {
+        const auto [x, y] = scaled_xy(point);
+        const size_t home = tile_of(x, y);
+        core_buckets[home].push_back(point);
+        const size_t col = home % m_n_cols;
+        const size_t row = home / m_n_cols;
+        for (size_t r = row - std::min(row, reach); r <= std::min(m_n_rows - 1, row + reach);
+             r++) {
+          for (size_t c = col - std::min(col, reach); c <= std::min(m_n_cols - 1, col + reach);
+               c++) {
+            const size_t t = r * m_n_cols + c;
+            if (t != home && tile_extent(tile_core(c, r)).contains(x, y)) {
+              halo_buckets[t].push_back(point);
+            }
+          }
+        }
+      }
+    });
+  }
+
+  // Calls f(std::span<const PointType>) for consecutive blocks of the file's points of at most
+  // m_cache_bytes, made of whole chunks (at least one) for LAZ files.
+  template <typename PointType, typename Function>
+  void scan_points(Function&& f) {
+    const size_t block_points = std::max<size_t>(1, m_cache_bytes / sizeof(PointType));
+    utilities::UninitializedVector<PointType> points;
+    auto scan_block = [&]() {
+      m_peak_cache_bytes = std::max(m_peak_cache_bytes, points.size() * sizeof(PointType));
+      f(std::span<const PointType>(points));
+    };
+    if (!m_reader.header().is_laz_compressed()) {
+      std::vector<size_t> indices;
+      for (uint64_t first = 0; first < m_reader.num_points(); first += block_points) {
+        utilities::check_cancellation();
+        indices.resize(std::min<uint64_t>(block_points, m_reader.num_points() - first));
+        std::iota(indices.begin(), indices.end(), first);
+        points.resize(indices.size());
+        m_reader.read_points_by_index(std::span<PointType>(points),
+                                      std::span<const size_t>(indices));
+        scan_block();
+      }
+      return;
+    }
+    const std::vector<size_t> points_per_chunk = m_reader.points_per_chunk();
+    for (size_t c = 0; c < points_per_chunk.size();) {
+      utilities::check_cancellation();
+      size_t end = c;
+      size_t n_points = 0;
+      while (end < points_per_chunk.size() &&
+             (end == c || n_points + points_per_chunk[end] <= block_points)) {
+        n_points += points_per_chunk[end++];
+      }
+      points.resize(n_points);
+      m_reader.read_chunks(std::span<PointType>(points), {c, end});
+      scan_block();
+      c = end;
+    }
+  }
+
+  size_t tile_count(double extent) const {
+    return std::max<size_t>(1, static_cast<size_t>(std::ceil(extent / m_tile_size)));
+  }
+
+  template <typename PointType>
+  std::pair<double, double> scaled_xy(const PointType& point) const {
+    const Transform& transform = m_reader.header().transform();
+    return {int32_to_double(point.x, transform.scale_factors().x(), transform.offsets().x()),
+            int32_to_double(point.y, transform.scale_factors().y(), transform.offsets().y())};
+  }
+
+  // Row-major index of the tile whose core holds (x, y); points on or beyond the data bounds
+  // belong to the edge tiles.
+  size_t tile_of(double x, double y) const {
+    const double col = std::floor((x - m_bounds.min_x()) / m_tile_size);
+    const double row = std::floor((y - m_bounds.min_y()) / m_tile_size);
+    const size_t clamped_col =
+        static_cast<size_t>(std::clamp(col, 0.0, static_cast<double>(m_n_cols - 1)));
+    const size_t clamped_row =
+        static_cast<size_t>(std::clamp(row, 0.0, static_cast<double>(m_n_rows - 1)));
+    return clamped_row * m_n_cols + clamped_col;
+  }
+};
+
+}  // namespace laspp
@@ -0,0 +1,171 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "assert.hpp"
+
+namespace laspp {
+namespace utilities {
+
+// Thread-safe pool of reusable byte buffers grouped into power-of-two size classes.
+// Used by the stream-based reader path so that reading compressed chunks does not
+// allocate (and free) a fresh buffer for every chunk.
+class BufferPool {
+ public:
+  // Buffers at or below this capacity go back to the pool when released; larger ones
+  // (e.g. whole uncompressed point blocks) are freed so the pool never pins them.
+  static constexpr size_t DEFAULT_MAX_POOLED_SIZE = size_t{64} << 20;
+  static constexpr size_t MIN_SIZE_CLASS = size_t{4} << 10;
+
+  struct Stats {
+    size_t n_acquired = 0;       // number of acquire() calls
+    size_t n_allocations = 0;    // acquisitions that had to allocate a new buffer
+    size_t bytes_allocated = 0;  // total bytes allocated by the pool
+
+    double bytes_allocated_per_acquire() const {
+      return n_acquired == 0 ? 0.0
+                             : static_cast<double>(bytes_allocated) /
+                                   static_cast<double>(n_acquired);
+    }
+  };
+
+  // RAII handle to a pooled buffer; returns the storage to its pool on destruction.
+  class Buffer {
+    BufferPool* m_pool = nullptr;
+    std::unique_ptr<std::byte[]> m_storage;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+
+    friend class BufferPool;
+
+    Buffer(BufferPool* pool, std::unique_ptr<std::byte[]> storage, size_t capacity, size_t size)
+        : m_pool(pool), m_storage(std::move(storage)), m_capacity(capacity), m_size(size) {}
+
+   public:
+    Buffer() = default;
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+    Buffer(Buffer&& other) noexcept
+        : m_pool(std::exchange(other.m_pool, nullptr)),
+          m_storage(std::move(other.m_storage)),
+          m_capacity(std::exchange(other.m_capacity, 0)),
+          m_size(std::exchange(other.m_size, 0)) {}
+    Buffer& operator=(Buffer&& other) noexcept {
+      if (this != &other) {
+        release();
+        m_pool = std::exchange(other.m_pool, nullptr);
+        m_storage = std::move(other.m_storage);
+        m_capacity = std::exchange(other.m_capacity, 0);
+        m_size = std::exchange(other.m_size, 0);
+      }
+      return *this;
+    }
+    ~Buffer() { release(); }
+
+    std::byte* data() noexcept { return m_storage.get(); }
+    const std::byte* data() const noexcept { return m_storage.get(); }
+    size_t size() const noexcept { return m_size; }
+    size_t capacity() const noexcept { return m_capacity; }
+
+    std::span<std::byte> span() noexcept { return {m_storage.get(), m_size}; }
+    std::span<const std::byte> span() const noexcept { return {m_storage.get(), m_size}; }
+
+   private:
+    void release() noexcept {
+      if (m_pool != nullptr && m_storage != nullptr) {
+        m_pool->give_back(std::move(m_storage), m_capacity);
+      }
+      m_pool = nullptr;
+      m_storage.reset();
+      m_capacity = 0;
+      m_size = 0;
+    }
+  };
+
+  explicit BufferPool(size_t max_pooled_size = DEFAULT_MAX_POOLED_SIZE)
+      : m_max_pooled_size(max_pooled_size) {}
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+  BufferPool(BufferPool&&) = delete;
+  BufferPool& operator=(BufferPool&&) = delete;
+
+  // Returns a buffer of exactly `size` bytes. Contents are uninitialised.
+  Buffer acquire(size_t size) {
+    const size_t capacity = size_class(size);
+    std::unique_ptr<std::byte[]> storage;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stats.n_acquired++;
+      if (capacity <= m_max_pooled_size) {
+        auto& free_list = m_free_lists[size_class_index(capacity)];
+        if (!free_list.empty()) {
+          storage = std::move(free_list.back());
+          free_list.pop_back();
+        }
+      }
+      if (storage == nullptr) {
+        m_stats.n_allocations++;
+        m_stats.bytes_allocated += capacity;
+      }
+    }
+    if (storage == nullptr) {
+      storage = std::make_unique_for_overwrite<std::byte[]>(capacity);
+    }
+    return Buffer(this, std::move(storage), capacity, size);
+  }
+
+  Stats stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+
+  // Frees every cached buffer. Outstanding buffers are unaffected.
+  void trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& free_list : m_free_lists) {
+      free_list.clear();
+    }
+  }
+
+  static size_t size_class(size_t size) { return std::bit_ceil(std::max(size, MIN_SIZE_CLASS)); }
+
+ private:
+  static size_t size_class_index(size_t capacity) {
+    LASPP_ASSERT(std::has_single_bit(capacity), "Buffer capacity must be a size class");
+    return static_cast<size_t>(std::countr_zero(capacity));
+  }
+
+  void give_back(std::unique_ptr<std::byte[]> storage, size_t capacity) noexcept {
+    if (capacity > m_max_pooled_size) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    try {
+      m_free_lists[size_class_index(capacity)].push_back(std::move(storage));
+    } catch (...) {
+      // Could not grow the free list: just let the storage be freed.
+    }
+  }
+
+  size_t m_max_pooled_size;
+  mutable std::mutex m_mutex;
+  std::array<std::vector<std::unique_ptr<std::byte[]>>, 64> m_free_lists;
+  Stats m_stats;
+};
+
+}  // namespace utilities
+}  // namespace laspp
@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace laspp {
+namespace utilities {
+
+// Thrown by an operation that stops early because its cancellation token was cancelled or its
+// deadline passed.
+class OperationCancelled : public std::runtime_error {
+ public:
+  OperationCancelled() : std::runtime_error("Operation cancelled") {}
+};
+
+// Cancellation flag with an optional deadline. Copies share the flag, so a token handed to an
+// operation can be cancelled from any thread.
+class CancellationToken {
+  struct State {
+    std::atomic<bool> cancelled{false};
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+  };
+  std::shared_ptr<State> m_state = std::make_shared<State>();
+
+ public:
+  CancellationToken() = default;
+
+  static CancellationToken with_deadline(std::chrono::steady_clock::time_point deadline) {
+    CancellationToken token;
+    token.m_state->deadline = deadline;
+    return token;
+  }
+
+  static CancellationToken with_timeout(std::chrono::steady_clock::duration timeout) {
+    return with_deadline(std::chrono::steady_clock::now() + timeout);
+  }
+
+  void cancel() const { m_state->cancelled.store(true, std::memory_order_relaxed); }
+
+  bool is_cancelled() const {
+    if (m_state->cancelled.load(std::memory_order_relaxed)) {
+      return true;
+    }
+    if (m_state->deadline.has_value() && std::chrono::steady_clock::now() >= *m_state->deadline) {
+      cancel();
+      return true;
+    }
+    return false;
+  }
+
+  void throw_if_cancelled() const {
+    if (is_cancelled()) {
+      throw OperationCancelled();
+    }
+  }
+};
+
+namespace detail {
+inline const CancellationToken*& current_cancellation_token() {
+  thread_local const CancellationToken* token = nullptr;
+  return token;
+}
+}  // namespace detail
+
+// Makes `token` the cancellation token of everything the current thread runs until the scope
+// ends: reads, writes and parallel loops check it between chunks (and every few thousand points
+// within a chunk) and throw OperationCancelled once it is cancelled. Parallel loops hand the
+// token on to their workers. Scopes nest; the innermost token applies.
+class CancellationScope {
+  CancellationToken m_token;
+  const CancellationToken* m_previous;
+
+ public:
+  explicit CancellationScope(CancellationToken token)
+      : m_token(std::move(token)), m_previous(detail::current_cancellation_token()) {
+    detail::current_cancellation_token() = &m_token;
+  }
+  ~CancellationScope() { detail::current_cancellation_token() = m_previous; }
+
+  CancellationScope(const CancellationScope&) = delete;
+  CancellationScope& operator=(const CancellationScope&) = delete;
+  CancellationScope(CancellationScope&&) = delete;
+  CancellationScope& operator=(CancellationScope&&) = delete;
+};
+
+// The token of the innermost CancellationScope on this thread, if any.
+inline std::optional<CancellationToken> current_cancellation_token() {
+  const CancellationToken* token = detail::current_cancellation_token();
+  return token == nullptr ? std::nullopt : std::optional<CancellationToken>(*token);
+}
+
+// Throws OperationCancelled if the current thread's token has been cancelled.
+inline void check_cancellation() {
+  const CancellationToken* token = detail::current_cancellation_token();
+  if (token != nullptr) {
+    token->throw_if_cancelled();
+  }
+}
+
+// Wraps `f` so that it runs under the calling thread's cancellation token, for work handed to
+// another thread (e.g. through std::async).
+template <typename Function>
+auto with_current_cancellation(Function f) {
+  return [token = current_cancellation_token(), f = std::move(f)](auto&&... args) mutable {
+    std::optional<CancellationScope> scope;
+    if (token.has_value()) {
+      scope.emplace(*token);
+    }
+    return f(std::forward<decltype(args)>(args)...);
+  };
+}
+
+}  // namespace utilities
+}  // namespace laspp
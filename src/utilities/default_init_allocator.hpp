@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace laspp {
+namespace utilities {
+
+// Allocator adaptor that default-initialises instead of value-initialising, so that
+// `resize(n)` and `vector(n)` leave trivially constructible elements (e.g. point records)
+// uninitialised. The memory is then first touched by whichever threads fill it, rather than
+// being zeroed on the allocating thread and written a second time.
+template <typename T, typename Allocator = std::allocator<T>>
+class DefaultInitAllocator : public Allocator {
+  using Traits = std::allocator_traits<Allocator>;
+
+ public:
+  template <typename U>
+  struct rebind {
+    using other = DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>>;
+  };
+
+  using Allocator::Allocator;
+  DefaultInitAllocator() = default;
+
+  template <typename U>
+  void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void*>(ptr)) U;
+  }
+  template <typename U, typename... Args>
+  void construct(U* ptr, Args&&... args) {
+    Traits::construct(static_cast<Allocator&>(*this), ptr, std::forward<Args>(args)...);
+  }
+};
+
+// Vector whose sized construction and resize() do not zero trivially constructible elements.
+// Use for large buffers that are fully overwritten (e.g. by read_chunks or a parallel copy).
+template <typename T>
+using UninitializedVector = std::vector<T, DefaultInitAllocator<T>>;
+
+}  // namespace utilities
+}  // namespace laspp
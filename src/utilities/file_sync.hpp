@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "utilities/assert.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace laspp {
+namespace utilities {
+
+// Writes the operating-system buffers of the file at `path` to its storage device, so that
+// what was written to it (and flushed from any stream) survives a crash of the machine.
+inline void sync_file(const std::filesystem::path& path) {
+#ifdef _WIN32
+  HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  LASPP_ASSERT(handle != INVALID_HANDLE_VALUE, "Failed to open ", path.string(), " to sync it");
+  const bool synced = FlushFileBuffers(handle);
+  CloseHandle(handle);
+#else
+  const int fd = open(path.c_str(), O_RDONLY);
+  LASPP_ASSERT_NE(fd, -1, "Failed to open ", path.string(), " to sync it");
+  const bool synced = fsync(fd) == 0;
+  close(fd);
+#endif
+  LASPP_ASSERT(synced, "Failed to sync ", path.string());
+}
+
+// Makes the entries of `directory` durable, e.g. a file just created or renamed into it. Windows
+// cannot sync a directory; its file system journals renames itself.
+inline void sync_directory([[maybe_unused]] const std::filesystem::path& directory) {
+#ifndef _WIN32
+  sync_file(directory.empty() ? std::filesystem::path(".") : directory);
+#endif
+}
+
+}  // namespace utilities
+}  // namespace laspp
@@ -0,0 +1,192 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "env.hpp"
+
+namespace laspp {
+namespace utilities {
+
+// Thrown when a component cannot obtain the memory it needs within the configured budget.
+class MemoryBudgetExceeded : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// Parses a byte count such as "1048576", "512K", "256M" or "4G" (binary multiples).
+// Returns std::nullopt if the string is not a valid positive size.
+inline std::optional<size_t> parse_byte_size(const std::string& str) {
+  // strtoull would skip leading whitespace and accept a sign, wrapping "-1" to the maximum
+  if (str.empty() || str.front() < '0' || str.front() > '9') {
+    return std::nullopt;
+  }
+  const char* begin = str.c_str();
+  char* end = nullptr;
+  errno = 0;
+  unsigned long long value = std::strtoull(begin, &end, 10);
+  if (end == begin || value == 0 || errno == ERANGE) {
+    return std::nullopt;
+  }
+  size_t shift = 0;
+  switch (*end) {
+    case '\0':
+      break;
+    case 'k':
+    case 'K':
+      shift = 10;
+      break;
+    case 'm':
+    case 'M':
+      shift = 20;
+      break;
+    case 'g':
+    case 'G':
+      shift = 30;
+      break;
+    case 't':
+    case 'T':
+      shift = 40;
+      break;
+    default:
+      return std::nullopt;
+  }
+  if (*end != '\0' && *(end + 1) != '\0') {
+    return std::nullopt;
+  }
+  if (value > (std::numeric_limits<size_t>::max() >> shift)) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(value) << shift;
+}
+
+// Process-wide accounting of large, transient allocations (point batches, compressed chunk
+// payloads, spatial index construction). Components reserve against the budget before
+// allocating and adapt (smaller batches, fewer chunks in flight) when `try_reserve` fails,
+// or throw MemoryBudgetExceeded rather than being OOM-killed. Without a limit every
+// reservation succeeds.
+class MemoryBudget {
+ public:
+  explicit MemoryBudget(std::optional<size_t> limit = std::nullopt)
+      : m_limit(limit.value_or(UNLIMITED)) {}
+
+  MemoryBudget(const MemoryBudget&) = delete;
+  MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+  void set_limit(std::optional<size_t> limit) { m_limit = limit.value_or(UNLIMITED); }
+  std::optional<size_t> limit() const {
+    size_t limit = m_limit;
+    return limit == UNLIMITED ? std::nullopt : std::optional<size_t>(limit);
+  }
+
+  size_t reserved() const { return m_reserved; }
+  size_t available() const {
+    size_t limit = m_limit;
+    size_t reserved = m_reserved;
+    if (limit == UNLIMITED) return UNLIMITED;
+    return reserved >= limit ? 0 : limit - reserved;
+  }
+
+  bool try_reserve(size_t bytes) {
+    size_t current = m_reserved.load();
+    while (true) {
+      size_t limit = m_limit;
+      if (bytes > limit || current > limit - bytes) {
+        return false;
+      }
+      if (m_reserved.compare_exchange_weak(current, current + bytes)) {
+        return true;
+      }
+    }
+  }
+
+  void reserve(size_t bytes, const std::string& what) {
+    if (!try_reserve(bytes)) {
+      throw MemoryBudgetExceeded("LAS++ memory budget exceeded: " + what + " needs " +
+                                 std::to_string(bytes) + " bytes but only " +
+                                 std::to_string(available()) + " of " + std::to_string(m_limit) +
+                                 " bytes are available");
+    }
+  }
+
+  void release(size_t bytes) { m_reserved.fetch_sub(bytes); }
+
+ private:
+  static constexpr size_t UNLIMITED = std::numeric_limits<size_t>::max();
+
+  std::atomic<size_t> m_limit;
+  std::atomic<size_t> m_reserved{0};
+};
+
+// RAII reservation against a MemoryBudget.
+class MemoryReservation {
+  MemoryBudget* m_budget = nullptr;
+  size_t m_bytes = 0;
+
+  MemoryReservation(MemoryBudget* budget, size_t bytes) : m_budget(budget), m_bytes(bytes) {}
+
+ public:
+  MemoryReservation() = default;
+  MemoryReservation(MemoryBudget& budget, size_t bytes, const std::string& what)
+      : m_budget(&budget), m_bytes(bytes) {
+    budget.reserve(bytes, what);
+  }
+
+  static std::optional<MemoryReservation> try_reserve(MemoryBudget& budget, size_t bytes) {
+    if (!budget.try_reserve(bytes)) {
+      return std::nullopt;
+    }
+    return MemoryReservation(&budget, bytes);
+  }
+
+  MemoryReservation(const MemoryReservation&) = delete;
+  MemoryReservation& operator=(const MemoryReservation&) = delete;
+  MemoryReservation(MemoryReservation&& other) noexcept
+      : m_budget(std::exchange(other.m_budget, nullptr)),
+        m_bytes(std::exchange(other.m_bytes, 0)) {}
+  MemoryReservation& operator=(MemoryReservation&& other) noexcept {
+    if (this != &other) {
+      reset();
+      m_budget = std::exchange(other.m_budget, nullptr);
+      m_bytes = std::exchange(other.m_bytes, 0);
+    }
+    return *this;
+  }
+  ~MemoryReservation() { reset(); }
+
+  size_t bytes() const { return m_bytes; }
+
+  void reset() {
+    if (m_budget != nullptr) {
+      m_budget->release(m_bytes);
+    }
+    m_budget = nullptr;
+    m_bytes = 0;
+  }
+};
+
+// Global memory budget, initialised from the LASPP_MEMORY_LIMIT environment variable
+// (e.g. "8G"); unlimited if unset or invalid. Can be changed at runtime with set_limit().
+inline MemoryBudget& get_memory_budget() {
+  static MemoryBudget budget([]() -> std::optional<size_t> {
+    auto env_limit = get_env("LASPP_MEMORY_LIMIT");
+    if (!env_limit.has_value()) return std::nullopt;
+    return parse_byte_size(*env_limit);
+  }());
+  return budget;
+}
+
+}  // namespace utilities
+}  // namespace laspp
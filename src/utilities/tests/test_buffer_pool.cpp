@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "utilities/assert.hpp"
+#include "utilities/buffer_pool.hpp"
+
+using namespace laspp::utilities;
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  // Size classes round up to powers of two with a 4 KiB floor
+  {
+    LASPP_ASSERT_EQ(BufferPool::size_class(0), BufferPool::MIN_SIZE_CLASS);
+    LASPP_ASSERT_EQ(BufferPool::size_class(1), BufferPool::MIN_SIZE_CLASS);
+    LASPP_ASSERT_EQ(BufferPool::size_class(4096), 4096u);
+    LASPP_ASSERT_EQ(BufferPool::size_class(4097), 8192u);
+    LASPP_ASSERT_EQ(BufferPool::size_class(100000), 131072u);
+  }
+
+  // Released buffers are reused by later acquisitions in the same size class
+  {
+    BufferPool pool;
+    const std::byte* first_data = nullptr;
+    {
+      BufferPool::Buffer buf = pool.acquire(5000);
+      LASPP_ASSERT_EQ(buf.size(), 5000u);
+      LASPP_ASSERT_EQ(buf.capacity(), 8192u);
+      LASPP_ASSERT_EQ(buf.span().size(), 5000u);
+      std::memset(buf.data(), 0xAB, buf.size());
+      first_data = buf.data();
+    }
+    {
+      BufferPool::Buffer buf = pool.acquire(7000);
+      LASPP_ASSERT_EQ(buf.data(), first_data);
+      LASPP_ASSERT_EQ(buf.size(), 7000u);
+    }
+    {
+      // Different size class: needs a fresh allocation
+      BufferPool::Buffer buf = pool.acquire(20000);
+      LASPP_ASSERT_NE(buf.data(), first_data);
+    }
+
+    BufferPool::Stats stats = pool.stats();
+    LASPP_ASSERT_EQ(stats.n_acquired, 3u);
+    LASPP_ASSERT_EQ(stats.n_allocations, 2u);
+    LASPP_ASSERT_EQ(stats.bytes_allocated, 8192u + 32768u);
+    LASPP_ASSERT_EQ(stats.bytes_allocated_per_acquire(), (8192.0 + 32768.0) / 3.0);
+  }
+
+  // Moving a buffer transfers ownership; only the final owner returns it
+  {
+    BufferPool pool;
+    BufferPool::Buffer a = pool.acquire(100);
+    const std::byte* data = a.data();
+    BufferPool::Buffer b(std::move(a));
+    LASPP_ASSERT_EQ(b.data(), data);
+    LASPP_ASSERT_EQ(a.data(), nullptr);
+    BufferPool::Buffer c;
+    c = std::move(b);
+    LASPP_ASSERT_EQ(c.data(), data);
+    c = BufferPool::Buffer();
+    BufferPool::Buffer d = pool.acquire(200);
+    LASPP_ASSERT_EQ(d.data(), data);
+    LASPP_ASSERT_EQ(pool.stats().n_allocations, 1u);
+  }
+
+  // Oversized buffers are never cached
+  {
+    BufferPool pool(16384);
+    { BufferPool::Buffer big = pool.acquire(100000); }
+    { BufferPool::Buffer big = pool.acquire(100000); }
+    LASPP_ASSERT_EQ(pool.stats().n_allocations, 2u);
+
+    { BufferPool::Buffer small = pool.acquire(10000); }
+    pool.trim();
+    { BufferPool::Buffer small = pool.acquire(10000); }
+    LASPP_ASSERT_EQ(pool.stats().n_allocations, 4u);
+  }
+
+  // Concurrent acquire/release never hands the same buffer to two owners
+  {
+    BufferPool pool;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+      threads.emplace_back([&pool, t]() {
+        for (size_t i = 0; i < 1000; i++) {
+          BufferPool::Buffer buf = pool.acquire(1000 + i);
+          std::memset(buf.data(), static_cast<int>(t), buf.size());
+          for (size_t j = 0; j < buf.size(); j += 97) {
+            LASPP_ASSERT_EQ(buf.data()[j], static_cast<std::byte>(t));
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    BufferPool::Stats stats = pool.stats();
+    LASPP_ASSERT_EQ(stats.n_acquired, 4000u);
+    LASPP_ASSERT_LE(stats.n_allocations, 4u);
+  }
+
+  return 0;
+}
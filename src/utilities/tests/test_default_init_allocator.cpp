@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "las_point.hpp"
+#include "utilities/assert.hpp"
+#include "utilities/default_init_allocator.hpp"
+
+using namespace laspp;
+using namespace laspp::utilities;
+
+namespace {
+
+// Counts the constructions an allocator is asked to do, by the number of arguments, so a test can
+// tell value-initialisation (a construct() without arguments) from copies and moves.
+size_t g_value_constructs = 0;
+size_t g_argument_constructs = 0;
+
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  CountingAllocator() = default;
+  template <typename U>
+  explicit CountingAllocator(const CountingAllocator<U>&) {}
+
+  T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
+  void deallocate(T* ptr, size_t n) { std::allocator<T>().deallocate(ptr, n); }
+
+  template <typename U, typename... Args>
+  void construct(U* ptr, Args&&... args) {
+    (sizeof...(Args) == 0 ? g_value_constructs : g_argument_constructs)++;
+    ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+  }
+
+  bool operator==(const CountingAllocator&) const = default;
+};
+
+// Counts calls of its default constructor, which default-initialisation must still make.
+size_t g_default_constructions = 0;
+
+struct Counted {
+  Counted() { g_default_constructions++; }
+  int value = 0;
+};
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  // Sized construction and resize() never value-initialise, and growth keeps the contents
+  {
+    std::vector<int, DefaultInitAllocator<int, CountingAllocator<int>>> values(100);
+    LASPP_ASSERT_EQ(g_value_constructs, 0u);
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = static_cast<int>(i);
+    }
+    values.resize(10000);
+    LASPP_ASSERT_EQ(g_value_constructs, 0u);
+    LASPP_ASSERT_EQ(g_argument_constructs, 100u);
+    for (size_t i = 0; i < 100; i++) {
+      LASPP_ASSERT_EQ(values[i], static_cast<int>(i));
+    }
+    values.resize(50);
+    values.resize(20000);
+    LASPP_ASSERT_EQ(g_value_constructs, 0u);
+    for (size_t i = 0; i < 50; i++) {
+      LASPP_ASSERT_EQ(values[i], static_cast<int>(i));
+    }
+  }
+
+  // Types with a default constructor still have it run once per new element
+  {
+    UninitializedVector<Counted> counted(10);
+    LASPP_ASSERT_EQ(g_default_constructions, 10u);
+    counted[3].value = 3;
+    counted.resize(1000);
+    LASPP_ASSERT_EQ(g_default_constructions, 1000u);
+    LASPP_ASSERT_EQ(counted[3].value, 3);
+  }
+
+  // Explicit values and non-trivial element types are still constructed normally
+  {
+    UninitializedVector<int> values(100, 7);
+    for (int value : values) {
+      LASPP_ASSERT_EQ(value, 7);
+    }
+    values.push_back(8);
+    LASPP_ASSERT_EQ(values.back(), 8);
+
+    UninitializedVector<std::string> strings(3);
+    for (const std::string& str : strings) {
+      LASPP_ASSERT(str.empty());
+    }
+    strings.emplace_back(5, 'x');
+    LASPP_ASSERT_EQ(strings.back(), "xxxxx");
+  }
+
+  // Point buffers convert to spans like std::vector
+  {
+    UninitializedVector<LASPointFormat1> points(10);
+    std::span<LASPointFormat1> span(points);
+    span[3].x = 42;
+    LASPP_ASSERT_EQ(points[3].x, 42);
+  }
+
+  return 0;
+}
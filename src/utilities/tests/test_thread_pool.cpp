@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025-2026 Trailblaze Software, all rights reserved
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "utilities/assert.hpp"
+#include "utilities/thread_pool.hpp"
+
+using namespace laspp::utilities;
+
+namespace {
+
+struct Sum {
+  uint64_t value = 0;
+  void combine(const Sum& other) { value += other.value; }
+};
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  // Use the workers even on machines with fewer cores
+  setenv("LASPP_NUM_THREADS", "4", 1);
+  ThreadPool pool(4);
+
+  // Every index is visited exactly once, whatever the chunk size
+  for (size_t chunk_size : {size_t{1}, size_t{3}, size_t{1000}}) {
+    std::vector<std::atomic<int>> visits(1001);
+    pool.parallel_for(0, visits.size(), [&](size_t i) { visits[i]++; }, chunk_size);
+    for (const std::atomic<int>& n : visits) {
+      LASPP_ASSERT_EQ(n.load(), 1);
+    }
+    Sum sum;
+    pool.parallel_for_reduction(
+        5, 1001, sum, [](size_t i, Sum& local) { local.value += i; }, chunk_size);
+    LASPP_ASSERT_EQ(sum.value, 1000u * 1001u / 2u - 10u);
+  }
+
+  // A single chunk runs inline on the calling thread
+  {
+    std::thread::id id;
+    pool.parallel_for(0, 1, [&](size_t) { id = std::this_thread::get_id(); });
+    LASPP_ASSERT(id == std::this_thread::get_id());
+    pool.parallel_for(0, 8, [&](size_t) { id = std::this_thread::get_id(); }, 8);
+    LASPP_ASSERT(id == std::this_thread::get_id());
+  }
+
+  // Many tiny loops back to back
+  {
+    std::atomic<size_t> total{0};
+    for (size_t i = 0; i < 20000; i++) {
+      pool.parallel_for(0, 1 + i % 4, [&](size_t) { total++; });
+    }
+    LASPP_ASSERT_EQ(total.load(), 20000u / 4u * (1u + 2u + 3u + 4u));
+  }
+
+  // Loops nested in loops complete, since every caller works on its own loop
+  {
+    std::atomic<size_t> total{0};
+    pool.parallel_for(0, 16, [&](size_t) {
+      pool.parallel_for(0, 16, [&](size_t) { total++; });
+    });
+    LASPP_ASSERT_EQ(total.load(), 256u);
+  }
+
+  // Exceptions reach the caller, inline or not, and the pool stays usable
+  {
+    LASPP_ASSERT_THROWS(pool.parallel_for(0, 1, [](size_t) { throw std::runtime_error("x"); }),
+                        std::runtime_error);
+    LASPP_ASSERT_THROWS(pool.parallel_for(0, 100,
+                                          [](size_t i) {
+                                            if (i == 37) throw std::runtime_error("x");
+                                          }),
+                        std::runtime_error);
+    Sum sum;
+    LASPP_ASSERT_THROWS(pool.parallel_for_reduction(0, 100, sum,
+                                                    [](size_t i, Sum&) {
+                                                      if (i == 50) throw std::runtime_error("x");
+                                                    }),
+                        std::runtime_error);
+    std::atomic<size_t> total{0};
+    pool.parallel_for(0, 100, [&](size_t) { total++; });
+    LASPP_ASSERT_EQ(total.load(), 100u);
+  }
+
+  return 0;
+}
@@ -7,8 +7,10 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdlib>
+#include <exception>
 #include <functional>
 #include <latch>
 #include <memory>
@@ -21,6 +23,7 @@
 #include <vector>
 
 #include "assert.hpp"
+#include "cancellation.hpp"
 #include "env.hpp"
 
 namespace laspp {
@@ -43,9 +46,18 @@ inline size_t get_num_threads() {
   return std::max(size_t{1}, static_cast<size_t>(std::thread::hardware_concurrency()));
 }
 
-// Simple thread pool for parallel execution
+// Simple thread pool for parallel execution.
+//
+// The calling thread takes part in its own loops and only as many workers are woken as there
+// are chunks beyond the caller's, so a loop of a single chunk runs inline without touching the
+// pool. Idle workers spin for SPIN_DURATION before they park, so that back-to-back loops start
+// without a wake-up. Exceptions thrown by the loop body are rethrown on the calling thread once
+// the chunks already claimed have finished. Loops run under the caller's cancellation token (see
+// CancellationScope), which is checked before every chunk.
 class ThreadPool {
  public:
+  static constexpr std::chrono::microseconds SPIN_DURATION{50};
+
   explicit ThreadPool(size_t num_threads = get_num_threads())
       : m_max_threads(std::max(size_t{1}, num_threads)), m_stop(false) {
     // Don't create threads yet - create them lazily on demand
@@ -58,15 +70,27 @@ class ThreadPool {
     while (m_workers.size() < n_threads && m_workers.size() < m_max_threads) {
       m_workers.emplace_back([this] {
         while (true) {
+          // Spin briefly before parking; tasks queued meanwhile need no notification
+          const auto spin_end = std::chrono::steady_clock::now() + SPIN_DURATION;
+          while (m_n_queued.load(std::memory_order_relaxed) == 0 &&
+                 !m_stop.load(std::memory_order_relaxed) &&
+                 std::chrono::steady_clock::now() < spin_end) {
+            std::this_thread::yield();
+          }
           std::function<void()> task;
           {
             std::unique_lock<std::mutex> task_lock(m_queue_mutex);
-            m_condition.wait(task_lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (!m_stop && m_tasks.empty()) {
+              m_n_parked++;
+              m_condition.wait(task_lock, [this] { return m_stop || !m_tasks.empty(); });
+              m_n_parked--;
+            }
             if (m_stop && m_tasks.empty()) {
               return;
             }
             task = std::move(m_tasks.front());
             m_tasks.pop();
+            m_n_queued.fetch_sub(1, std::memory_order_relaxed);
           }
           task();
         }
@@ -100,48 +124,23 @@ class ThreadPool {
       return;
     }
 
-    size_t requested_threads = get_num_threads();
-    ensure_threads(requested_threads);
-    size_t active_threads = std::min(requested_threads, m_max_threads);
-
-    const size_t total_work = end - begin;
-    const size_t num_chunks = (total_work + chunk_size - 1) / chunk_size;  // Ceiling division
-
-    // Use latch to block caller until all work is complete
-    auto completion_latch = std::make_shared<std::latch>(num_chunks);
-
-    // Use shared_ptr to ensure atomics live long enough for all threads
-    auto next_chunk = std::make_shared<std::atomic<size_t>>(0);
-
-    for (size_t i = 0; i < active_threads; ++i) {
-      enqueue([next_chunk, num_chunks, begin, end, chunk_size, func, completion_latch]() mutable {
-        while (true) {
-          size_t chunk_idx = next_chunk->fetch_add(1);
-          if (chunk_idx >= num_chunks) {
-            break;
-          }
-
-          // Process all indices in this chunk
-          size_t chunk_begin = begin + chunk_idx * chunk_size;
-          size_t chunk_end = std::min(chunk_begin + chunk_size, end);
-          for (size_t idx = chunk_begin; idx < chunk_end; ++idx) {
-            func(idx);
-          }
-
-          // Signal completion of this chunk (reduces atomic contention)
-          completion_latch->count_down(1);
+    run_loop(begin, end, chunk_size, [&func, begin, end, chunk_size](auto& claim, auto& finish) {
+      while (std::optional<size_t> chunk_idx = claim()) {
+        // Process all indices in this chunk
+        size_t chunk_begin = begin + *chunk_idx * chunk_size;
+        size_t chunk_end = std::min(chunk_begin + chunk_size, end);
+        for (size_t idx = chunk_begin; idx < chunk_end; ++idx) {
+          func(idx);
         }
-      });
-    }
-
-    // Block until all chunks are complete
-    completion_latch->wait();
+        finish();
+      }
+    });
   }
 
   // Execute a reduction over [begin, end), accumulating into `result` via T::combine(const T&).
   // `func` is called as func(index, thread_local_T) for each index.
-  // Each worker thread builds its own local T (default-constructed), then merges into `result`
-  // under a mutex once all its assigned work is done.
+  // Each participating thread builds its own local T (default-constructed), then merges into
+  // `result` under a mutex once all its assigned work is done.
   template <typename T, typename Func>
   void parallel_for_reduction(size_t begin, size_t end, T& result, Func func,
                               size_t chunk_size = 1) {
@@ -150,64 +149,155 @@ class ThreadPool {
       return;
     }
 
-    size_t requested_threads = get_num_threads();
-    ensure_threads(requested_threads);
-    size_t active_threads = std::min(requested_threads, m_max_threads);
-
-    const size_t total_work = end - begin;
-    const size_t num_chunks = (total_work + chunk_size - 1) / chunk_size;  // Ceiling division
-
-    // Latch counts down once per active thread (after it finishes work + combine)
-    auto completion_latch = std::make_shared<std::latch>(active_threads);
-    auto next_chunk = std::make_shared<std::atomic<size_t>>(0);
-    auto combine_mutex = std::make_shared<std::mutex>();
-
-    for (size_t i = 0; i < active_threads; ++i) {
-      enqueue([next_chunk, num_chunks, begin, end, chunk_size, func, completion_latch,
-               combine_mutex, &result]() mutable {
-        T local{};
-        bool has_work = false;
-
-        while (true) {
-          size_t chunk_idx = next_chunk->fetch_add(1);
-          if (chunk_idx >= num_chunks) {
-            break;
-          }
+    std::mutex combine_mutex;
+    run_loop(begin, end, chunk_size,
+             [&func, &result, &combine_mutex, begin, end, chunk_size](auto& claim, auto& finish) {
+               T local{};
+               bool has_work = false;
+               while (std::optional<size_t> chunk_idx = claim()) {
+                 has_work = true;
+                 size_t chunk_begin = begin + *chunk_idx * chunk_size;
+                 size_t chunk_end = std::min(chunk_begin + chunk_size, end);
+                 for (size_t idx = chunk_begin; idx < chunk_end; ++idx) {
+                   func(idx, local);
+                 }
+               }
+
+               // Merge thread-local result into shared result before reporting the chunks done
+               if (has_work) {
+                 std::lock_guard<std::mutex> lock(combine_mutex);
+                 result.combine(local);
+               }
+               finish();
+             });
+  }
 
-          has_work = true;
-          size_t chunk_begin = begin + chunk_idx * chunk_size;
-          size_t chunk_end = std::min(chunk_begin + chunk_size, end);
-          for (size_t idx = chunk_begin; idx < chunk_end; ++idx) {
-            func(idx, local);
+ private:
+  // One loop, shared by the calling thread and its helper tasks. Chunks are claimed from an
+  // atomic counter and the caller only waits for the claimed chunks to be finished, so helpers
+  // that start late find nothing to claim and never touch the caller's data. The state is
+  // reference counted by hand so that a task captures a single pointer, which std::function
+  // stores without allocating.
+  template <typename Body>
+  struct Loop {
+    Body body;  // body(claim, finish): claim() -> std::optional<size_t> chunk; finish() reports
+                // every chunk claimed since the last call as done
+    const size_t num_chunks;
+    const std::optional<CancellationToken> token;
+    std::atomic<size_t> next_chunk{0};
+    std::latch chunks_left;
+    std::atomic<size_t> references;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    Loop(Body loop_body, size_t n_chunks, size_t n_participants)
+        : body(std::move(loop_body)),
+          num_chunks(n_chunks),
+          token(current_cancellation_token()),
+          chunks_left(static_cast<std::ptrdiff_t>(n_chunks)),
+          references(n_participants) {}
+
+    void participate() {
+      std::optional<CancellationScope> scope;
+      if (token.has_value()) {
+        scope.emplace(*token);
+      }
+      size_t n_unfinished = 0;
+      auto claim = [&]() -> std::optional<size_t> {
+        if (token.has_value()) {
+          token->throw_if_cancelled();
+        }
+        const size_t chunk_idx = next_chunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk_idx >= num_chunks) {
+          return std::nullopt;
+        }
+        n_unfinished++;
+        return chunk_idx;
+      };
+      auto finish = [&] {
+        chunks_left.count_down(static_cast<std::ptrdiff_t>(n_unfinished));
+        n_unfinished = 0;
+      };
+      try {
+        body(claim, finish);
+      } catch (...) {
+        {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error) {
+            error = std::current_exception();
           }
         }
-
-        // Merge thread-local result into shared result under mutex before signalling done
-        if (has_work) {
-          std::lock_guard<std::mutex> lock(*combine_mutex);
-          result.combine(local);
+        // Give up the chunks nobody has claimed yet
+        const size_t n_claimed = next_chunk.exchange(num_chunks);
+        if (n_claimed < num_chunks) {
+          n_unfinished += num_chunks - n_claimed;
         }
+        finish();
+      }
+    }
 
-        completion_latch->count_down(1);
-      });
+    void release() {
+      if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+      }
     }
+  };
 
-    // Block until all threads have finished work and combined their local results
-    completion_latch->wait();
+  template <typename Body>
+  void run_loop(size_t begin, size_t end, size_t chunk_size, Body body) {
+    const size_t total_work = end - begin;
+    const size_t num_chunks = (total_work + chunk_size - 1) / chunk_size;  // Ceiling division
+    const size_t active_threads = std::min(get_num_threads(), m_max_threads);
+    const size_t n_helpers = std::min(active_threads, num_chunks) - 1;
+
+    if (n_helpers == 0) {
+      // Nothing to share: run inline without touching the pool
+      Loop<Body> loop(std::move(body), num_chunks, 1);
+      loop.participate();
+      if (loop.error) {
+        std::rethrow_exception(loop.error);
+      }
+      return;
+    }
+
+    ensure_threads(n_helpers);
+    auto* loop = new Loop<Body>(std::move(body), num_chunks, n_helpers + 1);
+    enqueue(n_helpers, [loop] {
+      loop->participate();
+      loop->release();
+    });
+    loop->participate();
+
+    // Block until all chunks are complete
+    loop->chunks_left.wait();
+    const std::exception_ptr error = loop->error;
+    loop->release();
+    if (error) {
+      std::rethrow_exception(error);
+    }
   }
 
- private:
-  void enqueue(std::function<void()> task) {
+  // Queues `n_copies` copies of `task`, waking only parked workers that spinning ones won't cover
+  void enqueue(size_t n_copies, const std::function<void()>& task) {
+    size_t n_wake = 0;
     {
       std::unique_lock<std::mutex> lock(m_queue_mutex);
-      m_tasks.emplace(std::move(task));
+      for (size_t i = 0; i < n_copies; ++i) {
+        m_tasks.push(task);
+      }
+      m_n_queued.fetch_add(n_copies, std::memory_order_relaxed);
+      n_wake = std::min(n_copies, m_n_parked);
+    }
+    for (size_t i = 0; i < n_wake; ++i) {
+      m_condition.notify_one();
     }
-    m_condition.notify_one();
   }
 
   size_t m_max_threads;
   std::vector<std::thread> m_workers;
   std::queue<std::function<void()>> m_tasks;
+  std::atomic<size_t> m_n_queued{0};  // m_tasks.size(), readable without the lock
+  size_t m_n_parked = 0;              // workers waiting on m_condition
   std::mutex m_queue_mutex;
   std::condition_variable m_condition;
   std::atomic<bool> m_stop;